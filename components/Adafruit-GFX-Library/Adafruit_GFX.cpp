@@ -86,10 +86,24 @@ inline uint8_t *pgm_read_bitmap_ptr(const GFXfont *gfxFont) {
 #endif //__AVR__
 }
 
+// Copy a PROGMEM glyph record to RAM in one go
+static void readGlyph(const GFXglyph *src, GFXglyph *dst) {
+  dst->bitmapOffset = pgm_read_word(&src->bitmapOffset);
+  dst->width = pgm_read_byte(&src->width);
+  dst->height = pgm_read_byte(&src->height);
+  dst->xAdvance = pgm_read_byte(&src->xAdvance);
+  dst->xOffset = pgm_read_byte(&src->xOffset);
+  dst->yOffset = pgm_read_byte(&src->yOffset);
+}
+
 #ifndef min
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
 #ifndef _swap_int16_t
 #define _swap_int16_t(a, b)                                                    \
   {                                                                            \
@@ -117,6 +131,7 @@ Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {
   wrap = true;
   _cp437 = false;
   gfxFont = NULL;
+  textCache = NULL;
 }
 
 /**************************************************************************/
@@ -426,6 +441,12 @@ void Adafruit_GFX::fillEllipse(int16_t x0, int16_t y0, int16_t rw, int16_t rh,
 
   int32_t decision = rh2 - (rw2 * rh) + (rw2 / 4);
 
+  // The loop can overrun rw on very flat ellipses, so only the rows are
+  // known up front and every span gets clipped
+  GFXspanBatch batch;
+  if (!beginSpans(&batch, 0, y0 - rh, _width - 1, y0 + rh, color))
+    return;
+  batch.clip = true;
   startWrite();
 
   // region 1
@@ -435,8 +456,9 @@ void Adafruit_GFX::fillEllipse(int16_t x0, int16_t y0, int16_t rw, int16_t rh,
       decision += rh2 + (twoRh2 * x);
     } else {
       decision += rh2 + (twoRh2 * x) - (twoRw2 * y);
-      drawFastHLine(x0 - (x - 1), y0 + y, 2 * (x - 1) + 1, color);
-      drawFastHLine(x0 - (x - 1), y0 - y, 2 * (x - 1) + 1, color);
+      addSpan(&batch, y0 + y, x0 - (x - 1), x0 + (x - 1));
+      if (y)
+        addSpan(&batch, y0 - y, x0 - (x - 1), x0 + (x - 1));
       y--;
     }
   }
@@ -445,8 +467,9 @@ void Adafruit_GFX::fillEllipse(int16_t x0, int16_t y0, int16_t rw, int16_t rh,
   decision = ((rh2 * (2 * x + 1) * (2 * x + 1)) >> 2) +
              (rw2 * (y - 1) * (y - 1)) - (rw2 * rh2);
   while (y >= 0) {
-    drawFastHLine(x0 - x, y0 + y, 2 * x + 1, color);
-    drawFastHLine(x0 - x, y0 - y, 2 * x + 1, color);
+    addSpan(&batch, y0 + y, x0 - x, x0 + x);
+    if (y) // Center row only once, INVERSE-safe
+      addSpan(&batch, y0 - y, x0 - x, x0 + x);
 
     y--;
     if (decision > 0) {
@@ -457,6 +480,7 @@ void Adafruit_GFX::fillEllipse(int16_t x0, int16_t y0, int16_t rw, int16_t rh,
     }
   }
 
+  endSpans(&batch);
   endWrite();
 }
 
@@ -566,9 +590,12 @@ void Adafruit_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r,
 /**************************************************************************/
 void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
                               uint16_t color) {
+  GFXspanBatch batch;
+  if (!beginSpans(&batch, x0 - r, y0 - r, x0 + r, y0 + r, color, true))
+    return;
   startWrite();
-  writeFastVLine(x0, y0 - r, 2 * r + 1, color);
-  fillCircleHelper(x0, y0, r, 3, 0, color);
+  roundSpans(&batch, x0, y0, x0, y0, r, 0);
+  endSpans(&batch);
   endWrite();
 }
 
@@ -586,7 +613,40 @@ void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
 void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
                                     uint8_t corners, int16_t delta,
                                     uint16_t color) {
+  int16_t y1 = (delta < 0) ? y0 + delta : y0;
+  int16_t y2 = (delta < 0) ? y0 : y0 + delta;
+  GFXspanBatch batch;
+  if (!(corners & 3) ||
+      !beginSpans(&batch, x0 - r, y1 - r, x0 + r, y2 + r, color))
+    return;
+  roundSpans(&batch, x0, y0, x0, y0 + delta, r, corners);
+  endSpans(&batch);
+}
 
+/**************************************************************************/
+/*!
+    @brief  Emit the scanlines of a filled circle, optionally stretched
+            into a rounded rectangle. The four corner quadrants are
+            centered on (xl,yt), (xr,yt), (xl,yb) and (xr,yb); rows
+            between yt and yb are full width. This is the midpoint loop
+            of the original fillCircleHelper() transposed so each step
+            yields a row rather than a column, and no row is produced
+            twice. The whole shape is symmetric about the diagonal, so
+            a vertical batch gets the same rows transposed into columns.
+    @param  batch    Span batch started with beginSpans()
+    @param  xl       Left quadrant center x
+    @param  yt       Top quadrant center y
+    @param  xr       Right quadrant center x
+    @param  yb       Bottom quadrant center y
+    @param  r        Corner radius
+    @param  corners  0 for the whole shape, else bit 0 for the part right
+                     of xr and bit 1 for the part left of xl (horizontal
+                     batches only)
+*/
+/**************************************************************************/
+void Adafruit_GFX::roundSpans(GFXspanBatch *batch, int16_t xl, int16_t yt,
+                              int16_t xr, int16_t yb, int16_t r,
+                              uint8_t corners) {
   int16_t f = 1 - r;
   int16_t ddF_x = 1;
   int16_t ddF_y = -2 * r;
@@ -595,7 +655,24 @@ void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
   int16_t px = x;
   int16_t py = y;
 
-  delta++; // Avoid some +1's in the loop
+  if (batch->vertical) {
+    _swap_int16_t(xl, yt);
+    _swap_int16_t(xr, yb);
+  }
+
+#define ROUND_ROW(row, hw)                                                     \
+  if (!corners) {                                                              \
+    addSpan(batch, row, xl - (hw), xr + (hw));                                 \
+  } else {                                                                     \
+    if (corners & 2)                                                           \
+      addSpan(batch, row, xl - (hw), xl - 1);                                  \
+    if (corners & 1)                                                           \
+      addSpan(batch, row, xr + 1, xr + (hw));                                  \
+  }
+
+  for (int16_t row = yt; row <= yb; row++) {
+    ROUND_ROW(row, r);
+  }
 
   while (x < y) {
     if (f >= 0) {
@@ -609,20 +686,17 @@ void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
     // These checks avoid double-drawing certain lines, important
     // for the SSD1306 library which has an INVERT drawing mode.
     if (x < (y + 1)) {
-      if (corners & 1)
-        writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
-      if (corners & 2)
-        writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      ROUND_ROW(yt - x, y);
+      ROUND_ROW(yb + x, y);
     }
     if (y != py) {
-      if (corners & 1)
-        writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
-      if (corners & 2)
-        writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      ROUND_ROW(yt - py, px);
+      ROUND_ROW(yb + py, px);
       py = y;
     }
     px = x;
   }
+#undef ROUND_ROW
 }
 
 /**************************************************************************/
@@ -691,12 +765,14 @@ void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
   int16_t max_radius = ((w < h) ? w : h) / 2; // 1/2 minor axis
   if (r > max_radius)
     r = max_radius;
-  // smarter version
+  if (r < 0) // Also keeps every span inside the rectangle
+    r = 0;
+  GFXspanBatch batch;
+  if (!beginSpans(&batch, x, y, x + w - 1, y + h - 1, color, true))
+    return;
   startWrite();
-  writeFillRect(x + r, y, w - 2 * r, h, color);
-  // draw four corners
-  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
-  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+  roundSpans(&batch, x + r, y + r, x + w - r - 1, y + h - r - 1, r, 0);
+  endSpans(&batch);
   endWrite();
 }
 
@@ -750,18 +826,23 @@ void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
     _swap_int16_t(x0, x1);
   }
 
+  a = b = x0;
+  if (x1 < a)
+    a = x1;
+  else if (x1 > b)
+    b = x1;
+  if (x2 < a)
+    a = x2;
+  else if (x2 > b)
+    b = x2;
+
+  GFXspanBatch batch;
+  if (!beginSpans(&batch, a, y0, b, y2, color))
+    return;
   startWrite();
   if (y0 == y2) { // Handle awkward all-on-same-line case as its own thing
-    a = b = x0;
-    if (x1 < a)
-      a = x1;
-    else if (x1 > b)
-      b = x1;
-    if (x2 < a)
-      a = x2;
-    else if (x2 > b)
-      b = x2;
-    writeFastHLine(a, y0, b - a + 1, color);
+    addSpan(&batch, y0, a, b);
+    endSpans(&batch);
     endWrite();
     return;
   }
@@ -792,7 +873,7 @@ void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
     */
     if (a > b)
       _swap_int16_t(a, b);
-    writeFastHLine(a, y, b - a + 1, color);
+    addSpan(&batch, y, a, b);
   }
 
   // For lower part of triangle, find scanline crossings for segments
@@ -810,11 +891,418 @@ void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
     */
     if (a > b)
       _swap_int16_t(a, b);
-    writeFastHLine(a, y, b - a + 1, color);
+    addSpan(&batch, y, a, b);
+  }
+  endSpans(&batch);
+  endWrite();
+}
+
+// SPAN FILL FUNCTIONS -----------------------------------------------------
+
+/**************************************************************************/
+/*!
+   @brief   Draw a batch of clipped spans. Filled primitives collect their
+            scanlines with addSpan() and hand them over in batches, so a
+            target that can fill rows directly overrides this instead of
+            paying the clip and rotate of writeFastHLine() on every line.
+            The default calls writeFastHLine() (or writeFastVLine() for a
+            vertical batch) per span. Called between startWrite() and
+            endWrite().
+    @param  batch  Spans in rotated coordinates, on screen, x1 <= x2
+*/
+/**************************************************************************/
+void Adafruit_GFX::writeSpans(const GFXspanBatch *batch) {
+  for (uint8_t i = 0; i < batch->count; i++) {
+    const GFXspan *span = &batch->span[i];
+    if (batch->vertical)
+      writeFastVLine(span->y, span->x1, span->x2 - span->x1 + 1,
+                     batch->color);
+    else
+      writeFastHLine(span->x1, span->y, span->x2 - span->x1 + 1,
+                     batch->color);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Whether this display fills columns faster than rows at the
+            current rotation. Shapes that are symmetric about the diagonal
+            (circles, rounded rects) are then emitted as vertical spans.
+    @returns  false by default
+*/
+/**************************************************************************/
+bool Adafruit_GFX::verticalSpans(void) const { return false; }
+
+/**************************************************************************/
+/*!
+   @brief   Start collecting spans for one filled primitive, deciding
+            once from its bounding box whether any clipping is needed
+    @param  batch  Batch to initialize
+    @param  x1     Bounding box left
+    @param  y1     Bounding box top
+    @param  x2     Bounding box right, inclusive
+    @param  y2     Bounding box bottom, inclusive
+    @param  color  16-bit 5-6-5 Color to fill with
+    @param  transpose  True if the primitive can be emitted as columns
+                       instead, should the display prefer them
+    @returns  false if the primitive is entirely off screen
+*/
+/**************************************************************************/
+bool Adafruit_GFX::beginSpans(GFXspanBatch *batch, int16_t x1, int16_t y1,
+                              int16_t x2, int16_t y2, uint16_t color,
+                              bool transpose) {
+  if ((x2 < 0) || (y2 < 0) || (x1 >= _width) || (y1 >= _height))
+    return false;
+  batch->count = 0;
+  batch->clip = (x1 < 0) || (y1 < 0) || (x2 >= _width) || (y2 >= _height);
+  batch->vertical = transpose && verticalSpans();
+  batch->color = color;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Add one scanline to a span batch, clipping it if the batch
+            needs it and passing the batch to writeSpans() when full
+    @param  batch  Batch started with beginSpans()
+    @param  y      Scanline (column, in a vertical batch)
+    @param  x1     First pixel
+    @param  x2     Last pixel, inclusive; spans with x2 < x1 are dropped
+*/
+/**************************************************************************/
+void Adafruit_GFX::addSpan(GFXspanBatch *batch, int16_t y, int16_t x1,
+                           int16_t x2) {
+  if (batch->clip) {
+    int16_t lines = batch->vertical ? _width : _height;
+    int16_t len = batch->vertical ? _height : _width;
+    if ((y < 0) || (y >= lines))
+      return;
+    if (x1 < 0)
+      x1 = 0;
+    if (x2 >= len)
+      x2 = len - 1;
+  }
+  if (x2 < x1)
+    return;
+  GFXspan *span = &batch->span[batch->count];
+  span->y = y;
+  span->x1 = x1;
+  span->x2 = x2;
+  if (++batch->count == GFX_SPAN_BATCH) {
+    writeSpans(batch);
+    batch->count = 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Hand any spans left in a batch to writeSpans()
+    @param  batch  Batch started with beginSpans()
+*/
+/**************************************************************************/
+void Adafruit_GFX::endSpans(GFXspanBatch *batch) {
+  if (batch->count) {
+    writeSpans(batch);
+    batch->count = 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Map one span of a batch from rotated coordinates to a run in
+            the unrotated (raw) buffer, for writeSpans() overrides that
+            fill their buffer directly. A vertical span is the same run with
+            the roles of x and y swapped, so it maps to the other kind of
+            raw line.
+    @param  batch  Batch passed to writeSpans()
+    @param  i      Index of the span in the batch
+    @param  x      Raw x of the top or left end of the run
+    @param  y      Raw y of the top or left end of the run
+    @param  len    Run length in pixels
+    @returns  true if the run is a raw column, false if it is a raw row
+*/
+/**************************************************************************/
+bool Adafruit_GFX::rawSpan(const GFXspanBatch *batch, uint8_t i, int16_t *x,
+                           int16_t *y, int16_t *len) const {
+  const GFXspan *span = &batch->span[i];
+  *len = span->x2 - span->x1 + 1;
+  switch (rotation + (batch->vertical ? 4 : 0)) {
+  case 0:
+    *x = span->x1;
+    *y = span->y;
+    return false;
+  case 1:
+    *x = WIDTH - 1 - span->y;
+    *y = span->x1;
+    return true;
+  case 2:
+    *x = WIDTH - 1 - span->x2;
+    *y = HEIGHT - 1 - span->y;
+    return false;
+  case 3:
+    *x = span->y;
+    *y = HEIGHT - 1 - span->x2;
+    return true;
+  case 4:
+    *x = span->y;
+    *y = span->x1;
+    return true;
+  case 5:
+    *x = WIDTH - 1 - span->x2;
+    *y = span->y;
+    return false;
+  case 6:
+    *x = WIDTH - 1 - span->y;
+    *y = HEIGHT - 1 - span->x2;
+    return true;
+  default:
+    *x = span->x1;
+    *y = HEIGHT - 1 - span->y;
+    return false;
+  }
+}
+
+// ANTI-ALIASED FUNCTIONS --------------------------------------------------
+
+// sin() of whole degrees 0-90, scaled by 16384, for drawArcAA()
+static const uint16_t PROGMEM gfxSinTable[91] = {
+    0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563, 2845, 3126, 3406,
+    3686, 3964, 4240, 4516, 4790, 5063, 5334, 5604, 5872, 6138, 6402, 6664,
+    6924, 7182, 7438, 7692, 7943, 8192, 8438, 8682, 8923, 9162, 9397, 9630,
+    9860, 10087, 10311, 10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982,
+    12176, 12365, 12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894,
+    14044, 14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083, 16135,
+    16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382, 16384};
+
+// sin() of any whole degree, scaled by 16384
+static int16_t gfxSin(int16_t deg) {
+  deg %= 360;
+  if (deg < 0)
+    deg += 360;
+  if (deg <= 90)
+    return pgm_read_word(&gfxSinTable[deg]);
+  if (deg <= 180)
+    return pgm_read_word(&gfxSinTable[180 - deg]);
+  if (deg <= 270)
+    return -(int16_t)pgm_read_word(&gfxSinTable[deg - 180]);
+  return -(int16_t)pgm_read_word(&gfxSinTable[360 - deg]);
+}
+
+// True if offset (dx,dy) lies within the clockwise sweep from direction
+// (sx,sy) to (ex,ey). Mode 1 is a sweep of up to 180 degrees, mode 2 a
+// larger one (inside unless it falls in the smaller complement).
+static bool arcInside(uint8_t mode, int16_t sx, int16_t sy, int16_t ex,
+                      int16_t ey, int16_t dx, int16_t dy) {
+  int32_t a = (int32_t)sx * dy - (int32_t)sy * dx; // start x point
+  int32_t b = (int32_t)dx * ey - (int32_t)dy * ex; // point x end
+  if (mode == 1)
+    return (a >= 0) && (b >= 0);
+  return (a >= 0) || (b >= 0);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Blend a color into one pixel with the given coverage, used by
+            the anti-aliased primitives. Displays that can't read their
+            pixels back just draw the pixel if it is at least half
+            covered; canvases and grayscale OLEDs mix it with what is
+            already there. Called between startWrite() and endWrite().
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  Color to blend in
+    @param  alpha  Coverage, 0 (none) to 255 (full)
+*/
+/**************************************************************************/
+void Adafruit_GFX::blendPixel(int16_t x, int16_t y, uint16_t color,
+                              uint8_t alpha) {
+  if (alpha >= 128)
+    writePixel(x, y, color);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an anti-aliased line. This is Wu's algorithm with a 16-bit
+            error accumulator: each step along the major axis covers two
+            pixels whose weights add up to one, so there is no floating
+            point and no division inside the loop.
+    @param  x0  Start point x coordinate
+    @param  y0  Start point y coordinate
+    @param  x1  End point x coordinate
+    @param  y1  End point y coordinate
+    @param  color  Color to draw with
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                              uint16_t color) {
+  if (y0 > y1) {
+    _swap_int16_t(x0, x1);
+    _swap_int16_t(y0, y1);
+  }
+  int16_t dx = x1 - x0, dy = y1 - y0, xdir = 1;
+  if (dx < 0) {
+    xdir = -1;
+    dx = -dx;
+  }
+
+  startWrite();
+  if ((dx == 0) || (dy == 0) || (dx == dy)) {
+    // Nothing to smooth on straight and diagonal lines
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+    return;
+  }
+
+  blendPixel(x0, y0, color, 255);
+  uint16_t errAcc = 0, errPrev, errAdj;
+  uint8_t w;
+  if (dy > dx) { // Y-major: step y, x advances when the accumulator wraps
+    errAdj = ((uint32_t)dx << 16) / dy;
+    while (--dy) {
+      errPrev = errAcc;
+      errAcc += errAdj;
+      if (errAcc <= errPrev)
+        x0 += xdir;
+      y0++;
+      w = errAcc >> 8;
+      if (w != 0xFF)
+        blendPixel(x0, y0, color, w ^ 0xFF);
+      if (w)
+        blendPixel(x0 + xdir, y0, color, w);
+    }
+  } else { // X-major
+    errAdj = ((uint32_t)dy << 16) / dx;
+    while (--dx) {
+      errPrev = errAcc;
+      errAcc += errAdj;
+      if (errAcc <= errPrev)
+        y0++;
+      x0 += xdir;
+      w = errAcc >> 8;
+      if (w != 0xFF)
+        blendPixel(x0, y0, color, w ^ 0xFF);
+      if (w)
+        blendPixel(x0, y0 + 1, color, w);
+    }
+  }
+  blendPixel(x1, y1, color, 255);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an anti-aliased circle outline
+    @param  x0  Center-point x coordinate
+    @param  y0  Center-point y coordinate
+    @param  r   Radius of circle
+    @param  color  Color to draw with
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawCircleAA(int16_t x0, int16_t y0, int16_t r,
+                                uint16_t color) {
+  if (r < 0)
+    return;
+  startWrite();
+  circleAA(x0, y0, r, color, 0, 0, 0, 0, 0);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an anti-aliased circular arc, clockwise from start to end.
+            Angles are whole degrees with 0 at 12 o'clock, as on a dial.
+            If end - start is 360 or more the whole circle is drawn;
+            otherwise end may be below start, e.g. -45 to 45 or 315 to 45.
+    @param  x0     Center-point x coordinate
+    @param  y0     Center-point y coordinate
+    @param  r      Radius of arc
+    @param  start  Start angle, degrees clockwise from 12 o'clock
+    @param  end    End angle, degrees clockwise from 12 o'clock
+    @param  color  Color to draw with
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawArcAA(int16_t x0, int16_t y0, int16_t r, int16_t start,
+                             int16_t end, uint16_t color) {
+  int16_t sweep = end - start;
+  uint8_t mode = 0;
+  if (r < 0)
+    return;
+  if (sweep < 360) {
+    // Clockwise from start round to end, however far apart they are
+    sweep %= 360;
+    if (sweep < 0)
+      sweep += 360;
+    if (sweep == 0)
+      return;
+    mode = (sweep <= 180) ? 1 : 2;
   }
+  startWrite();
+  // Unit vectors (x 16384) toward each end; y grows downward on screen
+  circleAA(x0, y0, r, color, mode, gfxSin(start), -gfxSin(start + 90),
+           gfxSin(end), -gfxSin(end + 90));
   endWrite();
 }
 
+/**************************************************************************/
+/*!
+   @brief   Shared body of drawCircleAA() and drawArcAA(). Walks one octant
+            from the top of the circle, keeping y at the floor of the true
+            radius and splitting each pixel pair by the fractional part,
+            taken from a linear fit between neighbouring squares. Each
+            point is mirrored eight ways without repeating any pixel.
+    @param  x0     Center-point x coordinate
+    @param  y0     Center-point y coordinate
+    @param  r      Radius
+    @param  color  Color to draw with
+    @param  mode   0 for the full circle, else arcInside() mode
+    @param  sx     Start direction x, if mode is set
+    @param  sy     Start direction y, if mode is set
+    @param  ex     End direction x, if mode is set
+    @param  ey     End direction y, if mode is set
+*/
+/**************************************************************************/
+void Adafruit_GFX::circleAA(int16_t x0, int16_t y0, int16_t r, uint16_t color,
+                            uint8_t mode, int16_t sx, int16_t sy, int16_t ex,
+                            int16_t ey) {
+  int32_t r2 = (int32_t)r * r;
+  int16_t x = 0, y = r;
+
+#define AA_PLOT(dx, dy, alpha)                                                 \
+  if (!mode || arcInside(mode, sx, sy, ex, ey, dx, dy))                        \
+    blendPixel(x0 + (dx), y0 + (dy), color, alpha);
+#define AA_PLOT4(a, b, alpha)                                                  \
+  {                                                                            \
+    AA_PLOT(a, b, alpha);                                                      \
+    if (a)                                                                     \
+      AA_PLOT(-(a), b, alpha);                                                 \
+    if (b)                                                                     \
+      AA_PLOT(a, -(b), alpha);                                                 \
+    if ((a) && (b))                                                            \
+      AA_PLOT(-(a), -(b), alpha);                                              \
+  }
+#define AA_PLOT8(a, b, alpha)                                                  \
+  if (alpha) {                                                                 \
+    AA_PLOT4(a, b, alpha);                                                     \
+    if ((a) != (b))                                                            \
+      AA_PLOT4(b, a, alpha);                                                   \
+  }
+
+  while (x <= y) {
+    int32_t d = r2 - (int32_t)x * x; // True y, squared
+    while ((int32_t)y * y > d)
+      y--;
+    if (y < x)
+      break;
+    uint8_t frac = ((d - (int32_t)y * y) * 255) / (2 * y + 1);
+    AA_PLOT8(x, y, (uint8_t)(255 - frac));
+    AA_PLOT8(x, y + 1, frac);
+    x++;
+  }
+#undef AA_PLOT8
+#undef AA_PLOT4
+#undef AA_PLOT
+}
+
 // BITMAP / XBITMAP / GRAYSCALE / RGB BITMAP FUNCTIONS ---------------------
 
 /**************************************************************************/
@@ -832,6 +1320,9 @@ void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
 void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
                               int16_t w, int16_t h, uint16_t color) {
 
+  if (drawBitmap1(x, y, bitmap, w, h, color, 0, false, true))
+    return;
+
   int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
   uint8_t b = 0;
 
@@ -867,6 +1358,9 @@ void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
                               int16_t w, int16_t h, uint16_t color,
                               uint16_t bg) {
 
+  if (drawBitmap1(x, y, bitmap, w, h, color, bg, true, true))
+    return;
+
   int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
   uint8_t b = 0;
 
@@ -898,6 +1392,9 @@ void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
 void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
                               int16_t h, uint16_t color) {
 
+  if (drawBitmap1(x, y, bitmap, w, h, color, 0, false, false))
+    return;
+
   int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
   uint8_t b = 0;
 
@@ -932,6 +1429,9 @@ void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
 void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
                               int16_t h, uint16_t color, uint16_t bg) {
 
+  if (drawBitmap1(x, y, bitmap, w, h, color, bg, true, false))
+    return;
+
   int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
   uint8_t b = 0;
 
@@ -985,6 +1485,241 @@ void Adafruit_GFX::drawXBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
   endWrite();
 }
 
+/**************************************************************************/
+/*!
+   @brief   Hook for subclasses with a 1-bit framebuffer to draw a drawBitmap()
+   image directly into their buffer, typically via blitBitmap1(). The default
+   declines, and drawBitmap() falls back to per-pixel writePixel() calls.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with monochrome bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Color to draw set bits with
+    @param    bg Color to draw unset bits with (if opaque)
+    @param    opaque If false, unset bits are transparent
+    @param    progmem True if bitmap is PROGMEM-resident
+    @returns  True if the image was drawn, false to use the generic path
+*/
+/**************************************************************************/
+bool Adafruit_GFX::drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap,
+                               int16_t w, int16_t h, uint16_t color,
+                               uint16_t bg, bool opaque, bool progmem) {
+  return false;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Whether drawBitmap1() currently takes images, so callers can
+   skip preparing one for a target that would decline it.
+    @returns  True if drawBitmap1() will draw, false for the generic path
+*/
+/**************************************************************************/
+bool Adafruit_GFX::canBlit1(void) const { return false; }
+
+static inline uint8_t blitRead(const uint8_t *p, bool progmem) {
+  return progmem ? pgm_read_byte(p) : *p;
+}
+
+// Fetch 8 bitmap bits starting at column i of a scanline, MSB first.
+// Bits past the end of the scanline read as 0.
+static inline uint8_t blitFetch(const uint8_t *row, int16_t i,
+                                int16_t byteWidth, bool progmem) {
+  int16_t n = i >> 3;
+  uint8_t s = i & 7;
+  uint16_t v = blitRead(&row[n], progmem) << 8;
+  if (s && (n + 1 < byteWidth))
+    v |= blitRead(&row[n + 1], progmem);
+  return (uint8_t)((v << s) >> 8);
+}
+
+static inline uint8_t blitReverse(uint8_t b) {
+  b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+  b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+  return (b & 0xAA) >> 1 | (b & 0x55) << 1;
+}
+
+// 8x8 bit matrix transpose in two 32-bit words (Hacker's Delight 7-3).
+// On return, bit (7 - m) of out[k] is bit (7 - k) of in[m].
+static void blitTranspose(const uint8_t in[8], uint8_t out[8]) {
+  uint32_t x = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+               ((uint32_t)in[2] << 8) | in[3];
+  uint32_t y = ((uint32_t)in[4] << 24) | ((uint32_t)in[5] << 16) |
+               ((uint32_t)in[6] << 8) | in[7];
+  uint32_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+
+  out[0] = x >> 24;
+  out[1] = x >> 16;
+  out[2] = x >> 8;
+  out[3] = x;
+  out[4] = y >> 24;
+  out[5] = y >> 16;
+  out[6] = y >> 8;
+  out[7] = y;
+}
+
+static inline void blitApply(uint8_t *p, uint8_t bits, uint8_t op) {
+  switch (op) {
+  case GFX_BLIT_CLEAR:
+    *p &= ~bits;
+    break;
+  case GFX_BLIT_SET:
+    *p |= bits;
+    break;
+  case GFX_BLIT_INVERT:
+    *p ^= bits;
+    break;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a drawBitmap()-format 1-bit image straight into a 1-bit
+   framebuffer of WIDTH x HEIGHT pixels, honoring the current rotation.
+   Clipping is resolved once up front; the inner loops then build whole
+   destination bytes with shifts and masks. Where the bitmap's scanlines run
+   across the buffer's packing direction, 8x8 blocks are transposed with
+   32-bit word operations.
+    @param    buf  Framebuffer. If pageMajor is false, scanlines of
+                   (WIDTH + 7) / 8 bytes, leftmost pixel in the MSB (the
+                   GFXcanvas1 layout). If true, 8-pixel-tall pages of WIDTH
+                   bytes, topmost pixel in the LSB (the SSD1306 layout).
+    @param    pageMajor  Selects the framebuffer layout, see above
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with monochrome bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    fgOp  GFX_BLIT_* operation applied for set bits
+    @param    bgOp  GFX_BLIT_* operation applied for unset bits
+    @param    progmem True if bitmap is PROGMEM-resident
+    @param    bounds  If not NULL, receives the touched area in unrotated
+                      buffer coordinates as {x1, y1, x2, y2}, inclusive
+    @returns  True if any part of the image was on-screen
+*/
+/**************************************************************************/
+bool Adafruit_GFX::blitBitmap1(uint8_t *buf, bool pageMajor, int16_t x,
+                               int16_t y, const uint8_t *bitmap, int16_t w,
+                               int16_t h, uint8_t fgOp, uint8_t bgOp,
+                               bool progmem, int16_t *bounds) {
+  // Visible part of the bitmap, in bitmap columns (i) and rows (j)
+  int16_t i0 = max(0, -x), i1 = min(w, _width - x) - 1;
+  int16_t j0 = max(0, -y), j1 = min(h, _height - y) - 1;
+  if ((i0 > i1) || (j0 > j1))
+    return false;
+
+  // Each native axis maps onto i or j as (c + s * native coordinate)
+  bool xIsI;
+  int16_t cx, cy, sx, sy;
+  switch (rotation) {
+  case 0:
+    xIsI = true; // i = x' - x, j = y' - y
+    cx = -x, sx = 1, cy = -y, sy = 1;
+    break;
+  case 1:
+    xIsI = false; // j = WIDTH - 1 - y - x', i = y' - x
+    cx = WIDTH - 1 - y, sx = -1, cy = -x, sy = 1;
+    break;
+  case 2:
+    xIsI = true; // i = WIDTH - 1 - x - x', j = HEIGHT - 1 - y - y'
+    cx = WIDTH - 1 - x, sx = -1, cy = HEIGHT - 1 - y, sy = -1;
+    break;
+  default:
+    xIsI = false; // j = x' - y, i = HEIGHT - 1 - x - y'
+    cx = -y, sx = 1, cy = HEIGHT - 1 - x, sy = -1;
+    break;
+  }
+
+  int16_t x1 = xIsI ? i0 : j0, x2 = xIsI ? i1 : j1;
+  int16_t y1 = xIsI ? j0 : i0, y2 = xIsI ? j1 : i1;
+  x1 = sx * (x1 - cx), x2 = sx * (x2 - cx);
+  y1 = sy * (y1 - cy), y2 = sy * (y2 - cy);
+  if (x1 > x2)
+    _swap_int16_t(x1, x2);
+  if (y1 > y2)
+    _swap_int16_t(y1, y2);
+  if (bounds) {
+    bounds[0] = x1;
+    bounds[1] = y1;
+    bounds[2] = x2;
+    bounds[3] = y2;
+  }
+  if ((fgOp == GFX_BLIT_NONE) && (bgOp == GFX_BLIT_NONE))
+    return true;
+
+  // Axis 'a' runs along a destination byte's bits, 'b' across bytes
+  bool aIsI = pageMajor ? !xIsI : xIsI;
+  int16_t ca = pageMajor ? cy : cx, sa = pageMajor ? sy : sx;
+  int16_t cb = pageMajor ? cx : cy, sb = pageMajor ? sx : sy;
+  int16_t a0 = pageMajor ? y1 : x1, a1 = pageMajor ? y2 : x2;
+  int16_t b0 = pageMajor ? x1 : y1, b1 = pageMajor ? x2 : y2;
+  int32_t gStride = pageMajor ? WIDTH : 1;
+  int32_t bStride = pageMajor ? 1 : (WIDTH + 7) / 8;
+  int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+  bool msbFirst = !pageMajor;
+
+  for (int16_t g = a0 >> 3; g <= (a1 >> 3); g++) {
+    int16_t ua0 = max(a0, g * 8), ua1 = min(a1, g * 8 + 7);
+    uint8_t o0 = ua0 & 7, o1 = 7 - (ua1 & 7), mask;
+    if (msbFirst)
+      mask = (uint8_t)(0xFF >> o0) & (uint8_t)(0xFF << o1);
+    else
+      mask = (uint8_t)(0xFF << o0) & (uint8_t)(0xFF >> o1);
+    uint8_t *col = buf + g * gStride;
+
+    if (aIsI) {
+      // Destination bytes lie along bitmap scanlines: shift 8 bits at once
+      int16_t i = (sa > 0) ? ca + ua0 : ca - ua1;
+      for (int16_t b = b0; b <= b1; b++) {
+        int16_t j = cb + sb * b;
+        uint8_t v = blitFetch(bitmap + (int32_t)j * byteWidth, i, byteWidth,
+                              progmem);
+        uint8_t bits;
+        if (sa > 0)
+          bits = msbFirst ? v >> o0 : blitReverse(v) << o0;
+        else
+          bits = msbFirst ? blitReverse(v) << o1 : v >> o1;
+        uint8_t *p = col + b * bStride;
+        blitApply(p, bits & mask, fgOp);
+        blitApply(p, ~bits & mask, bgOp);
+      }
+    } else {
+      // Destination bytes lie across bitmap scanlines: gather 8 scanlines
+      // of 8 columns each, transpose, then emit up to 8 bytes
+      for (int16_t bt = b0; bt <= b1; bt += 8) {
+        int16_t bt1 = min(b1, bt + 7);
+        int16_t imin = (sb > 0) ? cb + bt : cb - bt1;
+        uint8_t rows[8] = {0}, cols[8];
+        for (int16_t a = ua0; a <= ua1; a++) {
+          int16_t j = ca + sa * a;
+          rows[msbFirst ? (a & 7) : 7 - (a & 7)] = blitFetch(
+              bitmap + (int32_t)j * byteWidth, imin, byteWidth, progmem);
+        }
+        blitTranspose(rows, cols);
+        for (int16_t b = bt; b <= bt1; b++) {
+          uint8_t bits = cols[(sb > 0) ? b - bt : bt1 - b];
+          uint8_t *p = col + b * bStride;
+          blitApply(p, bits & mask, fgOp);
+          blitApply(p, ~bits & mask, bgOp);
+        }
+      }
+    }
+  }
+  return true;
+}
+
 /**************************************************************************/
 /*!
    @brief   Draw a PROGMEM-resident 8-bit image (grayscale) at the specified
@@ -1294,22 +2029,8 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
     // drawChar() directly with 'bad' characters of font may cause mayhem!
 
     c -= (uint8_t)pgm_read_byte(&gfxFont->first);
-    GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, c);
-    uint8_t *bitmap = pgm_read_bitmap_ptr(gfxFont);
-
-    uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
-    uint8_t w = pgm_read_byte(&glyph->width), h = pgm_read_byte(&glyph->height);
-    int8_t xo = pgm_read_byte(&glyph->xOffset),
-           yo = pgm_read_byte(&glyph->yOffset);
-    uint8_t xx, yy, bits = 0, bit = 0;
-    int16_t xo16 = 0, yo16 = 0;
-
-    if (size_x > 1 || size_y > 1) {
-      xo16 = xo;
-      yo16 = yo;
-    }
-
-    // Todo: Add character clipping here
+    GFXglyph glyph;
+    readGlyph(pgm_read_glyph_ptr(gfxFont, c), &glyph);
 
     // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
     // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
@@ -1328,55 +2049,226 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
     // implemented this yet.
 
     startWrite();
-    for (yy = 0; yy < h; yy++) {
-      for (xx = 0; xx < w; xx++) {
-        if (!(bit++ & 7)) {
-          bits = pgm_read_byte(&bitmap[bo++]);
-        }
-        if (bits & 0x80) {
-          if (size_x == 1 && size_y == 1) {
-            writePixel(x + xo + xx, y + yo + yy, color);
-          } else {
-            writeFillRect(x + (xo16 + xx) * size_x, y + (yo16 + yy) * size_y,
-                          size_x, size_y, color);
-          }
-        }
-        bits <<= 1;
-      }
-    }
+    drawGlyph(x, y, &glyph, pgm_read_bitmap_ptr(gfxFont), color, size_x,
+              size_y);
     endWrite();
 
   } // End classic vs custom font
 }
+
 /**************************************************************************/
 /*!
-    @brief  Print one byte/character of data, used to support print()
-    @param  c  The 8-bit ascii character to write
+   @brief   Draw one custom-font glyph as horizontal spans, or as a few
+   banded blits on targets that implement drawBitmap1(). Glyphs entirely
+   off-screen are skipped. Caller must bracket this with startWrite()/endWrite().
+    @param    x   Cursor x coordinate (glyph origin)
+    @param    y   Cursor y coordinate (baseline)
+    @param    glyph  RAM copy of the glyph record
+    @param    bitmap PROGMEM glyph bitmaps of the current font
+    @param    color 16-bit 5-6-5 Color to draw the glyph with
+    @param    size_x  Font magnification level in X-axis, 1 is 'original' size
+    @param    size_y  Font magnification level in Y-axis, 1 is 'original' size
 */
 /**************************************************************************/
-size_t Adafruit_GFX::write(uint8_t c) {
-  if (!gfxFont) { // 'Classic' built-in font
+void Adafruit_GFX::drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph,
+                             const uint8_t *bitmap, uint16_t color,
+                             uint8_t size_x, uint8_t size_y) {
+  uint8_t w = glyph->width, h = glyph->height;
+  int16_t x1 = x + glyph->xOffset * (int16_t)size_x,
+          y1 = y + glyph->yOffset * (int16_t)size_y;
 
-    if (c == '\n') {              // Newline?
-      cursor_x = 0;               // Reset x to zero,
-      cursor_y += textsize_y * 8; // advance y one line
-    } else if (c != '\r') {       // Ignore carriage returns
-      if (wrap && ((cursor_x + textsize_x * 6) > _width)) { // Off right?
-        cursor_x = 0;                                       // Reset x to zero,
-        cursor_y += textsize_y * 8; // advance y one line
+  if (!w || !h || (x1 >= _width) || (y1 >= _height) ||
+      ((x1 + w * size_x) <= 0) || ((y1 + h * size_y) <= 0))
+    return;
+
+  const uint8_t *src = &bitmap[glyph->bitmapOffset];
+  bool rle = pgm_read_byte(&gfxFont->flags) & GFX_FONT_RLE;
+  uint8_t byteWidth = (w + 7) / 8;
+  uint8_t rows[GFX_GLYPH_BLIT_MAX];
+  uint8_t band = sizeof(rows) / byteWidth; // Rows that fit in rows[]
+  uint8_t top = 0;                         // Glyph row held in rows[0]
+
+  if ((size_x == 1) && (size_y == 1) && band && canBlit1()) {
+    // Unpack into whole-byte scanlines, drawBitmap() style, and blit them
+    // a band of rows at a time
+    uint8_t *r = rows;
+    if (rle) {
+      memset(rows, 0, band * byteWidth);
+      uint16_t xx = 0, yy = 0;
+      while (yy < h) {
+        uint8_t code = pgm_read_byte(src++), lit = code & 0x0F;
+        for (xx += code >> 4; xx >= w; xx -= w)
+          yy++;
+        while (lit && (yy < h)) {
+          if (yy >= top + band) {
+            drawBitmap1(x1, y1 + top, rows, w, band, color, 0, false, false);
+            memset(rows, 0, band * byteWidth);
+            top = yy;
+          }
+          uint8_t n = min(lit, w - xx), s = xx & 7, e = s + n;
+          uint8_t *p = &rows[(yy - top) * byteWidth + (xx >> 3)];
+          for (; e > 8; e -= 8, s = 0)
+            *p++ |= 0xFF >> s;
+          *p |= (uint8_t)(0xFF >> s) & (uint8_t)(0xFF << (8 - e));
+          lit -= n;
+          if ((xx += n) >= w) {
+            xx = 0;
+            yy++;
+          }
+        }
+      }
+    } else {
+      // Packed glyphs have no scanline pad; realign each row
+      uint16_t bytes = ((uint16_t)w * h + 7) / 8;
+      uint8_t pad = (uint8_t)(0xFF << (byteWidth * 8 - w));
+      for (uint16_t bit = 0, yy = 0; yy < h; yy++, bit += w) {
+        if (yy == top + band) {
+          drawBitmap1(x1, y1 + top, rows, w, band, color, 0, false, false);
+          top = yy;
+          r = rows;
+        }
+        for (uint8_t n = 0; n < byteWidth; n++) {
+          uint16_t b = bit + n * 8, i = b >> 3;
+          uint16_t v = pgm_read_byte(&src[i]) << 8;
+          if ((b & 7) && (i + 1 < bytes))
+            v |= pgm_read_byte(&src[i + 1]);
+          *r++ = (uint8_t)((v << (b & 7)) >> 8);
+        }
+        r[-1] &= pad;
       }
-      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
-               textsize_y);
-      cursor_x += textsize_x * 6; // Advance x one char
     }
+    drawBitmap1(x1, y1 + top, rows, w, min(band, h - top), color, 0, false,
+                false);
+    return;
+  }
 
-  } else { // Custom font
+  if (rle) {
+    // Run-length glyphs decode straight to spans, split at scanline ends
+    uint16_t xx = 0, yy = 0;
+    while (yy < h) {
+      uint8_t code = pgm_read_byte(src++), lit = code & 0x0F;
+      for (xx += code >> 4; xx >= w; xx -= w)
+        yy++;
+      while (lit && (yy < h)) {
+        uint8_t n = min(lit, w - xx);
+        if (size_x == 1 && size_y == 1)
+          writeFastHLine(x1 + xx, y1 + yy, n, color);
+        else
+          writeFillRect(x1 + xx * size_x, y1 + yy * size_y, n * size_x,
+                        size_y, color);
+        lit -= n;
+        if ((xx += n) >= w) {
+          xx = 0;
+          yy++;
+        }
+      }
+    }
+    return;
+  }
 
-    if (c == '\n') {
-      cursor_x = 0;
-      cursor_y +=
-          (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
-    } else if (c != '\r') {
+  // Packed glyphs: scan each row for runs of set bits
+  for (uint8_t yy = 0; yy < h; yy++) {
+    uint16_t bit = yy * w;
+    uint8_t bits = pgm_read_byte(&src[bit >> 3]) << (bit & 7);
+    int16_t run = -1; // Start of the current span of set bits, if any
+    for (uint8_t xx = 0; xx <= w; xx++, bit++, bits <<= 1) {
+      if ((xx < w) && xx && !(bit & 7))
+        bits = pgm_read_byte(&src[bit >> 3]);
+      if ((xx < w) && (bits & 0x80)) {
+        if (run < 0)
+          run = xx;
+      } else if (run >= 0) {
+        if (size_x == 1 && size_y == 1)
+          writeFastHLine(x1 + run, y1 + yy, xx - run, color);
+        else
+          writeFillRect(x1 + run * size_x, y1 + yy * size_y,
+                        (xx - run) * size_x, size_y, color);
+        run = -1;
+      }
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a string at the given position with the current font, text
+   color and size, without moving the text cursor or wrapping. Custom-font
+   glyph records are resolved once per character and drawn as spans (or
+   blits), skipping glyphs that fall entirely off-screen; '\n' returns to
+   the starting x on the next line. As with print(), custom fonts ignore
+   the text background color.
+    @param    x   Starting x coordinate (cursor position)
+    @param    y   Starting y coordinate (cursor position)
+    @param    str The ASCII string to draw
+    @returns  The x coordinate following the last character drawn
+*/
+/**************************************************************************/
+int16_t Adafruit_GFX::drawText(int16_t x, int16_t y, const char *str) {
+  int16_t x0 = x;
+  uint8_t c;
+
+  if (!gfxFont) { // 'Classic' built-in font
+    while ((c = *str++)) {
+      if (c == '\n') {
+        x = x0;
+        y += textsize_y * 8;
+      } else if (c != '\r') {
+        drawChar(x, y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+        x += textsize_x * 6;
+      }
+    }
+    return x;
+  }
+
+  uint8_t first = pgm_read_byte(&gfxFont->first),
+          last = pgm_read_byte(&gfxFont->last),
+          ya = pgm_read_byte(&gfxFont->yAdvance);
+  uint8_t *bitmap = pgm_read_bitmap_ptr(gfxFont);
+  GFXglyph glyph;
+
+  startWrite();
+  while ((c = *str++)) {
+    if (c == '\n') {
+      x = x0;
+      y += (int16_t)textsize_y * ya;
+    } else if ((c != '\r') && (c >= first) && (c <= last)) {
+      readGlyph(pgm_read_glyph_ptr(gfxFont, c - first), &glyph);
+      drawGlyph(x, y, &glyph, bitmap, textcolor, textsize_x, textsize_y);
+      x += glyph.xAdvance * (int16_t)textsize_x;
+    }
+  }
+  endWrite();
+  return x;
+}
+/**************************************************************************/
+/*!
+    @brief  Print one byte/character of data, used to support print()
+    @param  c  The 8-bit ascii character to write
+*/
+/**************************************************************************/
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (!gfxFont) { // 'Classic' built-in font
+
+    if (c == '\n') {              // Newline?
+      cursor_x = 0;               // Reset x to zero,
+      cursor_y += textsize_y * 8; // advance y one line
+    } else if (c != '\r') {       // Ignore carriage returns
+      if (wrap && ((cursor_x + textsize_x * 6) > _width)) { // Off right?
+        cursor_x = 0;                                       // Reset x to zero,
+        cursor_y += textsize_y * 8; // advance y one line
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+               textsize_y);
+      cursor_x += textsize_x * 6; // Advance x one char
+    }
+
+  } else { // Custom font
+
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y +=
+          (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+    } else if (c != '\r') {
       uint8_t first = pgm_read_byte(&gfxFont->first);
       if ((c >= first) && (c <= (uint8_t)pgm_read_byte(&gfxFont->last))) {
         GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, c - first);
@@ -1567,12 +2459,26 @@ void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
   uint8_t c; // Current character
   int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1; // Bound rect
   // Bound rect is intentionally initialized inverted, so 1st char sets it
+  const char *s = str;
+
+  // Unwrapped custom-font bounds just translate with the start position,
+  // unless a newline sends x back to 0. Bounds ending left of or above 0
+  // are clamped by the maxx/maxy start, so those are always measured.
+  bool cached = textCache && gfxFont && !wrap && !strchr(str, '\n');
+  if (cached && textCache->lookup(gfxFont, textsize_x, textsize_y, str, x1,
+                                  y1, w, h)) {
+    *x1 += x;
+    *y1 += y;
+    if ((*x1 + *w > 0) && (*y1 + *h > 0))
+      return;
+  }
 
   *x1 = x; // Initial position is value passed in
   *y1 = y;
   *w = *h = 0; // Initial size is zero
 
-  while ((c = *str++)) {
+  int16_t x0 = x, y0 = y;
+  while ((c = *s++)) {
     // charBounds() modifies x/y to advance for each character,
     // and min/max x/y are updated to incrementally build bounding rect.
     charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
@@ -1586,6 +2492,10 @@ void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
     *y1 = miny;
     *h = maxy - miny + 1;
   }
+
+  if (cached && *w && *h && (*x1 + *w > 0) && (*y1 + *h > 0))
+    textCache->store(gfxFont, textsize_x, textsize_y, str, *x1 - x0,
+                     *y1 - y0, *w, *h);
 }
 
 /**************************************************************************/
@@ -1825,21 +2735,1110 @@ bool Adafruit_GFX_Button::contains(int16_t x, int16_t y) {
           (y < (int16_t)(_y1 + _h)));
 }
 
-/**************************************************************************/
-/*!
-   @brief    Query whether the button was pressed since we last checked state
-   @returns  True if was not-pressed before, now is.
-*/
-/**************************************************************************/
-bool Adafruit_GFX_Button::justPressed() { return (currstate && !laststate); }
+/**************************************************************************/
+/*!
+   @brief    Query whether the button was pressed since we last checked state
+   @returns  True if was not-pressed before, now is.
+*/
+/**************************************************************************/
+bool Adafruit_GFX_Button::justPressed() { return (currstate && !laststate); }
+
+/**************************************************************************/
+/*!
+   @brief    Query whether the button was released since we last checked state
+   @returns  True if was pressed before, now is not.
+*/
+/**************************************************************************/
+bool Adafruit_GFX_Button::justReleased() { return (!currstate && laststate); }
+
+// -------------------------------------------------------------------------
+
+// GFXtextCache remembers the bounds of recently measured strings, so
+// dashboards that re-center the same labels every frame don't re-walk each
+// glyph. Bounds are stored relative to the start position and keyed by
+// font, text size and the full text; strings longer than
+// GFX_TEXT_CACHE_CHARS are simply never cached.
+
+/**************************************************************************/
+/*!
+   @brief    Create an empty text metrics cache
+*/
+/**************************************************************************/
+GFXtextCache::GFXtextCache(void) { clear(); }
+
+/**************************************************************************/
+/*!
+   @brief    Forget all cached strings and reset the hit/miss counters
+*/
+/**************************************************************************/
+void GFXtextCache::clear(void) {
+  memset(entry, 0, sizeof(entry));
+  next = 0;
+  hits = misses = 0;
+}
+
+// Hash a string for quick rejection, or return 0 if it is too long to cache
+static uint16_t textHash(const char *str) {
+  uint16_t hash = 1;
+  for (uint8_t n = 0; str[n]; n++) {
+    if (n >= GFX_TEXT_CACHE_CHARS)
+      return 0;
+    hash = (hash * 31) ^ (uint8_t)str[n];
+  }
+  return hash ? hash : 1;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Look up the bounds of a string
+    @param    font    The GFXfont used to measure
+    @param    size_x  Text magnification in X-axis
+    @param    size_y  Text magnification in Y-axis
+    @param    str     The ASCII string
+    @param    dx      Bounding box left edge relative to the start x, returned
+    @param    dy      Bounding box top edge relative to the start y, returned
+    @param    w       Bounding box width, returned
+    @param    h       Bounding box height, returned
+    @returns  True on a hit; outputs are untouched on a miss
+*/
+/**************************************************************************/
+bool GFXtextCache::lookup(const GFXfont *font, uint8_t size_x, uint8_t size_y,
+                          const char *str, int16_t *dx, int16_t *dy,
+                          uint16_t *w, uint16_t *h) {
+  uint16_t hash = textHash(str);
+  if (hash) {
+    for (uint8_t i = 0; i < GFX_TEXT_CACHE_ENTRIES; i++) {
+      Entry *e = &entry[i];
+      if ((e->hash == hash) && (e->font == font) && (e->size_x == size_x) &&
+          (e->size_y == size_y) && !strcmp(e->text, str)) {
+        *dx = e->dx;
+        *dy = e->dy;
+        *w = e->w;
+        *h = e->h;
+        hits++;
+        return true;
+      }
+    }
+  }
+  misses++;
+  return false;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Remember the bounds of a string, replacing the oldest entry
+    @param    font    The GFXfont used to measure
+    @param    size_x  Text magnification in X-axis
+    @param    size_y  Text magnification in Y-axis
+    @param    str     The ASCII string
+    @param    dx      Bounding box left edge relative to the start x
+    @param    dy      Bounding box top edge relative to the start y
+    @param    w       Bounding box width
+    @param    h       Bounding box height
+*/
+/**************************************************************************/
+void GFXtextCache::store(const GFXfont *font, uint8_t size_x, uint8_t size_y,
+                         const char *str, int16_t dx, int16_t dy, uint16_t w,
+                         uint16_t h) {
+  uint16_t hash = textHash(str);
+  if (!hash)
+    return;
+  Entry *e = &entry[next];
+  next = (next + 1) % GFX_TEXT_CACHE_ENTRIES;
+  e->font = font;
+  e->size_x = size_x;
+  e->size_y = size_y;
+  e->hash = hash;
+  e->dx = dx;
+  e->dy = dy;
+  e->w = w;
+  e->h = h;
+  strcpy(e->text, str);
+}
+
+// -------------------------------------------------------------------------
+
+// Adafruit_GFX_NumericField is for readouts that change several times a
+// second. begin() renders the characters below once into an offscreen
+// canvas, one fixed-size cell each, in either 1-bit (drawBitmap()) or
+// RGB 5/6/5 (drawRGBBitmap()) form to suit the display. print() then
+// right-aligns the text and blits only the cells whose character changed.
+
+static const char fieldGlyphs[] = "0123456789.- "; // Atlas cell order
+#define FIELD_SPACE 12 // Atlas index of ' '
+
+/**************************************************************************/
+/*!
+   @brief    Create an unattached numeric field; call begin() before use
+*/
+/**************************************************************************/
+Adafruit_GFX_NumericField::Adafruit_GFX_NumericField(void) {
+  _gfx = NULL;
+  _atlas1 = NULL;
+  _atlas16 = NULL;
+  _x = _y = _cellW = _cellH = 0;
+  _color = _bg = 0;
+  _chars = 0;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Free the glyph atlas
+*/
+/**************************************************************************/
+Adafruit_GFX_NumericField::~Adafruit_GFX_NumericField(void) { end(); }
+
+/**************************************************************************/
+/*!
+   @brief    Render the glyph atlas and place the field. Cells are as wide
+   as the widest of "0-9 . - space" (advance or ink) and as tall as their
+   combined ink, so every cell fully repaints its background.
+    @param    gfx    The display or canvas to draw to
+    @param    font   The GFXfont to use (the classic font is not supported)
+    @param    x      Left edge of the field, as for setCursor()
+    @param    y      Baseline of the field, as for setCursor()
+    @param    chars  Number of character cells, up to GFX_FIELD_MAX_CHARS
+    @param    color  Text color
+    @param    bg     Background color
+    @param    depth  Atlas format: 1 for 1-bit targets (drawBitmap()), or 16
+                     for RGB 5/6/5 targets (drawRGBBitmap())
+    @returns  True on success, false on bad arguments or out of memory
+*/
+/**************************************************************************/
+bool Adafruit_GFX_NumericField::begin(Adafruit_GFX *gfx, const GFXfont *font,
+                                      int16_t x, int16_t y, uint8_t chars,
+                                      uint16_t color, uint16_t bg,
+                                      uint8_t depth) {
+  end();
+  if (!gfx || !font || !chars || (chars > GFX_FIELD_MAX_CHARS) ||
+      ((depth != 1) && (depth != 16)))
+    return false;
+
+  // Common cell box, relative to the cursor position on the baseline
+  uint8_t first = pgm_read_byte(&font->first),
+          last = pgm_read_byte(&font->last);
+  int16_t minx = 0, miny = 0, maxx = 0, maxy = 0;
+  for (uint8_t k = 0; k < sizeof(fieldGlyphs) - 1; k++) {
+    uint8_t c = fieldGlyphs[k];
+    if ((c < first) || (c > last))
+      continue;
+    GFXglyph glyph;
+    readGlyph(pgm_read_glyph_ptr(font, c - first), &glyph);
+    minx = min(minx, glyph.xOffset);
+    miny = min(miny, glyph.yOffset);
+    maxx = max(maxx, max(glyph.xAdvance, glyph.xOffset + glyph.width));
+    maxy = max(maxy, glyph.yOffset + glyph.height);
+  }
+  if ((maxx <= minx) || (maxy <= miny))
+    return false;
+
+  _cellW = maxx - minx;
+  _cellH = maxy - miny;
+  uint16_t atlasH = _cellH * (sizeof(fieldGlyphs) - 1);
+  Adafruit_GFX *atlas;
+  if (depth == 16) {
+    _atlas16 = new GFXcanvas16(_cellW, atlasH);
+    if (!_atlas16 || !_atlas16->getBuffer()) {
+      end();
+      return false;
+    }
+    _atlas16->fillScreen(bg);
+    atlas = _atlas16;
+  } else {
+    _atlas1 = new GFXcanvas1(_cellW, atlasH);
+    if (!_atlas1 || !_atlas1->getBuffer()) {
+      end();
+      return false;
+    }
+    atlas = _atlas1;
+  }
+
+  atlas->setFont(font);
+  for (uint8_t k = 0; k < sizeof(fieldGlyphs) - 1; k++) {
+    uint8_t c = fieldGlyphs[k];
+    if ((c >= first) && (c <= last))
+      atlas->drawChar(-minx, k * _cellH - miny, c, (depth == 16) ? color : 1,
+                      bg, 1);
+  }
+
+  _gfx = gfx;
+  _x = x + minx;
+  _y = y + miny;
+  _color = color;
+  _bg = bg;
+  _chars = chars;
+  invalidate();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Free the glyph atlas. The field must be begin()'d again to use.
+*/
+/**************************************************************************/
+void Adafruit_GFX_NumericField::end(void) {
+  delete _atlas1;
+  delete _atlas16;
+  _atlas1 = NULL;
+  _atlas16 = NULL;
+  _gfx = NULL;
+  _chars = 0;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Forget what is on screen, so the next print() redraws every
+   cell (e.g. after the display was cleared)
+*/
+/**************************************************************************/
+void Adafruit_GFX_NumericField::invalidate(void) {
+  memset(_shown, 0xFF, sizeof(_shown));
+}
+
+/**************************************************************************/
+/*!
+   @brief    Show a string, right-aligned in the field. Characters outside
+   "0-9 . - space" show as blanks; text wider than the field shows as all
+   '-'. Only cells whose character changed are redrawn.
+    @param    text   The string to show
+*/
+/**************************************************************************/
+void Adafruit_GFX_NumericField::print(const char *text) {
+  if (!_gfx)
+    return;
+  size_t len = strlen(text);
+  uint8_t pad = (len <= _chars) ? _chars - len : 0;
+  for (uint8_t i = 0; i < _chars; i++) {
+    uint8_t k = FIELD_SPACE;
+    if (len > _chars) {
+      k = FIELD_SPACE - 1; // '-'
+    } else if (i >= pad) {
+      const char *p = strchr(fieldGlyphs, text[i - pad]);
+      if (p && *p)
+        k = p - fieldGlyphs;
+    }
+    if (_shown[i] != k) {
+      drawCell(i, k);
+      _shown[i] = k;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Show an integer, right-aligned in the field
+    @param    value  The number to show
+*/
+/**************************************************************************/
+void Adafruit_GFX_NumericField::print(long value) {
+  printNumber((value < 0) ? -(unsigned long)value : value, value < 0, 0);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Show a number with a fixed number of decimals, right-aligned
+   in the field
+    @param    value     The number to show
+    @param    decimals  Digits after the decimal point
+*/
+/**************************************************************************/
+void Adafruit_GFX_NumericField::print(double value, uint8_t decimals) {
+  bool neg = value < 0;
+  if (neg)
+    value = -value;
+  for (uint8_t d = 0; d < decimals; d++)
+    value *= 10;
+  if (value >= 4294967295.0) { // Won't fit; let print() show the overflow
+    print("--------------------");
+    return;
+  }
+  unsigned long v = (unsigned long)(value + 0.5);
+  printNumber(v, neg && v, decimals);
+}
+
+// Format v / 10^decimals (with sign) right to left and print() it
+void Adafruit_GFX_NumericField::printNumber(unsigned long v, bool neg,
+                                            uint8_t decimals) {
+  char buf[GFX_FIELD_MAX_CHARS + 2], *p = &buf[sizeof(buf) - 1];
+  *p = 0;
+  uint8_t n = 0;
+  do {
+    if (p == buf) { // Too long for any field
+      print("--------------------");
+      return;
+    }
+    if (decimals && (n == decimals))
+      *--p = '.';
+    else {
+      *--p = '0' + v % 10;
+      v /= 10;
+    }
+    n++;
+  } while (v || (n <= decimals + (decimals ? 1 : 0)));
+  if (neg && (p > buf))
+    *--p = '-';
+  print(p);
+}
+
+// Blit one atlas cell to the display
+void Adafruit_GFX_NumericField::drawCell(uint8_t cell, uint8_t glyph) {
+  int16_t x = _x + cell * _cellW;
+  if (_atlas16) {
+    _gfx->drawRGBBitmap(x, _y,
+                        _atlas16->getBuffer() + (int32_t)glyph * _cellW * _cellH,
+                        _cellW, _cellH);
+  } else {
+    _gfx->drawBitmap(x, _y,
+                     _atlas1->getBuffer() +
+                         (int32_t)glyph * ((_cellW + 7) / 8) * _cellH,
+                     _cellW, _cellH, _color, _bg);
+  }
+}
+
+// -------------------------------------------------------------------------
+
+// GFXdisplayList is a drawing target that keeps a compact list of the
+// operations drawn to it instead of pixels. replay() issues them again on
+// any other Adafruit_GFX, so a screen can be composed once and rendered
+// later, e.g. strip by strip into a small canvas. Operations are a one-byte
+// opcode followed by 16-bit arguments (and, for bitmaps, the bitmap data).
+// Primitives arrive already broken down by Adafruit_GFX into lines, rects,
+// spans and bitmaps; runs of single pixels are merged into lines, and an
+// opaque full-screen fill discards everything recorded before it. Keeping
+// the previous frame's list, diff() finds the region a new frame changes
+// and replay() can redraw just that rectangle, leaving the rest alone.
+
+#define DL_PIXEL 1  // x, y, color
+#define DL_HLINE 2  // x, y, w, color
+#define DL_VLINE 3  // x, y, h, color
+#define DL_RECT 4   // x, y, w, h, color
+#define DL_LINE 5   // x0, y0, x1, y1, color
+#define DL_SPANS 6  // count, color, then count * (y, x1, x2)
+#define DL_BLEND 7  // x, y, color, alpha
+#define DL_BITMAP 8 // x, y, w, h, color, bg, opaque, then the bitmap bytes
+#define DL_RGB 9    // x, y, w, h, then a pointer to the RAM bitmap
+
+// Number of 16-bit arguments of each opcode
+static const uint8_t PROGMEM dlistArgs[] = {0, 3, 4, 4, 5, 5, 2, 4, 7, 4};
+
+#define DL_RESYNC 8 // How far diff() looks ahead for a matching operation
+
+/**************************************************************************/
+/*!
+   @brief    Instatiate an empty display list
+   @param    w      Width of the drawing area, in pixels
+   @param    h      Height of the drawing area, in pixels
+   @param    bytes  Capacity of the list, allocated with malloc
+*/
+/**************************************************************************/
+GFXdisplayList::GFXdisplayList(uint16_t w, uint16_t h, uint16_t bytes)
+    : Adafruit_GFX(w, h) {
+  _list = (uint8_t *)malloc(bytes);
+  _bytes = _list ? bytes : 0;
+  clear();
+}
+
+/**************************************************************************/
+/*!
+   @brief    Delete the display list, free memory
+*/
+/**************************************************************************/
+GFXdisplayList::~GFXdisplayList(void) {
+  if (_list)
+    free(_list);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Forget everything recorded so far
+*/
+/**************************************************************************/
+void GFXdisplayList::clear(void) {
+  _used = _last = 0;
+  _overflow = false;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Called when an operation doesn't fit in the list. Subclasses
+            can grow() the list here; the default gives up and the
+            operation is dropped.
+    @param    need  Bytes the list must hold for the operation to fit
+    @returns  true if the list now has room and the operation should be
+              retried
+*/
+/**************************************************************************/
+bool GFXdisplayList::full(uint32_t need) {
+  (void)need;
+  return false;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Enlarge the list, keeping what's recorded. The capacity at
+            least doubles so a frame that outgrows the list only
+            reallocates a few times.
+    @param    need  Bytes the list must hold, at most 65535
+    @returns  true on success, false if need is too large or out of memory
+*/
+/**************************************************************************/
+bool GFXdisplayList::grow(uint32_t need) {
+  if (need > 0xFFFF)
+    return false;
+  uint32_t bytes = (uint32_t)_bytes * 2;
+  if (bytes < need)
+    bytes = need;
+  if (bytes > 0xFFFF)
+    bytes = 0xFFFF;
+  uint8_t *list = (uint8_t *)realloc(_list, bytes);
+  if (!list)
+    return false;
+  _list = list;
+  _bytes = bytes;
+  return true;
+}
+
+// Append an operation with n arguments and room for extra trailing bytes.
+// Returns a pointer to the trailing bytes, or NULL if it didn't fit.
+uint8_t *GFXdisplayList::add(uint8_t op, const int16_t *args, uint8_t n,
+                             uint16_t extra) {
+  uint32_t len = 1 + n * 2 + extra;
+  if ((_used + len > _bytes) &&
+      (!full(_used + len) || (_used + len > _bytes))) {
+    _overflow = true;
+    return NULL;
+  }
+  uint8_t *p = &_list[_used];
+  *p++ = op;
+  memcpy(p, args, n * 2);
+  _last = _used;
+  _used += len;
+  return p + n * 2;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a single pixel, extending the previous operation when it
+            continues a run of the same color
+    @param  x   x coordinate
+    @param  y   y coordinate
+    @param  color 16-bit 5-6-5 Color to draw with
+*/
+/**************************************************************************/
+void GFXdisplayList::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return;
+  uint8_t *p = &_list[_last];
+  if (_used && (*p <= DL_VLINE)) {
+    int16_t a[4]; // x, y, color for a pixel; x, y, length, color for a line
+    memcpy(a, p + 1, pgm_read_byte(&dlistArgs[*p]) * 2);
+    if (*p == DL_PIXEL) {
+      bool h = (y == a[1]) && (x == a[0] + 1);
+      bool v = (x == a[0]) && (y == a[1] + 1);
+      if (((uint16_t)a[2] == color) && (h || v) && (_used + 2 <= _bytes)) {
+        *p = h ? DL_HLINE : DL_VLINE; // Becomes a 2-pixel line
+        a[3] = a[2];
+        a[2] = 2;
+        memcpy(p + 1, a, sizeof(a));
+        _used += 2;
+        return;
+      }
+    } else if (((uint16_t)a[3] == color) &&
+               ((*p == DL_HLINE) ? ((y == a[1]) && (x == a[0] + a[2]))
+                                 : ((x == a[0]) && (y == a[1] + a[2])))) {
+      a[2]++;
+      memcpy(p + 1, a, sizeof(a));
+      return;
+    }
+  }
+  int16_t a[] = {x, y, (int16_t)color};
+  add(DL_PIXEL, a, 3);
+}
+
+/**************************************************************************/
+/*!
+   @brief  Record a vertical line, clipped to the drawing area
+    @param    x   Line horizontal start point
+    @param    y   Line vertical start point
+    @param    h   Length of vertical line to be drawn, including first point
+    @param    color   Color to draw with
+*/
+/**************************************************************************/
+void GFXdisplayList::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                   uint16_t color) {
+  if (h < 0) {
+    h = -h;
+    y -= h - 1;
+  }
+  if ((x < 0) || (x >= _width))
+    return;
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (y + h > _height)
+    h = _height - y;
+  if (h <= 0)
+    return;
+  int16_t a[] = {x, y, h, (int16_t)color};
+  add(DL_VLINE, a, 4);
+}
+
+/**************************************************************************/
+/*!
+   @brief  Record a horizontal line, clipped to the drawing area
+    @param    x   Line horizontal start point
+    @param    y   Line vertical start point
+    @param    w   Length of horizontal line to be drawn, including first point
+    @param    color   Color to draw with
+*/
+/**************************************************************************/
+void GFXdisplayList::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                   uint16_t color) {
+  if (w < 0) {
+    w = -w;
+    x -= w - 1;
+  }
+  if ((y < 0) || (y >= _height))
+    return;
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (x + w > _width)
+    w = _width - x;
+  if (w <= 0)
+    return;
+  int16_t a[] = {x, y, w, (int16_t)color};
+  add(DL_HLINE, a, 4);
+}
+
+/**************************************************************************/
+/*!
+   @brief  Record a filled rectangle, clipped to the drawing area. One that
+           covers the whole area hides everything before it, so the list
+           is emptied first.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    w   Width in pixels
+    @param    h   Height in pixels
+    @param    color 16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void GFXdisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                              uint16_t color) {
+  if (w < 0) {
+    w = -w;
+    x -= w - 1;
+  }
+  if (h < 0) {
+    h = -h;
+    y -= h - 1;
+  }
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > _width)
+    w = _width - x;
+  if (y + h > _height)
+    h = _height - y;
+  if ((w <= 0) || (h <= 0))
+    return;
+  if ((w == _width) && (h == _height))
+    clear();
+  int16_t a[] = {x, y, w, h, (int16_t)color};
+  add(DL_RECT, a, 5);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Record a line, unless it lies entirely outside the drawing area
+    @param    x0  Start point x coordinate
+    @param    y0  Start point y coordinate
+    @param    x1  End point x coordinate
+    @param    y1  End point y coordinate
+    @param    color 16-bit 5-6-5 Color to draw with
+*/
+/**************************************************************************/
+void GFXdisplayList::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                               uint16_t color) {
+  if ((max(x0, x1) < 0) || (max(y0, y1) < 0) || (min(x0, x1) >= _width) ||
+      (min(y0, y1) >= _height))
+    return;
+  int16_t a[] = {x0, y0, x1, y1, (int16_t)color};
+  add(DL_LINE, a, 5);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Record a RAM-resident 16-bit image (RGB 5/6/5) by reference.
+            The bitmap is not copied and must stay valid, unchanged, until
+            the list is replayed.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with 16-bit color bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+*/
+/**************************************************************************/
+void GFXdisplayList::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
+                                   int16_t w, int16_t h) {
+  if ((w <= 0) || (h <= 0) || (x >= _width) || (y >= _height) ||
+      (x + w <= 0) || (y + h <= 0))
+    return;
+  int16_t a[] = {x, y, w, h};
+  uint8_t *p = add(DL_RGB, a, 4, sizeof(bitmap));
+  if (p)
+    memcpy(p, &bitmap, sizeof(bitmap));
+}
+
+/**************************************************************************/
+/*!
+   @brief   Record a batch of spans, appending to the previous batch if it
+            had the same color
+    @param  batch  Spans in rotated coordinates, on screen, x1 <= x2
+*/
+/**************************************************************************/
+void GFXdisplayList::writeSpans(const GFXspanBatch *batch) {
+  if (batch->vertical) { // Not requested by verticalSpans(), but just in case
+    Adafruit_GFX::writeSpans(batch);
+    return;
+  }
+  uint16_t bytes = batch->count * 6;
+  if (_used && (_list[_last] == DL_SPANS) && (_used + bytes <= _bytes)) {
+    int16_t a[2];
+    memcpy(a, &_list[_last + 1], sizeof(a));
+    if ((uint16_t)a[1] == batch->color) {
+      a[0] += batch->count;
+      memcpy(&_list[_last + 1], a, sizeof(a));
+      memcpy(&_list[_used], batch->span, bytes);
+      _used += bytes;
+      return;
+    }
+  }
+  int16_t a[] = {batch->count, (int16_t)batch->color};
+  uint8_t *p = add(DL_SPANS, a, 2, bytes);
+  if (p)
+    memcpy(p, batch->span, bytes);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Record a pixel blended over whatever the replay target holds
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  16-bit 5-6-5 Color to blend in
+    @param  alpha  Opacity, 0 (none) to 255 (opaque)
+*/
+/**************************************************************************/
+void GFXdisplayList::blendPixel(int16_t x, int16_t y, uint16_t color,
+                                uint8_t alpha) {
+  if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height) || !alpha)
+    return;
+  int16_t a[] = {x, y, (int16_t)color, alpha};
+  add(DL_BLEND, a, 4);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Record a 1-bit image, copying the bitmap into the list so text
+            glyphs and RAM bitmaps may change before replay
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with monochrome bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Color to draw set bits with
+    @param    bg Color to draw unset bits with (if opaque)
+    @param    opaque If false, unset bits are transparent
+    @param    progmem True if bitmap is PROGMEM-resident
+    @returns  true; the list always takes the image
+*/
+/**************************************************************************/
+bool GFXdisplayList::drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap,
+                                 int16_t w, int16_t h, uint16_t color,
+                                 uint16_t bg, bool opaque, bool progmem) {
+  if ((w <= 0) || (h <= 0) || (x >= _width) || (y >= _height) ||
+      (x + w <= 0) || (y + h <= 0))
+    return true;
+  uint16_t bytes = ((w + 7) / 8) * h;
+  int16_t a[] = {x, y, w, h, (int16_t)color, (int16_t)bg, opaque};
+  uint8_t *p = add(DL_BITMAP, a, 7, bytes);
+  if (p) {
+    if (progmem) {
+      for (uint16_t i = 0; i < bytes; i++)
+        p[i] = pgm_read_byte(&bitmap[i]);
+    } else {
+      memcpy(p, bitmap, bytes);
+    }
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief   The list records every drawBitmap1() image
+    @returns  true
+*/
+/**************************************************************************/
+bool GFXdisplayList::canBlit1(void) const { return true; }
+
+// Decode the operation at offset i: its arguments into a and, if box isn't
+// NULL, its bounding box (left, top, right, bottom) into box. Returns the
+// offset of the following operation.
+uint16_t GFXdisplayList::decode(uint16_t i, int16_t *a, int16_t *box) const {
+  uint8_t op = _list[i], n = pgm_read_byte(&dlistArgs[op]);
+  const uint8_t *data = &_list[i + 1 + n * 2];
+  memcpy(a, &_list[i + 1], n * 2);
+  i += 1 + n * 2;
+  if (op == DL_SPANS)
+    i += a[0] * 6;
+  else if (op == DL_BITMAP)
+    i += ((a[2] + 7) / 8) * a[3];
+  else if (op == DL_RGB)
+    i += sizeof(uint16_t *);
+  if (!box)
+    return i;
+
+  switch (op) {
+  case DL_PIXEL:
+  case DL_BLEND:
+    box[0] = box[2] = a[0];
+    box[1] = box[3] = a[1];
+    break;
+  case DL_HLINE:
+    box[0] = a[0];
+    box[1] = box[3] = a[1];
+    box[2] = a[0] + a[2] - 1;
+    break;
+  case DL_VLINE:
+    box[0] = box[2] = a[0];
+    box[1] = a[1];
+    box[3] = a[1] + a[2] - 1;
+    break;
+  case DL_LINE:
+    box[0] = min(a[0], a[2]);
+    box[1] = min(a[1], a[3]);
+    box[2] = max(a[0], a[2]);
+    box[3] = max(a[1], a[3]);
+    break;
+  case DL_SPANS:
+    box[0] = box[1] = 0x7FFF;
+    box[2] = box[3] = -0x8000;
+    for (int16_t s = 0; s < a[0]; s++, data += 6) {
+      int16_t span[3];
+      memcpy(span, data, sizeof(span));
+      box[0] = min(box[0], span[1]);
+      box[1] = min(box[1], span[0]);
+      box[2] = max(box[2], span[2]);
+      box[3] = max(box[3], span[0]);
+    }
+    break;
+  default: // DL_RECT, DL_BITMAP, DL_RGB
+    box[0] = a[0];
+    box[1] = a[1];
+    box[2] = a[0] + a[2] - 1;
+    box[3] = a[1] + a[3] - 1;
+    break;
+  }
+  return i;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw the recorded operations onto another GFX target, offset so
+            that list point (x, y) lands on the target's top left corner.
+            Operations that miss the target entirely are skipped, the
+            target clips the rest, so a list can be rendered in strips.
+    @param  gfx  Target to draw on
+    @param  x    List x coordinate of the target's left edge
+    @param  y    List y coordinate of the target's top edge
+*/
+/**************************************************************************/
+void GFXdisplayList::replay(Adafruit_GFX *gfx, int16_t x, int16_t y) const {
+  render(gfx, x, y, x, y, x + gfx->width() - 1, y + gfx->height() - 1, false);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw the recorded operations onto another GFX target as above,
+            but only within a rectangle of the list, e.g. the one returned
+            by diff(). Nothing outside it is touched, so a static layer or
+            a changed region can be redrawn in place over an existing
+            image.
+    @param  gfx  Target to draw on
+    @param  x    List x coordinate of the target's left edge
+    @param  y    List y coordinate of the target's top edge
+    @param  cx   Left edge of the rectangle, in list coordinates
+    @param  cy   Top edge of the rectangle, in list coordinates
+    @param  cw   Width of the rectangle in pixels
+    @param  ch   Height of the rectangle in pixels
+*/
+/**************************************************************************/
+void GFXdisplayList::replay(Adafruit_GFX *gfx, int16_t x, int16_t y,
+                            int16_t cx, int16_t cy, int16_t cw,
+                            int16_t ch) const {
+  int16_t x2 = x + gfx->width() - 1, y2 = y + gfx->height() - 1;
+  if ((cw <= 0) || (ch <= 0))
+    return;
+  int16_t l = max(x, cx), t = max(y, cy), r = min(x2, (int16_t)(cx + cw - 1)),
+          b = min(y2, (int16_t)(cy + ch - 1));
+  if ((l <= r) && (t <= b))
+    render(gfx, x, y, l, t, r, b, true);
+}
+
+// Common to both replay()s: draw what falls in list window (l, t)-(r, b).
+// Rects, lines and spans are always trimmed to it; lines and bitmaps only
+// if exact, otherwise they're left for the target to clip.
+void GFXdisplayList::render(Adafruit_GFX *gfx, int16_t x, int16_t y, int16_t l,
+                            int16_t t, int16_t r, int16_t b,
+                            bool exact) const {
+  bool writing = false;
+  uint16_t i = 0;
+
+  // Bitmaps bracket themselves with startWrite()/endWrite(), the rest of
+  // the operations expect the caller to, and transactions don't nest
+#define DL_WRITE(w)                                                            \
+  if (writing != w) {                                                          \
+    if ((writing = w))                                                         \
+      gfx->startWrite();                                                       \
+    else                                                                       \
+      gfx->endWrite();                                                         \
+  }
+
+  while (i < _used) {
+    uint8_t op = _list[i];
+    const uint8_t *data = &_list[i + 1 + pgm_read_byte(&dlistArgs[op]) * 2];
+    int16_t a[7], box[4];
+    i = decode(i, a, box);
+    if ((box[0] > r) || (box[2] < l) || (box[1] > b) || (box[3] < t))
+      continue; // Misses the window entirely
+    bool inside = !exact || ((box[0] >= l) && (box[1] >= t) &&
+                             (box[2] <= r) && (box[3] <= b));
+    // Part of the box within the window
+    int16_t cl = max(box[0], l), ct = max(box[1], t), cr = min(box[2], r),
+            cb = min(box[3], b);
+
+    switch (op) {
+    case DL_PIXEL:
+      DL_WRITE(true);
+      gfx->writePixel(a[0] - x, a[1] - y, a[2]);
+      break;
+    case DL_HLINE:
+      DL_WRITE(true);
+      gfx->writeFastHLine(cl - x, ct - y, cr - cl + 1, a[3]);
+      break;
+    case DL_VLINE:
+      DL_WRITE(true);
+      gfx->writeFastVLine(cl - x, ct - y, cb - ct + 1, a[3]);
+      break;
+    case DL_RECT:
+      DL_WRITE(true);
+      gfx->writeFillRect(cl - x, ct - y, cr - cl + 1, cb - ct + 1, a[4]);
+      break;
+    case DL_LINE:
+      DL_WRITE(true);
+      if (inside) {
+        gfx->writeLine(a[0] - x, a[1] - y, a[2] - x, a[3] - y, a[4]);
+      } else { // Same steps as Adafruit_GFX::writeLine(), skipping pixels
+        int16_t x0 = a[0], y0 = a[1], x1 = a[2], y1 = a[3];
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) {
+          _swap_int16_t(x0, y0);
+          _swap_int16_t(x1, y1);
+        }
+        if (x0 > x1) {
+          _swap_int16_t(x0, x1);
+          _swap_int16_t(y0, y1);
+        }
+        int16_t dx = x1 - x0, dy = abs(y1 - y0), err = dx / 2;
+        int16_t ystep = (y0 < y1) ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+          int16_t px = steep ? y0 : x0, py = steep ? x0 : y0;
+          if ((px >= l) && (px <= r) && (py >= t) && (py <= b))
+            gfx->writePixel(px - x, py - y, a[4]);
+          err -= dy;
+          if (err < 0) {
+            y0 += ystep;
+            err += dx;
+          }
+        }
+      }
+      break;
+    case DL_SPANS: {
+      GFXspanBatch batch;
+      DL_WRITE(true);
+      // An oversized box forces the batch to clip to the target
+      if (gfx->beginSpans(&batch, -1, -1, gfx->width(), gfx->height(),
+                          a[1])) {
+        for (int16_t s = 0; s < a[0]; s++, data += 6) {
+          int16_t span[3];
+          memcpy(span, data, sizeof(span));
+          if ((span[0] >= t) && (span[0] <= b)) {
+            int16_t x1 = max(span[1], l), x2 = min(span[2], r);
+            if (x1 <= x2)
+              gfx->addSpan(&batch, span[0] - y, x1 - x, x2 - x);
+          }
+        }
+        gfx->endSpans(&batch);
+      }
+    } break;
+    case DL_BLEND:
+      DL_WRITE(true);
+      gfx->blendPixel(a[0] - x, a[1] - y, a[2], a[3]);
+      break;
+    case DL_BITMAP:
+      if (inside) {
+        DL_WRITE(false);
+        if (a[6])
+          gfx->drawBitmap(a[0] - x, a[1] - y, (uint8_t *)data, a[2], a[3],
+                          a[4], a[5]);
+        else
+          gfx->drawBitmap(a[0] - x, a[1] - y, (uint8_t *)data, a[2], a[3],
+                          a[4]);
+      } else { // Just the pixels in the window
+        int16_t byteWidth = (a[2] + 7) / 8;
+        DL_WRITE(true);
+        for (int16_t py = ct; py <= cb; py++) {
+          const uint8_t *row = &data[(py - a[1]) * byteWidth];
+          for (int16_t px = cl; px <= cr; px++) {
+            int16_t bit = px - a[0];
+            if (row[bit / 8] & (0x80 >> (bit & 7)))
+              gfx->writePixel(px - x, py - y, a[4]);
+            else if (a[6])
+              gfx->writePixel(px - x, py - y, a[5]);
+          }
+        }
+      }
+      break;
+    case DL_RGB: {
+      uint16_t *bitmap;
+      memcpy(&bitmap, data, sizeof(bitmap));
+      DL_WRITE(false);
+      if (inside) {
+        gfx->drawRGBBitmap(a[0] - x, a[1] - y, bitmap, a[2], a[3]);
+      } else { // Row by row, just the columns in the window
+        for (int16_t py = ct; py <= cb; py++)
+          gfx->drawRGBBitmap(cl - x, py - y,
+                             &bitmap[(int32_t)(py - a[1]) * a[2] + cl - a[0]],
+                             cr - cl + 1, 1);
+      }
+    } break;
+    }
+  }
+  DL_WRITE(false);
+#undef DL_WRITE
+}
+
+// Whether the operation at offset i equals the one at offset j of list o
+bool GFXdisplayList::same(uint16_t i, const GFXdisplayList *o,
+                          uint16_t j) const {
+  int16_t a[7];
+  uint16_t len = decode(i, a, NULL) - i;
+  return (o->decode(j, a, NULL) - j == len) &&
+         !memcmp(&_list[i], &o->_list[j], len);
+}
 
 /**************************************************************************/
 /*!
-   @brief    Query whether the button was released since we last checked state
-   @returns  True if was pressed before, now is not.
+   @brief   Find the region that differs between this list and an earlier
+            one of the same area, e.g. last frame's. Operations are matched
+            in order, resynchronizing after small insertions or deletions,
+            and the bounding box of everything unmatched in either list is
+            the region where the two may render differently. RGB bitmaps
+            are compared by address only, not content. Replaying just that
+            region over the old image assumes the list paints everything
+            it covers, e.g. starts with fillScreen().
+    @param  prev  The earlier list; NULL counts as completely different
+    @param  x1    Returns the left edge of the changed region
+    @param  y1    Returns the top edge of the changed region
+    @param  w     Returns the width of the changed region, 0 if none
+    @param  h     Returns the height of the changed region, 0 if none
+    @returns  true if anything changed
 */
 /**************************************************************************/
-bool Adafruit_GFX_Button::justReleased() { return (!currstate && laststate); }
+bool GFXdisplayList::diff(const GFXdisplayList *prev, int16_t *x1,
+                          int16_t *y1, uint16_t *w, uint16_t *h) const {
+  int16_t l = 0, t = 0, r = _width - 1, b = _height - 1; // All of it
+
+  if (prev && !_overflow && !prev->_overflow) {
+    uint16_t i = 0, j = 0;
+    l = t = 0x7FFF;
+    r = b = -0x8000;
+#define DL_GROW(list, k)                                                       \
+  {                                                                            \
+    int16_t a[7], box[4];                                                      \
+    k = list->decode(k, a, box);                                               \
+    l = min(l, box[0]);                                                        \
+    t = min(t, box[1]);                                                        \
+    r = max(r, box[2]);                                                        \
+    b = max(b, box[3]);                                                        \
+  }
+    while ((i < _used) || (j < prev->_used)) {
+      int16_t a[7];
+      if ((i < _used) && (j < prev->_used) && same(i, prev, j)) {
+        i = decode(i, a, NULL);
+        j = prev->decode(j, a, NULL);
+        continue;
+      }
+      // Look a few operations ahead in each list for the other's current
+      // one, and take the shorter way back in step
+      uint8_t skipI = DL_RESYNC + 1, skipJ = DL_RESYNC + 1, k;
+      uint16_t p;
+      if ((i < _used) && (j < prev->_used)) {
+        for (k = 1, p = decode(i, a, NULL); (k <= DL_RESYNC) && (p < _used);
+             k++, p = decode(p, a, NULL)) {
+          if (same(p, prev, j)) {
+            skipI = k;
+            break;
+          }
+        }
+        for (k = 1, p = prev->decode(j, a, NULL);
+             (k <= DL_RESYNC) && (p < prev->_used);
+             k++, p = prev->decode(p, a, NULL)) {
+          if (prev->same(p, this, i)) {
+            skipJ = k;
+            break;
+          }
+        }
+      }
+      if ((skipI <= DL_RESYNC) && (skipI <= skipJ)) { // Inserted here
+        while (skipI--)
+          DL_GROW(this, i);
+      } else if (skipJ <= DL_RESYNC) { // Deleted from prev
+        while (skipJ--)
+          DL_GROW(prev, j);
+      } else { // Changed in place
+        if (i < _used)
+          DL_GROW(this, i);
+        if (j < prev->_used)
+          DL_GROW(prev, j);
+      }
+    }
+#undef DL_GROW
+    // Lines may extend past the drawing area
+    l = max(l, (int16_t)0);
+    t = max(t, (int16_t)0);
+    r = min(r, (int16_t)(_width - 1));
+    b = min(b, (int16_t)(_height - 1));
+  }
+
+  if ((l > r) || (t > b)) {
+    *x1 = *y1 = 0;
+    *w = *h = 0;
+    return false;
+  }
+  *x1 = l;
+  *y1 = t;
+  *w = r - l + 1;
+  *h = b - t + 1;
+  return true;
+}
 
 // -------------------------------------------------------------------------
 
@@ -2003,6 +4002,42 @@ bool GFXcanvas1::getRawPixel(int16_t x, int16_t y) const {
   return 0;
 }
 
+/**************************************************************************/
+/*!
+   @brief   Draw a drawBitmap() image straight into the canvas buffer
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with monochrome bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color for set bits
+    @param    bg Binary (on or off) color for unset bits (if opaque)
+    @param    opaque If false, unset bits are transparent
+    @param    progmem True if bitmap is PROGMEM-resident
+    @returns  True if handled, false if there is no buffer
+*/
+/**************************************************************************/
+bool GFXcanvas1::drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap,
+                             int16_t w, int16_t h, uint16_t color, uint16_t bg,
+                             bool opaque, bool progmem) {
+  if (!buffer)
+    return false;
+  uint8_t bgOp = GFX_BLIT_NONE;
+  if (opaque)
+    bgOp = bg ? GFX_BLIT_SET : GFX_BLIT_CLEAR;
+  blitBitmap1(buffer, false, x, y, bitmap, w, h,
+              color ? GFX_BLIT_SET : GFX_BLIT_CLEAR, bgOp, progmem);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief   drawBitmap1() blits whenever the canvas has a buffer
+    @returns  True if the buffer is allocated
+*/
+/**************************************************************************/
+bool GFXcanvas1::canBlit1(void) const { return buffer != NULL; }
+
 /**************************************************************************/
 /*!
     @brief  Fill the framebuffer completely with one color
@@ -2127,6 +4162,31 @@ void GFXcanvas1::drawFastHLine(int16_t x, int16_t y, int16_t w,
   }
 }
 
+/**************************************************************************/
+/*!
+   @brief  Fill spans straight into the canvas buffer, as raw lines
+   @param  batch  Spans in rotated coordinates, already clipped
+*/
+/**************************************************************************/
+void GFXcanvas1::writeSpans(const GFXspanBatch *batch) {
+  int16_t x, y, w;
+  for (uint8_t i = 0; i < batch->count; i++) {
+    if (rawSpan(batch, i, &x, &y, &w))
+      drawFastRawVLine(x, y, w, batch->color);
+    else
+      drawFastRawHLine(x, y, w, batch->color);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  A byte holds eight pixels of a raw row, so in portrait rotations
+           round shapes are cheaper to fill as columns
+   @returns  true in rotations 1 and 3
+*/
+/**************************************************************************/
+bool GFXcanvas1::verticalSpans(void) const { return rotation & 1; }
+
 /**************************************************************************/
 /*!
    @brief    Speed optimized vertical line drawing into the raw canvas buffer
@@ -2183,15 +4243,14 @@ void GFXcanvas1::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
 
   // check to see if first byte needs to be partially filled
   if ((x & 7) > 0) {
-    // create bit mask for first byte
-    uint8_t startByteBitMask = 0x00;
-    for (int8_t i = (x & 7); ((i < 8) && (remainingWidthBits > 0)); i++) {
-#ifdef __AVR__
-      startByteBitMask |= pgm_read_byte(&GFXsetBit[i]);
-#else
-      startByteBitMask |= (0x80 >> i);
-#endif
-      remainingWidthBits--;
+    // bit mask for first byte: from bit (x & 7) up to the end of the
+    // line or of the byte, whichever comes first
+    uint8_t startByteBitMask = 0xFF >> (x & 7);
+    if ((x & 7) + remainingWidthBits < 8) {
+      startByteBitMask &= ~(0xFF >> ((x & 7) + remainingWidthBits));
+      remainingWidthBits = 0;
+    } else {
+      remainingWidthBits -= 8 - (x & 7);
     }
     if (color > 0) {
       *ptr |= startByteBitMask;
@@ -2211,14 +4270,7 @@ void GFXcanvas1::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
     memset(ptr, wholeByteColor, remainingWholeBytes);
 
     if (lastByteBits > 0) {
-      uint8_t lastByteBitMask = 0x00;
-      for (size_t i = 0; i < lastByteBits; i++) {
-#ifdef __AVR__
-        lastByteBitMask |= pgm_read_byte(&GFXsetBit[i]);
-#else
-        lastByteBitMask |= (0x80 >> i);
-#endif
-      }
+      uint8_t lastByteBitMask = ~(0xFF >> lastByteBits);
       ptr += remainingWholeBytes;
 
       if (color > 0) {
@@ -2297,6 +4349,42 @@ void GFXcanvas8::drawPixel(int16_t x, int16_t y, uint16_t color) {
   }
 }
 
+/**************************************************************************/
+/*!
+    @brief  Blend an 8-bit gray level into a canvas pixel by coverage
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  8-bit level to blend in. Only lower byte of uint16_t is
+                   used.
+    @param  alpha  Coverage, 0 (none) to 255 (full)
+*/
+/**************************************************************************/
+void GFXcanvas8::blendPixel(int16_t x, int16_t y, uint16_t color,
+                            uint8_t alpha) {
+  if (!buffer || (x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+
+  uint8_t *p = &buffer[x + y * WIDTH];
+  *p += (((int16_t)(color & 0xFF) - *p) * (alpha + (alpha >> 7)) + 128) >> 8;
+}
+
 /**********************************************************************/
 /*!
         @brief    Get the pixel color value at a given coordinate
@@ -2470,6 +4558,31 @@ void GFXcanvas8::drawFastHLine(int16_t x, int16_t y, int16_t w,
   }
 }
 
+/**************************************************************************/
+/*!
+   @brief  Fill spans straight into the canvas buffer, as raw lines
+   @param  batch  Spans in rotated coordinates, already clipped
+*/
+/**************************************************************************/
+void GFXcanvas8::writeSpans(const GFXspanBatch *batch) {
+  int16_t x, y, w;
+  for (uint8_t i = 0; i < batch->count; i++) {
+    if (rawSpan(batch, i, &x, &y, &w))
+      drawFastRawVLine(x, y, w, batch->color);
+    else
+      drawFastRawHLine(x, y, w, batch->color);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Raw rows are contiguous bytes, so in portrait rotations round
+           shapes are cheaper to fill as columns
+   @returns  true in rotations 1 and 3
+*/
+/**************************************************************************/
+bool GFXcanvas8::verticalSpans(void) const { return rotation & 1; }
+
 /**************************************************************************/
 /*!
    @brief    Speed optimized vertical line drawing into the raw canvas buffer
@@ -2506,6 +4619,97 @@ void GFXcanvas8::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
   memset(buffer + y * WIDTH + x, color, w);
 }
 
+// Mix two 5-6-5 colors, alpha 0-255 (used at 5 bits). Spreading the
+// pixel as 00000gggggg00000rrrrr000000bbbbb leaves room for all three
+// channel products in one multiply.
+static uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t alpha) {
+  uint32_t a = (alpha + 4) >> 3;
+  uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81FUL;
+  uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81FUL;
+  uint32_t m = (b + (((f - b) * a) >> 5)) & 0x07E0F81FUL;
+  return (uint16_t)(m | (m >> 16));
+}
+
+// 16-bit canvas kernels. Pixels are handled two per 32-bit word once the
+// pointers are word aligned; the word type may alias the uint16_t buffer.
+// These are plain loops that GCC unrolls on Xtensa and vectorizes on
+// desktop targets.
+#if !defined(__AVR__)
+typedef uint32_t __attribute__((__may_alias__)) gfx_word_t;
+#endif
+
+// Fill n 16-bit pixels, a 32-bit word at a time once aligned (memset
+// when both bytes match). Shared by canvas fills and span writes.
+static void fill16(uint16_t *dst, uint16_t color, uint32_t n) {
+  if ((color >> 8) == (color & 0xFF)) {
+    memset(dst, color & 0xFF, n * 2);
+    return;
+  }
+#if !defined(__AVR__)
+  if (((uintptr_t)dst & 2) && n) {
+    *dst++ = color;
+    n--;
+  }
+  gfx_word_t *dst32 = (gfx_word_t *)dst;
+  uint32_t color32 = color * 0x00010001UL;
+  for (uint32_t i = n / 2; i; i--)
+    *dst32++ = color32;
+  dst = (uint16_t *)dst32;
+  n &= 1;
+#endif
+  while (n--)
+    *dst++ = color;
+}
+
+// Copy n 16-bit pixels swapping the bytes of each; dst may equal src.
+// Xtensa and RISC-V ESP32 cores have neither a halfword byte-reverse nor
+// an auto-vectorizer, so there two pixels are swapped per 32-bit word when
+// source and destination share word alignment. Elsewhere the plain loop
+// is left to the compiler. GFX_SWAP16_WORDS overrides the choice.
+#ifndef GFX_SWAP16_WORDS
+#if defined(__XTENSA__) || defined(__riscv)
+#define GFX_SWAP16_WORDS 1
+#else
+#define GFX_SWAP16_WORDS 0
+#endif
+#endif
+
+static void swap16(uint16_t *dst, const uint16_t *src, uint32_t n) {
+#if GFX_SWAP16_WORDS
+  if (!(((uintptr_t)dst ^ (uintptr_t)src) & 2)) {
+    if (((uintptr_t)dst & 2) && n) {
+      *dst++ = __builtin_bswap16(*src++);
+      n--;
+    }
+    gfx_word_t *dst32 = (gfx_word_t *)dst;
+    const gfx_word_t *src32 = (const gfx_word_t *)src;
+    for (uint32_t i = n / 2; i; i--) {
+      uint32_t w = *src32++;
+      *dst32++ = ((w & 0x00FF00FFUL) << 8) | ((w >> 8) & 0x00FF00FFUL);
+    }
+    dst = (uint16_t *)dst32;
+    src = (const uint16_t *)src32;
+    n &= 1;
+  }
+#endif
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = __builtin_bswap16(src[i]);
+}
+
+// Blend n pixels of src into dst by the matching 8-bit alpha values.
+// Fully transparent and fully opaque pixels, the bulk of most masks,
+// skip the multiply.
+static void blend16(uint16_t *dst, const uint16_t *src, const uint8_t *alpha,
+                    uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t a = alpha[i];
+    if (a == 0xFF)
+      dst[i] = src[i];
+    else if (a)
+      dst[i] = blend565(src[i], dst[i], a);
+  }
+}
+
 /**************************************************************************/
 /*!
    @brief    Instatiate a GFX 16-bit canvas context for graphics
@@ -2574,6 +4778,41 @@ void GFXcanvas16::drawPixel(int16_t x, int16_t y, uint16_t color) {
   }
 }
 
+/**************************************************************************/
+/*!
+    @brief  Blend a color into a canvas pixel by coverage
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  16-bit 5-6-5 Color to blend in
+    @param  alpha  Coverage, 0 (none) to 255 (full)
+*/
+/**************************************************************************/
+void GFXcanvas16::blendPixel(int16_t x, int16_t y, uint16_t color,
+                             uint8_t alpha) {
+  if (!buffer || (x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+
+  uint16_t *p = &buffer[x + y * WIDTH];
+  *p = blend565(color, *p, alpha);
+}
+
 /**********************************************************************/
 /*!
         @brief    Get the pixel color value at a given coordinate
@@ -2622,6 +4861,224 @@ uint16_t GFXcanvas16::getRawPixel(int16_t x, int16_t y) const {
   return 0;
 }
 
+/**************************************************************************/
+/*!
+   @brief   Draw a RAM-resident 16-bit image (RGB 5/6/5), copying whole
+   clipped scanlines when the canvas is unrotated
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with 16-bit color bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+*/
+/**************************************************************************/
+void GFXcanvas16::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
+                                int16_t w, int16_t h) {
+  if (!buffer || rotation) {
+    Adafruit_GFX::drawRGBBitmap(x, y, bitmap, w, h);
+    return;
+  }
+
+  int16_t bx = max(0, -x), by = max(0, -y);
+  int16_t cw = min(w, WIDTH - x) - bx, ch = min(h, HEIGHT - y) - by;
+  if ((cw <= 0) || (ch <= 0))
+    return;
+
+  uint16_t *src = bitmap + (int32_t)by * w + bx;
+  uint16_t *dst = buffer + (int32_t)(y + by) * WIDTH + x + bx;
+  while (ch--) {
+    memcpy(dst, src, cw * 2);
+    src += w;
+    dst += WIDTH;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Fill a rectangle, a raw scanline at a time with word fills
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    w   Width in pixels (negative extends left)
+    @param    h   Height in pixels (negative extends up)
+    @param    color  16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void GFXcanvas16::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                           uint16_t color) {
+  if (!buffer)
+    return;
+  if (w < 0) {
+    w = -w;
+    x -= w - 1;
+  }
+  if (h < 0) {
+    h = -h;
+    y -= h - 1;
+  }
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > _width)
+    w = _width - x;
+  if (y + h > _height)
+    h = _height - y;
+  if ((w <= 0) || (h <= 0))
+    return;
+
+  int16_t t;
+  switch (rotation) { // Map to the same rectangle in raw coordinates
+  case 1:
+    t = x;
+    x = WIDTH - y - h;
+    y = t;
+    _swap_int16_t(w, h);
+    break;
+  case 2:
+    x = WIDTH - x - w;
+    y = HEIGHT - y - h;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - t - w;
+    _swap_int16_t(w, h);
+    break;
+  }
+  uint16_t *dst = buffer + (int32_t)y * WIDTH + x;
+  while (h--) {
+    fill16(dst, color, w);
+    dst += WIDTH;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Copy a rectangle from another 16-bit canvas (or this one, for
+            scrolling; overlapping areas are handled). The rectangle is
+            clipped to both canvases. Whole scanlines are moved when
+            neither canvas is rotated.
+    @param    x    Destination top left corner x coordinate
+    @param    y    Destination top left corner y coordinate
+    @param    src  Canvas to copy from
+    @param    sx   Source top left corner x coordinate
+    @param    sy   Source top left corner y coordinate
+    @param    w    Width in pixels
+    @param    h    Height in pixels
+*/
+/**************************************************************************/
+void GFXcanvas16::copyRect(int16_t x, int16_t y, const GFXcanvas16 *src,
+                           int16_t sx, int16_t sy, int16_t w, int16_t h) {
+  if (!buffer || !src || !src->buffer)
+    return;
+  // Clip against the source, then the destination
+  int16_t d = max(max(0, -sx), -x);
+  x += d;
+  sx += d;
+  w -= d;
+  d = max(max(0, -sy), -y);
+  y += d;
+  sy += d;
+  h -= d;
+  w = min(w, (int16_t)min(src->width() - sx, _width - x));
+  h = min(h, (int16_t)min(src->height() - sy, _height - y));
+  if ((w <= 0) || (h <= 0))
+    return;
+
+  // Walk backwards if the destination overlaps further down the buffer
+  bool back = (src == this) && ((y > sy) || ((y == sy) && (x > sx)));
+  if (!rotation && !src->rotation) {
+    int16_t step = back ? -1 : 1, row = back ? h - 1 : 0;
+    for (int16_t n = 0; n < h; n++, row += step)
+      memmove(buffer + (int32_t)(y + row) * WIDTH + x,
+              src->buffer + (int32_t)(sy + row) * src->WIDTH + sx, w * 2);
+    return;
+  }
+  for (int16_t n = 0; n < h; n++) {
+    int16_t row = back ? h - 1 - n : n;
+    for (int16_t m = 0; m < w; m++) {
+      int16_t col = back ? w - 1 - m : m;
+      drawPixel(x + col, y + row, src->getPixel(sx + col, sy + row));
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Blend a RAM-resident 16-bit image (RGB 5/6/5) into the canvas
+            through a matching 8-bit alpha mask (0 = keep the canvas,
+            255 = take the image), e.g. anti-aliased glyphs or sprites.
+    @param    x       Top left corner x coordinate
+    @param    y       Top left corner y coordinate
+    @param    bitmap  16-bit color bitmap, w * h pixels
+    @param    alpha   8-bit alpha mask, w * h values
+    @param    w       Width of bitmap in pixels
+    @param    h       Height of bitmap in pixels
+*/
+/**************************************************************************/
+void GFXcanvas16::blendRGBBitmap(int16_t x, int16_t y, const uint16_t *bitmap,
+                                 const uint8_t *alpha, int16_t w, int16_t h) {
+  if (!buffer)
+    return;
+  int16_t bx = max(0, -x), by = max(0, -y);
+  int16_t cw = min(w, _width - x) - bx, ch = min(h, _height - y) - by;
+  if ((cw <= 0) || (ch <= 0))
+    return;
+
+  int32_t offset = (int32_t)by * w + bx;
+  if (!rotation) {
+    uint16_t *dst = buffer + (int32_t)(y + by) * WIDTH + x + bx;
+    while (ch--) {
+      blend16(dst, bitmap + offset, alpha + offset, cw);
+      offset += w;
+      dst += WIDTH;
+    }
+    return;
+  }
+  for (int16_t j = 0; j < ch; j++, offset += w) {
+    for (int16_t i = 0; i < cw; i++) {
+      uint8_t a = alpha[offset + i];
+      if (a)
+        blendPixel(x + bx + i, y + by + j, bitmap[offset + i], a);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Copy a rectangle of the raw (unrotated) buffer out to memory
+            with each pixel byte-swapped, ready for DMA to a big-endian
+            display, leaving the canvas itself untouched.
+    @param    x     Raw top left corner x coordinate
+    @param    y     Raw top left corner y coordinate
+    @param    w     Width in pixels
+    @param    h     Height in pixels
+    @param    dest  Destination, w * h pixels, scanlines packed
+    @returns  false if the rectangle doesn't lie within the canvas
+*/
+/**************************************************************************/
+bool GFXcanvas16::copyRectSwapped(int16_t x, int16_t y, int16_t w, int16_t h,
+                                  uint16_t *dest) const {
+  if (!buffer || (x < 0) || (y < 0) || (w <= 0) || (h <= 0) ||
+      (x + w > WIDTH) || (y + h > HEIGHT))
+    return false;
+  const uint16_t *src = buffer + (int32_t)y * WIDTH + x;
+  if (w == WIDTH) {
+    swap16(dest, src, (uint32_t)w * h);
+    return true;
+  }
+  while (h--) {
+    swap16(dest, src, w);
+    src += WIDTH;
+    dest += w;
+  }
+  return true;
+}
+
 /**************************************************************************/
 /*!
     @brief  Fill the framebuffer completely with one color
@@ -2630,14 +5087,7 @@ uint16_t GFXcanvas16::getRawPixel(int16_t x, int16_t y) const {
 /**************************************************************************/
 void GFXcanvas16::fillScreen(uint16_t color) {
   if (buffer) {
-    uint8_t hi = color >> 8, lo = color & 0xFF;
-    if (hi == lo) {
-      memset(buffer, lo, WIDTH * HEIGHT * 2);
-    } else {
-      uint32_t i, pixels = WIDTH * HEIGHT;
-      for (i = 0; i < pixels; i++)
-        buffer[i] = color;
-    }
+    fill16(buffer, color, (uint32_t)WIDTH * HEIGHT);
   }
 }
 
@@ -2656,9 +5106,7 @@ void GFXcanvas16::fillScreen(uint16_t color) {
 /**************************************************************************/
 void GFXcanvas16::byteSwap(void) {
   if (buffer) {
-    uint32_t i, pixels = WIDTH * HEIGHT;
-    for (i = 0; i < pixels; i++)
-      buffer[i] = __builtin_bswap16(buffer[i]);
+    swap16(buffer, buffer, (uint32_t)WIDTH * HEIGHT);
   }
 }
 
@@ -2772,6 +5220,31 @@ void GFXcanvas16::drawFastHLine(int16_t x, int16_t y, int16_t w,
   }
 }
 
+/**************************************************************************/
+/*!
+   @brief  Fill spans straight into the canvas buffer, as raw lines
+   @param  batch  Spans in rotated coordinates, already clipped
+*/
+/**************************************************************************/
+void GFXcanvas16::writeSpans(const GFXspanBatch *batch) {
+  int16_t x, y, w;
+  for (uint8_t i = 0; i < batch->count; i++) {
+    if (rawSpan(batch, i, &x, &y, &w))
+      drawFastRawVLine(x, y, w, batch->color);
+    else
+      drawFastRawHLine(x, y, w, batch->color);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Raw rows are contiguous 16-bit pixels, so in portrait rotations
+           round shapes are cheaper to fill as columns
+   @returns  true in rotations 1 and 3
+*/
+/**************************************************************************/
+bool GFXcanvas16::verticalSpans(void) const { return rotation & 1; }
+
 /**************************************************************************/
 /*!
    @brief    Speed optimized vertical line drawing into the raw canvas buffer
@@ -2803,8 +5276,5 @@ void GFXcanvas16::drawFastRawVLine(int16_t x, int16_t y, int16_t h,
 void GFXcanvas16::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
                                    uint16_t color) {
   // x & y already in raw (rotation 0) coordinates, no need to transform.
-  uint32_t buffer_index = y * WIDTH + x;
-  for (uint32_t i = buffer_index; i < buffer_index + w; i++) {
-    buffer[i] = color;
-  }
+  fill16(buffer + y * WIDTH + x, color, w);
 }
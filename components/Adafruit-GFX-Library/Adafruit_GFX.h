@@ -12,6 +12,52 @@
 #include <Adafruit_I2CDevice.h>
 #include <Adafruit_SPIDevice.h>
 
+// Raster operations for blitBitmap1() on 1-bit framebuffers
+#define GFX_BLIT_NONE 0   ///< Leave destination bits untouched
+#define GFX_BLIT_CLEAR 1  ///< Clear destination bits
+#define GFX_BLIT_SET 2    ///< Set destination bits
+#define GFX_BLIT_INVERT 3 ///< Toggle destination bits
+
+#ifndef GFX_GLYPH_BLIT_MAX
+#define GFX_GLYPH_BLIT_MAX 32 ///< Stack bytes for blitting glyphs a band at a time
+#endif
+
+#define GFX_TEXT_CACHE_ENTRIES 8 ///< Strings remembered per GFXtextCache
+#define GFX_TEXT_CACHE_CHARS 24  ///< Longest string a GFXtextCache remembers
+#define GFX_FIELD_MAX_CHARS 16   ///< Widest Adafruit_GFX_NumericField
+#ifdef __AVR__
+#define GFX_SPAN_BATCH 8 ///< Spans collected before writeSpans() is called
+#else
+#define GFX_SPAN_BATCH 32 ///< Spans collected before writeSpans() is called
+#endif
+#ifdef __AVR__
+#define GFX_DLIST_BYTES 256 ///< Default GFXdisplayList capacity
+#else
+#define GFX_DLIST_BYTES 4096 ///< Default GFXdisplayList capacity
+#endif
+
+/// One run of pixels, already clipped to the display. In a vertical
+/// batch y is the column and x1..x2 the rows it covers.
+typedef struct {
+  int16_t y;  ///< Scanline, in rotated coordinates
+  int16_t x1; ///< First pixel
+  int16_t x2; ///< Last pixel, inclusive (x2 >= x1)
+} GFXspan;
+
+/// Spans collected while filling one primitive
+typedef struct {
+  GFXspan span[GFX_SPAN_BATCH]; ///< Pending spans
+  uint8_t count;                ///< Number of pending spans
+  bool clip;                    ///< If set, spans still need clipping
+  bool vertical;                ///< If set, spans are columns
+  uint16_t color;               ///< Fill color of the primitive
+} GFXspanBatch;
+
+class GFXtextCache;
+class GFXdisplayList;
+class GFXcanvas1;
+class GFXcanvas16;
+
 /// A generic graphics superclass that can handle all sorts of drawing. At a
 /// minimum you can subclass and provide drawPixel(). At a maximum you can do a
 /// ton of overriding to optimize. Used for any/all Adafruit displays!
@@ -85,6 +131,11 @@ public:
                      int16_t radius, uint16_t color);
   void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
                      int16_t radius, uint16_t color);
+  void drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                  uint16_t color);
+  void drawCircleAA(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void drawArcAA(int16_t x0, int16_t y0, int16_t r, int16_t start,
+                 int16_t end, uint16_t color);
   void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
                   int16_t h, uint16_t color);
   void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
@@ -105,8 +156,8 @@ public:
                            int16_t w, int16_t h);
   void drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w,
                      int16_t h);
-  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w,
-                     int16_t h);
+  virtual void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
+                             int16_t w, int16_t h);
   void drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[],
                      const uint8_t mask[], int16_t w, int16_t h);
   void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, uint8_t *mask,
@@ -121,6 +172,7 @@ public:
                      int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
   void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1,
                      int16_t *y1, uint16_t *w, uint16_t *h);
+  int16_t drawText(int16_t x, int16_t y, const char *str);
   void setTextSize(uint8_t s);
   void setTextSize(uint8_t sx, uint8_t sy);
   void setFont(const GFXfont *f = NULL);
@@ -168,6 +220,16 @@ public:
   /**********************************************************************/
   void setTextWrap(bool w) { wrap = w; }
 
+  /**********************************************************************/
+  /*!
+    @brief  Attach a cache for getTextBounds() results. Only used for
+            custom fonts while text wrap is off and the string has no
+            newline, since bounds then depend on where the string starts.
+    @param  cache  The cache to use, or NULL to always measure
+  */
+  /**********************************************************************/
+  void setTextCache(GFXtextCache *cache) { textCache = cache; }
+
   /**********************************************************************/
   /*!
     @brief  Enable (or disable) Code Page 437-compatible charset.
@@ -236,6 +298,30 @@ public:
 protected:
   void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx,
                   int16_t *miny, int16_t *maxx, int16_t *maxy);
+  virtual void writeSpans(const GFXspanBatch *batch);
+  virtual void blendPixel(int16_t x, int16_t y, uint16_t color,
+                          uint8_t alpha);
+  void circleAA(int16_t x0, int16_t y0, int16_t r, uint16_t color,
+                uint8_t mode, int16_t sx, int16_t sy, int16_t ex, int16_t ey);
+  virtual bool verticalSpans(void) const;
+  bool beginSpans(GFXspanBatch *batch, int16_t x1, int16_t y1, int16_t x2,
+                  int16_t y2, uint16_t color, bool transpose = false);
+  void addSpan(GFXspanBatch *batch, int16_t y, int16_t x1, int16_t x2);
+  void endSpans(GFXspanBatch *batch);
+  bool rawSpan(const GFXspanBatch *batch, uint8_t i, int16_t *x, int16_t *y,
+               int16_t *len) const;
+  void roundSpans(GFXspanBatch *batch, int16_t xl, int16_t yt, int16_t xr,
+                  int16_t yb, int16_t r, uint8_t corners);
+  virtual bool drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap,
+                           int16_t w, int16_t h, uint16_t color, uint16_t bg,
+                           bool opaque, bool progmem);
+  virtual bool canBlit1(void) const;
+  void drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph,
+                 const uint8_t *bitmap, uint16_t color, uint8_t size_x,
+                 uint8_t size_y);
+  bool blitBitmap1(uint8_t *buf, bool pageMajor, int16_t x, int16_t y,
+                   const uint8_t *bitmap, int16_t w, int16_t h, uint8_t fgOp,
+                   uint8_t bgOp, bool progmem, int16_t *bounds = NULL);
   int16_t WIDTH;        ///< This is the 'raw' display width - never changes
   int16_t HEIGHT;       ///< This is the 'raw' display height - never changes
   int16_t _width;       ///< Display width as modified by current rotation
@@ -250,6 +336,10 @@ protected:
   bool wrap;            ///< If set, 'wrap' text at right edge of display
   bool _cp437;          ///< If set, use correct CP437 charset (default is off)
   GFXfont *gfxFont;     ///< Pointer to special font
+
+  GFXtextCache *textCache; ///< Optional getTextBounds() cache
+
+  friend class GFXdisplayList; ///< Replays spans and blends onto any target
 };
 
 /// A simple drawn button UI element
@@ -310,6 +400,139 @@ private:
   bool currstate, laststate;
 };
 
+/// A fixed-width numeric readout drawn from a pre-rendered glyph atlas,
+/// redrawing only the character cells that change
+class Adafruit_GFX_NumericField {
+
+public:
+  Adafruit_GFX_NumericField(void);
+  ~Adafruit_GFX_NumericField(void);
+  bool begin(Adafruit_GFX *gfx, const GFXfont *font, int16_t x, int16_t y,
+             uint8_t chars, uint16_t color, uint16_t bg, uint8_t depth = 1);
+  void end(void);
+  void print(const char *text);
+  void print(long value);
+  void print(double value, uint8_t decimals);
+  void invalidate(void);
+
+  /**********************************************************************/
+  /*!
+    @brief    Get the width of the whole field
+    @returns  Width in pixels
+  */
+  /**********************************************************************/
+  int16_t width(void) const { return _cellW * _chars; }
+
+  /**********************************************************************/
+  /*!
+    @brief    Get the height of the field
+    @returns  Height in pixels
+  */
+  /**********************************************************************/
+  int16_t height(void) const { return _cellH; }
+
+private:
+  void printNumber(unsigned long v, bool neg, uint8_t decimals);
+  void drawCell(uint8_t cell, uint8_t glyph);
+
+  Adafruit_GFX *_gfx;
+  GFXcanvas1 *_atlas1;   // Cells stacked vertically, 1 bit per pixel
+  GFXcanvas16 *_atlas16; // Same, RGB 5/6/5
+  int16_t _x, _y;        // Top-left corner of the field
+  int16_t _cellW, _cellH;
+  uint16_t _color, _bg;
+  uint8_t _chars;
+  uint8_t _shown[GFX_FIELD_MAX_CHARS]; // Atlas index per cell, 0xFF = unknown
+};
+
+/// Remembers getTextBounds() results for recently measured GFXfont strings
+class GFXtextCache {
+public:
+  GFXtextCache(void);
+  bool lookup(const GFXfont *font, uint8_t size_x, uint8_t size_y,
+              const char *str, int16_t *dx, int16_t *dy, uint16_t *w,
+              uint16_t *h);
+  void store(const GFXfont *font, uint8_t size_x, uint8_t size_y,
+             const char *str, int16_t dx, int16_t dy, uint16_t w, uint16_t h);
+  void clear(void);
+
+  uint32_t hits;   ///< Lookups answered from the cache
+  uint32_t misses; ///< Lookups that had to measure the string
+
+private:
+  struct Entry {
+    const GFXfont *font;
+    uint8_t size_x, size_y;
+    uint16_t hash;
+    int16_t dx, dy;
+    uint16_t w, h;
+    char text[GFX_TEXT_CACHE_CHARS + 1];
+  } entry[GFX_TEXT_CACHE_ENTRIES];
+  uint8_t next; // Round-robin replacement slot
+};
+
+/// A GFX target that records drawing into a compact display list rather
+/// than pixels, to be replayed later onto another GFX target
+class GFXdisplayList : public Adafruit_GFX {
+public:
+  GFXdisplayList(uint16_t w, uint16_t h, uint16_t bytes = GFX_DLIST_BYTES);
+  ~GFXdisplayList(void);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                 uint16_t color);
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w,
+                     int16_t h);
+  void clear(void);
+  void replay(Adafruit_GFX *gfx, int16_t x = 0, int16_t y = 0) const;
+  void replay(Adafruit_GFX *gfx, int16_t x, int16_t y, int16_t cx, int16_t cy,
+              int16_t cw, int16_t ch) const;
+  bool diff(const GFXdisplayList *prev, int16_t *x1, int16_t *y1, uint16_t *w,
+            uint16_t *h) const;
+
+  /**********************************************************************/
+  /*!
+    @brief    Get the number of bytes recorded so far
+    @returns  Display list length in bytes
+  */
+  /**********************************************************************/
+  uint16_t size(void) const { return _used; }
+
+  /**********************************************************************/
+  /*!
+    @brief    Check whether drawing was lost because the list filled up
+    @returns  true if anything was dropped since the last clear()
+  */
+  /**********************************************************************/
+  bool overflowed(void) const { return _overflow; }
+
+protected:
+  void writeSpans(const GFXspanBatch *batch);
+  void blendPixel(int16_t x, int16_t y, uint16_t color, uint8_t alpha);
+  bool drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                   int16_t h, uint16_t color, uint16_t bg, bool opaque,
+                   bool progmem);
+  bool canBlit1(void) const;
+  virtual bool full(uint32_t need);
+  bool grow(uint32_t need);
+
+private:
+  uint8_t *add(uint8_t op, const int16_t *args, uint8_t n, uint16_t extra = 0);
+  uint16_t decode(uint16_t i, int16_t *a, int16_t *box) const;
+  bool same(uint16_t i, const GFXdisplayList *o, uint16_t j) const;
+  void render(Adafruit_GFX *gfx, int16_t x, int16_t y, int16_t l, int16_t t,
+              int16_t r, int16_t b, bool exact) const;
+
+  uint8_t *_list;    // Recorded operations, back to back
+  uint16_t _bytes;   // Capacity of _list
+  uint16_t _used;    // Bytes recorded
+  uint16_t _last;    // Offset of the most recent operation, for merging
+  bool _overflow;    // Set if an operation didn't fit
+};
+
 /// A GFX 1-bit canvas context for graphics
 class GFXcanvas1 : public Adafruit_GFX {
 public:
@@ -332,6 +555,12 @@ protected:
   bool getRawPixel(int16_t x, int16_t y) const;
   void drawFastRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void drawFastRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void writeSpans(const GFXspanBatch *batch);
+  bool verticalSpans(void) const;
+  bool drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                   int16_t h, uint16_t color, uint16_t bg, bool opaque,
+                   bool progmem);
+  bool canBlit1(void) const;
   uint8_t *buffer;   ///< Raster data: no longer private, allow subclass access
   bool buffer_owned; ///< If true, destructor will free buffer, else it will do
                      ///< nothing
@@ -365,6 +594,9 @@ protected:
   uint8_t getRawPixel(int16_t x, int16_t y) const;
   void drawFastRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void drawFastRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void blendPixel(int16_t x, int16_t y, uint16_t color, uint8_t alpha);
+  void writeSpans(const GFXspanBatch *batch);
+  bool verticalSpans(void) const;
   uint8_t *buffer;   ///< Raster data: no longer private, allow subclass access
   bool buffer_owned; ///< If true, destructor will free buffer, else it will do
                      ///< nothing
@@ -380,6 +612,16 @@ public:
   void byteSwap(void);
   void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w,
+                     int16_t h);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void copyRect(int16_t x, int16_t y, const GFXcanvas16 *src, int16_t sx,
+                int16_t sy, int16_t w, int16_t h);
+  void blendRGBBitmap(int16_t x, int16_t y, const uint16_t *bitmap,
+                      const uint8_t *alpha, int16_t w, int16_t h);
+  bool copyRectSwapped(int16_t x, int16_t y, int16_t w, int16_t h,
+                       uint16_t *dest) const;
   uint16_t getPixel(int16_t x, int16_t y) const;
   /**********************************************************************/
   /*!
@@ -393,6 +635,9 @@ protected:
   uint16_t getRawPixel(int16_t x, int16_t y) const;
   void drawFastRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void drawFastRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void blendPixel(int16_t x, int16_t y, uint16_t color, uint8_t alpha);
+  void writeSpans(const GFXspanBatch *batch);
+  bool verticalSpans(void) const;
   uint16_t *buffer;  ///< Raster data: no longer private, allow subclass access
   bool buffer_owned; ///< If true, destructor will free buffer, else it will do
                      ///< nothing
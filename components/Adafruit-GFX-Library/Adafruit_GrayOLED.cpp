@@ -199,6 +199,106 @@ bool Adafruit_GrayOLED::oled_commandList(const uint8_t *c, uint8_t n) {
   return true;
 }
 
+/*!
+    @brief Stream display data bytes to the OLED, using I2C or hard/soft SPI
+   as needed. I2C writes are split to fit the Wire buffer.
+    @param d Pointer to the data bytes
+    @param n The number of data bytes
+    @returns True for success on ability to write the data.
+    @note Virtual, along with oled_commandList(), so a subclass can route
+   or count the bus traffic of displayWindow() (e.g. on a host).
+*/
+bool Adafruit_GrayOLED::oled_data(const uint8_t *d, size_t n) {
+  if (i2c_dev) {            // I2C
+    uint8_t dc_byte = 0x40; // Co = 0, D/C = 1
+    size_t maxbuff = i2c_dev->maxBufferSize() - 1;
+    while (n) {
+      size_t to_write = min(n, maxbuff);
+      if (!i2c_dev->write((uint8_t *)d, to_write, true, &dc_byte, 1)) {
+        return false;
+      }
+      d += to_write;
+      n -= to_write;
+    }
+  } else { // SPI -- transaction started in calling function
+    digitalWrite(dcPin, HIGH);
+    if (!spi_dev->write((uint8_t *)d, n)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+    @brief  Send only the dirty window of the buffer to the display, then
+            mark the window clean. For subclasses' display(), on controllers
+            with column and row address commands that take a start and an
+            end address (e.g. SSD1327: 0x15, 0x75).
+    @param  colCmd
+            Set column address command.
+    @param  rowCmd
+            Set row address command.
+    @param  colOffset
+            Added to column addresses, for panels that do not start at
+            column 0 of the controller's RAM.
+    @param  rowOffset
+            Added to row addresses, likewise.
+    @return true on success (or nothing to send), false on a bus error.
+    @note   With 4 bits per pixel, one column address is one buffer byte (a
+            pixel pair), so the window is widened to even/odd x bounds and
+            rows are pixel rows. With 1 bit per pixel, columns are pixels and
+            the window is widened to whole 8-row pages, which are then the
+            row addresses. Each window row is a contiguous run of the buffer,
+            and the whole window is one run when it spans the full width.
+*/
+bool Adafruit_GrayOLED::displayWindow(uint8_t colCmd, uint8_t rowCmd,
+                                      uint8_t colOffset, uint8_t rowOffset) {
+  int16_t x1 = max(window_x1, (int16_t)0), y1 = max(window_y1, (int16_t)0);
+  int16_t x2 = min(window_x2, (int16_t)(WIDTH - 1));
+  int16_t y2 = min(window_y2, (int16_t)(HEIGHT - 1));
+  if ((x1 > x2) || (y1 > y2))
+    return true; // Clean
+
+  uint16_t pitch; // Buffer bytes per address row
+  if (_bpp == 4) {
+    x1 /= 2; // Columns are pixel pairs
+    x2 /= 2;
+    pitch = WIDTH / 2;
+  } else {
+    y1 /= 8; // Rows are pages
+    y2 /= 8;
+    pitch = WIDTH;
+  }
+
+  uint8_t cmd[] = {colCmd,
+                   (uint8_t)(x1 + colOffset),
+                   (uint8_t)(x2 + colOffset),
+                   rowCmd,
+                   (uint8_t)(y1 + rowOffset),
+                   (uint8_t)(y2 + rowOffset)};
+  if (!oled_commandList(cmd, sizeof(cmd)))
+    return false;
+
+  size_t run = x2 - x1 + 1;
+  uint16_t rows = y2 - y1 + 1;
+  if (run == pitch) { // Full width: one contiguous run
+    run *= rows;
+    rows = 1;
+  }
+  const uint8_t *ptr = buffer + y1 * pitch + x1;
+  for (; rows; rows--, ptr += pitch) {
+    yield();
+    if (!oled_data(ptr, run))
+      return false;
+  }
+
+  window_x1 = 1024; // Clean
+  window_y1 = 1024;
+  window_x2 = -1;
+  window_y2 = -1;
+  return true;
+}
+
 // ALLOCATE & INIT DISPLAY -------------------------------------------------
 
 /*!
@@ -335,6 +435,58 @@ void Adafruit_GrayOLED::drawPixel(int16_t x, int16_t y, uint16_t color) {
   }
 }
 
+/*!
+    @brief  Blend a gray level into one pixel by coverage, for the
+            anti-aliased primitives. On 4-bit displays the new nibble is
+            mixed with the old one; 1-bit displays just draw the pixel if
+            it is at least half covered.
+    @param  x
+            Column of display -- 0 at left to (screen width - 1) at right.
+    @param  y
+            Row of display -- 0 at top to (screen height -1) at bottom.
+    @param  color
+            Gray level to blend in, 0 to 15 (or a MONOOLED_ color on
+            1-bit displays).
+    @param  alpha
+            Coverage, 0 (none) to 255 (full).
+    @note   Changes buffer contents only, no immediate effect on display.
+*/
+void Adafruit_GrayOLED::blendPixel(int16_t x, int16_t y, uint16_t color,
+                                   uint8_t alpha) {
+  if (_bpp != 4) {
+    if (alpha >= 128)
+      drawPixel(x, y, color);
+    return;
+  }
+  if ((x >= 0) && (x < width()) && (y >= 0) && (y < height())) {
+    switch (getRotation()) {
+    case 1:
+      grayoled_swap(x, y);
+      x = WIDTH - x - 1;
+      break;
+    case 2:
+      x = WIDTH - x - 1;
+      y = HEIGHT - y - 1;
+      break;
+    case 3:
+      grayoled_swap(x, y);
+      y = HEIGHT - y - 1;
+      break;
+    }
+
+    window_x1 = min(window_x1, x);
+    window_y1 = min(window_y1, y);
+    window_x2 = max(window_x2, x);
+    window_y2 = max(window_y2, y);
+
+    uint8_t *pixelptr = &buffer[x / 2 + (y * WIDTH / 2)];
+    uint8_t shift = (x % 2 == 0) ? 4 : 0; // even x is the left (high) nibble
+    int16_t old = (pixelptr[0] >> shift) & 0xF;
+    old += (((int16_t)(color & 0xF) - old) * (alpha + (alpha >> 7)) + 128) >> 8;
+    pixelptr[0] = (pixelptr[0] & ~(0xF << shift)) | (old << shift);
+  }
+}
+
 /*!
     @brief  Clear contents of display buffer (set all pixels to off).
     @note   Changes buffer contents only, no immediate effect on display.
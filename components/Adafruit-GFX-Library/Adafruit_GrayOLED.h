@@ -72,10 +72,14 @@ public:
   uint8_t *getBuffer(void);
 
   void oled_command(uint8_t c);
-  bool oled_commandList(const uint8_t *c, uint8_t n);
+  virtual bool oled_commandList(const uint8_t *c, uint8_t n);
+  virtual bool oled_data(const uint8_t *d, size_t n);
 
 protected:
   bool _init(uint8_t i2caddr = 0x3C, bool reset = true);
+  bool displayWindow(uint8_t colCmd, uint8_t rowCmd, uint8_t colOffset = 0,
+                     uint8_t rowOffset = 0);
+  void blendPixel(int16_t x, int16_t y, uint16_t color, uint8_t alpha);
 
   Adafruit_SPIDevice *spi_dev = NULL; ///< The SPI interface BusIO device
   Adafruit_I2CDevice *i2c_dev = NULL; ///< The I2C interface BusIO device
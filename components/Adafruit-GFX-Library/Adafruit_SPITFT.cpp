@@ -100,6 +100,15 @@ static const struct {
 
 #endif // end USE_SPI_DMA
 
+#if defined(USE_SPI_DMA) && defined(ESP32)
+#include <esp_heap_caps.h>
+#if __has_include(<esp_memory_utils.h>)
+#include <esp_memory_utils.h> // esp_ptr_dma_capable(), ESP-IDF 5
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+#endif
+
 // Possible values for Adafruit_SPITFT.connection:
 #define TFT_HARD_SPI 0 ///< Display interface = hardware SPI
 #define TFT_SOFT_SPI 1 ///< Display interface = software SPI
@@ -592,6 +601,9 @@ void Adafruit_SPITFT::initSPI(uint32_t freq, uint8_t spiMode) {
     ) {
       hwspi._spi->begin();
     }
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    espInit(freq); // Falls back to SPIClass on failure
+#endif
   } else if (connection == TFT_SOFT_SPI) {
 
     pinMode(swspi._mosi, OUTPUT);
@@ -910,6 +922,14 @@ void Adafruit_SPITFT::setSPISpeed(uint32_t freq) {
 #else
   hwspi._freq = freq; // Save freq value for later
 #endif
+#if defined(USE_SPI_DMA) && defined(ESP32)
+  if (espDev) { // Clock is fixed per IDF device; re-add it at the new speed
+    dmaWait();
+    spi_bus_remove_device(espDev);
+    espDev = NULL;
+    espAddDevice(freq);
+  }
+#endif
 }
 
 /*!
@@ -1013,6 +1033,14 @@ void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block,
 
 #if defined(ESP32)
   if (connection == TFT_HARD_SPI) {
+#if defined(USE_SPI_DMA)
+    if (espDev) {
+      espPixels(colors, len, bigEndian);
+      if (block)
+        dmaWait();
+      return;
+    }
+#endif
     if (!bigEndian) {
       hwspi._spi->writePixels(colors, len * 2); // Inbuilt endian-swap
     } else {
@@ -1175,6 +1203,10 @@ void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block,
             was used (as is the default case).
 */
 void Adafruit_SPITFT::dmaWait(void) {
+#if defined(USE_SPI_DMA) && defined(ESP32)
+  if (espQueued)
+    espReap(0, true);
+#endif
 #if defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
   while (dma_busy)
     ;
@@ -1195,13 +1227,216 @@ void Adafruit_SPITFT::dmaWait(void) {
     @return true if DMA is enabled and transmitting data, false otherwise.
 */
 bool Adafruit_SPITFT::dmaBusy(void) const {
-#if defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
+#if defined(USE_SPI_DMA) && defined(ESP32)
+  if (espQueued)
+    espReap(0, false);
+  return espQueued;
+#elif defined(USE_SPI_DMA) &&                                                  \
+    (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
   return dma_busy;
 #else
   return false;
 #endif
 }
 
+#if defined(USE_SPI_DMA) && defined(ESP32)
+// ESP32 DMA: SPIClass has no DMA path, so once the bus is up espInit()
+// takes it over with the ESP-IDF SPI master driver. Pixel data is queued
+// as DMA transfers, in place when it's already big-endian and in DMA-
+// capable RAM, else byte-swapped through two ping-pong buffers so one
+// fills while the other is on the wire. Commands and other short writes
+// are polling transfers. Chip-select remains a GPIO, as for SPIClass.
+
+/*!
+    @brief  Move the display's SPI bus from SPIClass to the ESP-IDF SPI
+            master driver, on the same pins. If anything fails the display
+            stays on SPIClass.
+    @param  freq  SPI clock frequency
+    @return true if the display now uses DMA
+*/
+bool Adafruit_SPITFT::espInit(uint32_t freq) {
+  int8_t sck = hwspi._spi->pinSCK(), miso = hwspi._spi->pinMISO(),
+         mosi = hwspi._spi->pinMOSI();
+  if ((sck < 0) || (mosi < 0))
+    return false;
+#if CONFIG_IDF_TARGET_ESP32
+  espHost = (hwspi._spi == &SPI) ? SPI3_HOST : SPI2_HOST; // VSPI : HSPI
+#elif SOC_SPI_PERIPH_NUM >= 3
+  espHost = (hwspi._spi == &SPI) ? SPI2_HOST : SPI3_HOST; // FSPI : HSPI
+#else
+  espHost = SPI2_HOST;
+#endif
+
+  for (uint8_t i = 0; i < 2; i++) {
+    pixelBuf[i] = (uint16_t *)heap_caps_malloc(SPITFT_ESP32_DMA_PIXELS * 2,
+                                               MALLOC_CAP_DMA);
+  }
+  if (pixelBuf[0] && pixelBuf[1]) {
+    spi_bus_config_t bus;
+    memset(&bus, 0, sizeof(bus));
+    bus.mosi_io_num = mosi;
+    bus.miso_io_num = miso;
+    bus.sclk_io_num = sck;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = SPITFT_ESP32_DMA_MAX;
+    hwspi._spi->end(); // Release the pins and peripheral
+    if (spi_bus_initialize(espHost, &bus, SPI_DMA_CH_AUTO) == ESP_OK) {
+      if (espAddDevice(freq))
+        return true;
+      spi_bus_free(espHost);
+    }
+    hwspi._spi->begin(sck, miso, mosi);
+  }
+  for (uint8_t i = 0; i < 2; i++) {
+    heap_caps_free(pixelBuf[i]); // NULL is OK
+    pixelBuf[i] = NULL;
+  }
+  return false;
+}
+
+/*!
+    @brief  Attach the display to the IDF SPI bus
+    @param  freq  SPI clock frequency
+    @return true on success
+*/
+bool Adafruit_SPITFT::espAddDevice(uint32_t freq) {
+  spi_device_interface_config_t cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.clock_speed_hz = freq;
+  cfg.mode = hwspi._mode; // SPI_MODEn are 0-3 on ESP32
+  cfg.spics_io_num = -1;  // CS is driven by startWrite()/endWrite()
+  cfg.queue_size = SPITFT_ESP32_DMA_QUEUE;
+  return spi_bus_add_device(espHost, &cfg, &espDev) == ESP_OK;
+}
+
+/*!
+    @brief  Issue 1 to 4 bytes, most significant first, and wait for them
+    @param  data   Value to write
+    @param  bytes  Number of low-order bytes of data to write
+*/
+void Adafruit_SPITFT::espWrite(uint32_t data, uint8_t bytes) {
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.length = bytes * 8;
+  for (uint8_t i = 0; i < bytes; i++)
+    t.tx_data[i] = data >> ((bytes - 1 - i) * 8);
+  dmaWait(); // Polling transfers can't overtake queued ones
+  spi_device_polling_transmit(espDev, &t);
+}
+
+/*!
+    @brief  Collect finished DMA transfers
+    @param  keep   Return once no more than this many are in flight
+    @param  block  If false, only collect those already finished
+*/
+void Adafruit_SPITFT::espReap(uint8_t keep, bool block) const {
+  spi_transaction_t *t;
+  while ((espQueued > keep) &&
+         (spi_device_get_trans_result(espDev, &t, block ? portMAX_DELAY : 0) ==
+          ESP_OK)) {
+    espHead = (espHead + 1) % SPITFT_ESP32_DMA_QUEUE;
+    espQueued--;
+  }
+}
+
+/*!
+    @brief  Wait until no DMA transfer in flight reads from a buffer
+    @param  buf  Buffer about to be overwritten
+*/
+void Adafruit_SPITFT::espRelease(const void *buf) {
+  for (uint8_t i = espQueued; i--;) { // Newest first
+    if (espTrans[(espHead + i) % SPITFT_ESP32_DMA_QUEUE].tx_buffer == buf) {
+      espReap(espQueued - i - 1, true);
+      return;
+    }
+  }
+}
+
+/*!
+    @brief  Queue one DMA transfer, waiting for a free slot if needed
+    @param  data   Bytes to send, DMA-capable and 32-bit aligned
+    @param  bytes  Number of bytes, at most SPITFT_ESP32_DMA_MAX
+*/
+void Adafruit_SPITFT::espQueue(const void *data, uint32_t bytes) {
+  if (espQueued == SPITFT_ESP32_DMA_QUEUE)
+    espReap(SPITFT_ESP32_DMA_QUEUE - 1, true);
+  spi_transaction_t *t =
+      &espTrans[(espHead + espQueued) % SPITFT_ESP32_DMA_QUEUE];
+  memset(t, 0, sizeof(*t));
+  t->length = bytes * 8;
+  t->tx_buffer = data;
+  spi_device_queue_trans(espDev, t, portMAX_DELAY);
+  espQueued++;
+}
+
+/*!
+    @brief  Queue pixels for DMA. Returns as soon as the last transfer is
+            queued; data sent in place must not change until dmaWait().
+    @param  colors     Pixels in '565' RGB format
+    @param  len        Number of pixels
+    @param  bigEndian  If true, colors are already in display byte order
+*/
+void Adafruit_SPITFT::espPixels(const uint16_t *colors, uint32_t len,
+                                bool bigEndian) {
+  if (bigEndian && esp_ptr_dma_capable(colors) && !((uintptr_t)colors & 3)) {
+    while (len) { // Already in display order: no copy
+      uint32_t n = min(len, (uint32_t)SPITFT_ESP32_DMA_MAX / 2);
+      espQueue(colors, n * 2);
+      colors += n;
+      len -= n;
+    }
+    return;
+  }
+  while (len) {
+    uint32_t n = min(len, (uint32_t)SPITFT_ESP32_DMA_PIXELS);
+    uint16_t *buf = pixelBuf[espNext];
+    espNext ^= 1;
+    espRelease(buf);
+    if (buf == pixelBuf[1])
+      lastFillLen = 0; // writeColor()'s fill is gone
+    if (bigEndian)
+      memcpy(buf, colors, n * 2);
+    else
+      swapBytes((uint16_t *)colors, n, buf);
+    espQueue(buf, n * 2);
+    colors += n;
+    len -= n;
+  }
+}
+
+/*!
+    @brief  Queue a run of one color, streaming a buffer of it repeatedly
+    @param  color  16-bit pixel color in '565' RGB format
+    @param  len    Number of pixels
+*/
+void Adafruit_SPITFT::espColor(uint16_t color, uint32_t len) {
+  if (!len)
+    return;
+  if (len <= 2) { // Not worth a DMA transfer
+    espWrite(color * 0x00010001UL, len * 2);
+    return;
+  }
+  uint32_t n = min(len, (uint32_t)SPITFT_ESP32_DMA_PIXELS);
+  uint16_t *buf = pixelBuf[1];
+  if ((color != lastFillColor) || (lastFillLen < n)) {
+    espRelease(buf);
+    uint16_t swapped = __builtin_bswap16(color);
+    for (uint32_t i = 0; i < n; i++)
+      buf[i] = swapped;
+    lastFillColor = color;
+    lastFillLen = n;
+    espNext = 0; // Let writePixels() start with the other buffer
+  }
+  while (len) {
+    uint32_t m = min(len, n);
+    espQueue(buf, m * 2);
+    len -= m;
+  }
+}
+#endif // end USE_SPI_DMA && ESP32
+
 /*!
     @brief  Issue a series of pixels, all the same color. Not self-
             contained; should follow startWrite() and setAddrWindow() calls.
@@ -1217,6 +1452,12 @@ void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
 
 #if defined(ESP32) // ESP32 has a special SPI pixel-writing function...
   if (connection == TFT_HARD_SPI) {
+#if defined(USE_SPI_DMA)
+    if (espDev) {
+      espColor(color, len);
+      return;
+    }
+#endif
 #define SPI_MAX_PIXELS_AT_ONCE 32
 #define TMPBUF_LONGWORDS (SPI_MAX_PIXELS_AT_ONCE + 1) / 2
 #define TMPBUF_PIXELS (TMPBUF_LONGWORDS * 2)
@@ -1680,6 +1921,29 @@ inline void Adafruit_SPITFT::writeFillRectPreclipped(int16_t x, int16_t y,
   writeColor(color, (uint32_t)w * h);
 }
 
+/*!
+    @brief  Fill a batch of clipped spans from Adafruit_GFX's filled
+            primitives. Each span is one address window and one color run;
+            runs of identical spans on consecutive lines (the straight
+            middle of a rounded rect, say) are merged into a single window.
+            Not self-contained; should follow startWrite().
+    @param  batch  Spans in rotated coordinates, already clipped.
+*/
+void Adafruit_SPITFT::writeSpans(const GFXspanBatch *batch) {
+  const GFXspan *spans = batch->span;
+  for (uint8_t i = 0; i < batch->count;) {
+    const GFXspan *s = &spans[i];
+    int16_t n = 1, len = s->x2 - s->x1 + 1;
+    while ((++i < batch->count) && (spans[i].y == s->y + n) &&
+           (spans[i].x1 == s->x1) && (spans[i].x2 == s->x2))
+      n++;
+    if (batch->vertical)
+      writeFillRectPreclipped(s->y, s->x1, n, len, batch->color);
+    else
+      writeFillRectPreclipped(s->x1, s->y, len, n, batch->color);
+  }
+}
+
 // -------------------------------------------------------------------------
 // Ever-so-slightly higher-level graphics operations. Similar to the 'write'
 // functions above, but these contain their own chip-select and SPI
@@ -2119,6 +2383,12 @@ uint16_t Adafruit_SPITFT::readcommand16(uint16_t addr) {
 */
 inline void Adafruit_SPITFT::SPI_BEGIN_TRANSACTION(void) {
   if (connection == TFT_HARD_SPI) {
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    if (espDev) {
+      spi_device_acquire_bus(espDev, portMAX_DELAY);
+      return;
+    }
+#endif
 #if defined(SPI_HAS_TRANSACTION)
     hwspi._spi->beginTransaction(hwspi.settings);
 #else // No transactions, configure SPI manually...
@@ -2146,6 +2416,13 @@ inline void Adafruit_SPITFT::SPI_BEGIN_TRANSACTION(void) {
             function that encapsulated both actions.
 */
 inline void Adafruit_SPITFT::SPI_END_TRANSACTION(void) {
+#if defined(USE_SPI_DMA) && defined(ESP32)
+  if ((connection == TFT_HARD_SPI) && espDev) {
+    dmaWait();
+    spi_device_release_bus(espDev);
+    return;
+  }
+#endif
 #if defined(SPI_HAS_TRANSACTION)
   if (connection == TFT_HARD_SPI) {
     hwspi._spi->endTransaction();
@@ -2167,6 +2444,12 @@ void Adafruit_SPITFT::spiWrite(uint8_t b) {
 #if defined(__AVR__)
     AVR_WRITESPI(b);
 #elif defined(ESP8266) || defined(ESP32)
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    if (espDev) {
+      espWrite(b, 1);
+      return;
+    }
+#endif
     hwspi._spi->write(b);
 #elif defined(ARDUINO_ARCH_RP2040)
     spi_inst_t *pi_spi = hwspi._spi == &SPI ? __SPI0_DEVICE : __SPI1_DEVICE;
@@ -2225,6 +2508,17 @@ uint8_t Adafruit_SPITFT::spiRead(void) {
   uint8_t b = 0;
   uint16_t w = 0;
   if (connection == TFT_HARD_SPI) {
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    if (espDev) {
+      spi_transaction_t t;
+      memset(&t, 0, sizeof(t));
+      t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+      t.length = 8;
+      dmaWait();
+      spi_device_polling_transmit(espDev, &t);
+      return t.rx_data[0];
+    }
+#endif
     return hwspi._spi->transfer((uint8_t)0);
   } else if (connection == TFT_SOFT_SPI) {
     if (swspi._miso >= 0) {
@@ -2452,6 +2746,12 @@ void Adafruit_SPITFT::SPI_WRITE16(uint16_t w) {
     AVR_WRITESPI(w >> 8);
     AVR_WRITESPI(w);
 #elif defined(ESP8266) || defined(ESP32)
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    if (espDev) {
+      espWrite(w, 2);
+      return;
+    }
+#endif
     hwspi._spi->write16(w);
 #elif defined(ARDUINO_ARCH_RP2040)
     spi_inst_t *pi_spi = hwspi._spi == &SPI ? __SPI0_DEVICE : __SPI1_DEVICE;
@@ -2510,6 +2810,12 @@ void Adafruit_SPITFT::SPI_WRITE32(uint32_t l) {
     AVR_WRITESPI(l >> 8);
     AVR_WRITESPI(l);
 #elif defined(ESP8266) || defined(ESP32)
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    if (espDev) {
+      espWrite(l, 4);
+      return;
+    }
+#endif
     hwspi._spi->write32(l);
 #elif defined(ARDUINO_ARCH_RP2040)
     spi_inst_t *pi_spi = hwspi._spi == &SPI ? __SPI0_DEVICE : __SPI1_DEVICE;
@@ -2618,4 +2924,104 @@ inline void Adafruit_SPITFT::TFT_RD_LOW(void) {
 #endif // end !USE_FAST_PINIO
 }
 
+// -------------------------------------------------------------------------
+// Adafruit_SPITFT_Banded: a 320x240 frame is 150 KB as a GFXcanvas16, but
+// a display list of the same frame is usually a few KB. display() replays
+// the list once per band into a canvas just a band tall, so a band of 19
+// rows plus a 4 KB list make flicker-free full-frame updates in ~16 KB.
+
+/*!
+    @brief  Create a banded renderer for a display. Call begin() once the
+            display itself has been initialized.
+    @param  tft         The display to render to
+    @param  bandHeight  Rows per band, or 0 for as many as fit in
+                        SPITFT_BAND_BYTES
+    @param  listBytes   Initial display list capacity, grown as a frame
+                        needs more
+*/
+Adafruit_SPITFT_Banded::Adafruit_SPITFT_Banded(Adafruit_SPITFT *tft,
+                                               uint16_t bandHeight,
+                                               uint16_t listBytes)
+    : GFXdisplayList(tft->width(), tft->height(), listBytes), _tft(tft),
+      _strip(NULL), _bandH(bandHeight) {}
+
+/*!
+    @brief  Delete the renderer, free memory
+*/
+Adafruit_SPITFT_Banded::~Adafruit_SPITFT_Banded(void) { delete _strip; }
+
+/*!
+    @brief  Match the display's current size and rotation and allocate the
+            strip buffer. Anything recorded so far is discarded.
+    @return true on success, false if the strip couldn't be allocated
+*/
+bool Adafruit_SPITFT_Banded::begin(void) {
+  WIDTH = _width = _tft->width();
+  HEIGHT = _height = _tft->height();
+  rotation = 0;
+  clear();
+
+  int32_t rows = _bandH ? _bandH : SPITFT_BAND_BYTES / (WIDTH * 2);
+  if (rows > HEIGHT)
+    rows = HEIGHT;
+  if (rows < 1)
+    rows = 1;
+  if (!_strip || (_strip->width() != WIDTH) || (_strip->height() != rows)) {
+    delete _strip;
+    _strip = new GFXcanvas16(WIDTH, rows);
+    if (_strip && !_strip->getBuffer()) {
+      delete _strip;
+      _strip = NULL;
+    }
+  }
+  return _strip != NULL;
+}
+
+/*!
+    @brief  Rotate the display and re-initialize the renderer to match
+    @param  r  Rotation, 0 thru 3
+*/
+void Adafruit_SPITFT_Banded::setRotation(uint8_t r) {
+  _tft->setRotation(r);
+  begin();
+}
+
+/*!
+    @brief  Render everything recorded since the last display() to the
+            screen, band by band, then empty the list. Bands start out
+            black, so a frame normally begins with fillScreen().
+    @return true if the frame was shown. false if begin() failed, or if
+            the list couldn't grow to hold the whole frame: the screen is
+            left as it was rather than showing part of a frame, and the
+            caller should draw less.
+*/
+bool Adafruit_SPITFT_Banded::display(void) {
+  if (!_strip || overflowed()) {
+    clear();
+    return false;
+  }
+  uint16_t *pixels = _strip->getBuffer();
+  int16_t rows = _strip->height();
+
+  for (int16_t y = 0; y < _height; y += rows) {
+    int16_t h = (_height - y < rows) ? _height - y : rows;
+    _strip->fillScreen(0);
+    replay(_strip, 0, y);
+    _tft->startWrite();
+    _tft->setAddrWindow(0, y, _width, h);
+    _tft->writePixels(pixels, (uint32_t)_width * h);
+    _tft->endWrite();
+  }
+  clear();
+  return true;
+}
+
+/*!
+    @brief  When the list fills up mid-frame, grow it so the frame stays
+            whole. Nothing is pushed to the screen before display().
+    @param  need  Bytes the list must hold
+    @return true if the list grew
+*/
+bool Adafruit_SPITFT_Banded::full(uint32_t need) { return grow(need); }
+
 #endif // end __AVR_ATtiny85__ __AVR_ATtiny84__
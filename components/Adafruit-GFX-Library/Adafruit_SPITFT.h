@@ -72,6 +72,10 @@ typedef volatile ADAGFX_PORT_t *PORTreg_t; ///< PORT register type
 #define DEFAULT_SPI_FREQ 16000000L ///< Hardware SPI default speed
 #endif
 
+#ifndef SPITFT_BAND_BYTES
+#define SPITFT_BAND_BYTES 12288 ///< Default Adafruit_SPITFT_Banded strip size
+#endif
+
 #if defined(ADAFRUIT_PYPORTAL) || defined(ADAFRUIT_PYPORTAL_M4_TITANO) ||      \
     defined(ADAFRUIT_PYBADGE_M4_EXPRESS) ||                                    \
     defined(ADAFRUIT_PYGAMER_M4_EXPRESS) ||                                    \
@@ -87,11 +91,23 @@ typedef volatile ADAGFX_PORT_t *PORTreg_t; ///< PORT register type
 // Estimated RAM usage:
 // 4 bytes/pixel on display major axis + 8 bytes/pixel on minor axis,
 // e.g. 320x240 pixels = 320 * 4 + 240 * 8 = 3,200 bytes.
+// On ESP32, hardware SPI displays then use the ESP-IDF SPI master driver
+// with two SPITFT_ESP32_DMA_PIXELS ping-pong buffers (4 KB by default).
+// The display needs an SPI bus of its own in that case.
 
 #if defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
 #include <Adafruit_ZeroDMA.h>
 #endif
 
+#if defined(USE_SPI_DMA) && defined(ESP32)
+#include <driver/spi_master.h>
+#ifndef SPITFT_ESP32_DMA_PIXELS
+#define SPITFT_ESP32_DMA_PIXELS 1024 ///< Pixels per ping-pong DMA buffer
+#endif
+#define SPITFT_ESP32_DMA_QUEUE 4   ///< Most SPI transfers queued at once
+#define SPITFT_ESP32_DMA_MAX 32768 ///< Largest single DMA transfer, bytes
+#endif
+
 // This is kind of a kludge. Needed a way to disambiguate the software SPI
 // and parallel constructors via their argument lists. Originally tried a
 // bool as the first argument to the parallel constructor (specifying 8-bit
@@ -300,6 +316,9 @@ public:
               connection is parallel.
   */
   void SPI_CS_HIGH(void) {
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    dmaWait(); // Queued pixels must go out before deselecting
+#endif
 #if defined(USE_FAST_PINIO)
 #if defined(HAS_PORT_SET_CLR)
 #if defined(KINETISK)
@@ -360,6 +379,9 @@ public:
       @brief  Set the data/command line LOW (command mode).
   */
   void SPI_DC_LOW(void) {
+#if defined(USE_SPI_DMA) && defined(ESP32)
+    dmaWait(); // Queued pixels must go out as data, not commands
+#endif
 #if defined(USE_FAST_PINIO)
 #if defined(HAS_PORT_SET_CLR)
 #if defined(KINETISK)
@@ -391,6 +413,19 @@ protected:
   inline void TFT_WR_STROBE(void); // Parallel interface write strobe
   inline void TFT_RD_HIGH(void);   // Parallel interface read high
   inline void TFT_RD_LOW(void);    // Parallel interface read low
+  // Span fill hook for the filled primitives in Adafruit_GFX
+  void writeSpans(const GFXspanBatch *batch);
+#if defined(USE_SPI_DMA) && defined(ESP32)
+  // ESP-IDF SPI master transport, used once espInit() succeeds
+  bool espInit(uint32_t freq);
+  bool espAddDevice(uint32_t freq);
+  void espWrite(uint32_t data, uint8_t bytes);
+  void espQueue(const void *data, uint32_t bytes);
+  void espRelease(const void *buf);
+  void espReap(uint8_t keep, bool block) const;
+  void espPixels(const uint16_t *colors, uint32_t len, bool bigEndian);
+  void espColor(uint16_t color, uint32_t len);
+#endif
 
   // CLASS INSTANCE VARIABLES --------------------------------------------
 
@@ -511,6 +546,17 @@ protected:
   uint32_t lastFillLen = 0;          ///< # of pixels w/last fill
   uint8_t onePixelBuf;               ///< For hi==lo fill
 #endif
+#if defined(USE_SPI_DMA) && defined(ESP32)
+  spi_device_handle_t espDev = NULL; ///< IDF SPI device, NULL = use SPIClass
+  spi_host_device_t espHost;         ///< SPI peripheral espDev is on
+  spi_transaction_t espTrans[SPITFT_ESP32_DMA_QUEUE]; ///< Transfer ring
+  mutable uint8_t espHead = 0;   ///< Oldest transfer in flight
+  mutable uint8_t espQueued = 0; ///< Number of transfers in flight
+  uint8_t espNext = 0;           ///< Ping-pong buffer to fill next
+  uint16_t *pixelBuf[2];         ///< Ping-pong buffers, DMA-capable RAM
+  uint16_t lastFillColor = 0;    ///< Color held in pixelBuf[1] by writeColor
+  uint32_t lastFillLen = 0;      ///< # of pixels of it, 0 = none
+#endif
 #if defined(USE_FAST_PINIO)
 #if defined(HAS_PORT_SET_CLR)
 #if !defined(KINETISK)
@@ -537,5 +583,35 @@ protected:
   uint32_t _freq = 0; ///< Dummy var to keep subclasses happy
 };
 
+/// Draws full frames on an Adafruit_SPITFT display without a full-screen
+/// framebuffer: drawing is recorded to a display list, then display()
+/// renders it one horizontal band at a time into a small strip buffer and
+/// pushes each band to the panel, so the screen never shows partial frames.
+class Adafruit_SPITFT_Banded : public GFXdisplayList {
+public:
+  Adafruit_SPITFT_Banded(Adafruit_SPITFT *tft, uint16_t bandHeight = 0,
+                         uint16_t listBytes = GFX_DLIST_BYTES);
+  ~Adafruit_SPITFT_Banded(void);
+  bool begin(void);
+  bool display(void);
+  void setRotation(uint8_t r);
+
+  /**********************************************************************/
+  /*!
+    @brief    Get the height of the bands display() renders
+    @returns  Band height in pixels, or 0 before begin()
+  */
+  /**********************************************************************/
+  uint16_t bandHeight(void) const { return _strip ? _strip->height() : 0; }
+
+protected:
+  bool full(uint32_t need);
+
+private:
+  Adafruit_SPITFT *_tft;
+  GFXcanvas16 *_strip; // One band of the frame
+  uint16_t _bandH;     // Requested band height, 0 = fit SPITFT_BAND_BYTES
+};
+
 #endif // end __AVR_ATtiny85__ __AVR_ATtiny84__
 #endif // end _ADAFRUIT_SPITFT_H_
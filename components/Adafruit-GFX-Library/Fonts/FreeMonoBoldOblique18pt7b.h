@@ -457,6 +457,6 @@ const GFXglyph FreeMonoBoldOblique18pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeMonoBoldOblique18pt7b PROGMEM = {
     (uint8_t *)FreeMonoBoldOblique18pt7bBitmaps,
-    (GFXglyph *)FreeMonoBoldOblique18pt7bGlyphs, 0x20, 0x7E, 35};
+    (GFXglyph *)FreeMonoBoldOblique18pt7bGlyphs, 0x20, 0x7E, 35, 0};
 
 // Approx. 4928 bytes
@@ -245,6 +245,6 @@ const GFXglyph FreeMonoOblique12pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeMonoOblique12pt7b PROGMEM = {
     (uint8_t *)FreeMonoOblique12pt7bBitmaps,
-    (GFXglyph *)FreeMonoOblique12pt7bGlyphs, 0x20, 0x7E, 24};
+    (GFXglyph *)FreeMonoOblique12pt7bGlyphs, 0x20, 0x7E, 24, 0};
 
 // Approx. 2379 bytes
@@ -314,6 +314,6 @@ const GFXglyph FreeSansBoldOblique12pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSansBoldOblique12pt7b PROGMEM = {
     (uint8_t *)FreeSansBoldOblique12pt7bBitmaps,
-    (GFXglyph *)FreeSansBoldOblique12pt7bGlyphs, 0x20, 0x7E, 29};
+    (GFXglyph *)FreeSansBoldOblique12pt7bGlyphs, 0x20, 0x7E, 29, 0};
 
 // Approx. 3207 bytes
@@ -299,6 +299,6 @@ const GFXglyph FreeSansOblique12pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSansOblique12pt7b PROGMEM = {
     (uint8_t *)FreeSansOblique12pt7bBitmaps,
-    (GFXglyph *)FreeSansOblique12pt7bGlyphs, 0x20, 0x7E, 29};
+    (GFXglyph *)FreeSansOblique12pt7bGlyphs, 0x20, 0x7E, 29, 0};
 
 // Approx. 3034 bytes
@@ -515,6 +515,6 @@ const GFXglyph FreeSansOblique18pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSansOblique18pt7b PROGMEM = {
     (uint8_t *)FreeSansOblique18pt7bBitmaps,
-    (GFXglyph *)FreeSansOblique18pt7bGlyphs, 0x20, 0x7E, 42};
+    (GFXglyph *)FreeSansOblique18pt7bGlyphs, 0x20, 0x7E, 42, 0};
 
 // Approx. 5623 bytes
@@ -687,6 +687,6 @@ const GFXglyph FreeSerif24pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSerif24pt7b PROGMEM = {(uint8_t *)FreeSerif24pt7bBitmaps,
                                          (GFXglyph *)FreeSerif24pt7bGlyphs,
-                                         0x20, 0x7E, 56};
+                                         0x20, 0x7E, 56, 0};
 
 // Approx. 7682 bytes
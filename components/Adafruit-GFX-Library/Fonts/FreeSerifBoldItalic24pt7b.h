@@ -790,6 +790,6 @@ const GFXglyph FreeSerifBoldItalic24pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSerifBoldItalic24pt7b PROGMEM = {
     (uint8_t *)FreeSerifBoldItalic24pt7bBitmaps,
-    (GFXglyph *)FreeSerifBoldItalic24pt7bGlyphs, 0x20, 0x7E, 56};
+    (GFXglyph *)FreeSerifBoldItalic24pt7bGlyphs, 0x20, 0x7E, 56, 0};
 
 // Approx. 8917 bytes
@@ -212,6 +212,6 @@ const GFXglyph FreeSerifBoldItalic9pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSerifBoldItalic9pt7b PROGMEM = {
     (uint8_t *)FreeSerifBoldItalic9pt7bBitmaps,
-    (GFXglyph *)FreeSerifBoldItalic9pt7bGlyphs, 0x20, 0x7E, 22};
+    (GFXglyph *)FreeSerifBoldItalic9pt7bGlyphs, 0x20, 0x7E, 22, 0};
 
 // Approx. 1982 bytes
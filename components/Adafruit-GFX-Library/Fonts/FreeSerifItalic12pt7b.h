@@ -268,6 +268,6 @@ const GFXglyph FreeSerifItalic12pt7bGlyphs[] PROGMEM = {
 
 const GFXfont FreeSerifItalic12pt7b PROGMEM = {
     (uint8_t *)FreeSerifItalic12pt7bBitmaps,
-    (GFXglyph *)FreeSerifItalic12pt7bGlyphs, 0x20, 0x7E, 29};
+    (GFXglyph *)FreeSerifItalic12pt7bGlyphs, 0x20, 0x7E, 29, 0};
 
 // Approx. 2656 bytes
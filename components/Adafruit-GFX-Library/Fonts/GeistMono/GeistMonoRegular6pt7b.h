@@ -139,6 +139,6 @@ const GFXglyph GeistMono_Regular6pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_Regular6pt7b PROGMEM = {
   (uint8_t  *)GeistMono_Regular6pt7bBitmaps,
   (GFXglyph *)GeistMono_Regular6pt7bGlyphs,
-  0x20, 0x7E, 15 };
+  0x20, 0x7E, 15, 0 };
 
 // Approx. 1129 bytes
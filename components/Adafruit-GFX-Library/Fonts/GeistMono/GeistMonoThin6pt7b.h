@@ -135,6 +135,6 @@ const GFXglyph GeistMono_Thin6pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_Thin6pt7b PROGMEM = {
   (uint8_t  *)GeistMono_Thin6pt7bBitmaps,
   (GFXglyph *)GeistMono_Thin6pt7bGlyphs,
-  0x20, 0x7E, 15 };
+  0x20, 0x7E, 15, 0 };
 
 // Approx. 1086 bytes
@@ -141,6 +141,6 @@ const GFXglyph JetBrainsMono_Thin6pt7bGlyphs[] PROGMEM = {
 const GFXfont JetBrainsMono_Thin6pt7b PROGMEM = {
   (uint8_t  *)JetBrainsMono_Thin6pt7bBitmaps,
   (GFXglyph *)JetBrainsMono_Thin6pt7bGlyphs,
-  0x20, 0x7E, 16 };
+  0x20, 0x7E, 16, 0 };
 
 // Approx. 1159 bytes
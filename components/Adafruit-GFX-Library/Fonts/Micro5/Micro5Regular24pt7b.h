@@ -344,6 +344,6 @@ const GFXglyph Micro5_Regular24pt7bGlyphs[] PROGMEM = {
 const GFXfont Micro5_Regular24pt7b PROGMEM = {
   (uint8_t  *)Micro5_Regular24pt7bBitmaps,
   (GFXglyph *)Micro5_Regular24pt7bGlyphs,
-  0x20, 0x7E, 47 };
+  0x20, 0x7E, 47, 0 };
 
 // Approx. 3595 bytes
@@ -118,6 +118,6 @@ const GFXglyph PicopixelGlyphs[] PROGMEM = {{0, 0, 0, 2, 0, 1},     // 0x20 ' '
                                             {179, 4, 2, 5, 0, -3}}; // 0x7E '~'
 
 const GFXfont Picopixel PROGMEM = {(uint8_t *)PicopixelBitmaps,
-                                   (GFXglyph *)PicopixelGlyphs, 0x20, 0x7E, 7};
+                                   (GFXglyph *)PicopixelGlyphs, 0x20, 0x7E, 7, 0};
 
 // Approx. 852 bytes
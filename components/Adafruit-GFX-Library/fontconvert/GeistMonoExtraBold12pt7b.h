@@ -270,6 +270,6 @@ const GFXglyph GeistMono_ExtraBold12pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_ExtraBold12pt7b PROGMEM = {
   (uint8_t  *)GeistMono_ExtraBold12pt7bBitmaps,
   (GFXglyph *)GeistMono_ExtraBold12pt7bGlyphs,
-  0x20, 0x7E, 31 };
+  0x20, 0x7E, 31, 0 };
 
 // Approx. 2701 bytes
@@ -765,6 +765,6 @@ const GFXglyph GeistMono_ExtraBold24pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_ExtraBold24pt7b PROGMEM = {
   (uint8_t  *)GeistMono_ExtraBold24pt7bBitmaps,
   (GFXglyph *)GeistMono_ExtraBold24pt7bGlyphs,
-  0x20, 0x7E, 61 };
+  0x20, 0x7E, 61, 0 };
 
 // Approx. 8644 bytes
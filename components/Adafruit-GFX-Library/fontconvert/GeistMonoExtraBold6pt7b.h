@@ -144,6 +144,6 @@ const GFXglyph GeistMono_ExtraBold6pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_ExtraBold6pt7b PROGMEM = {
   (uint8_t  *)GeistMono_ExtraBold6pt7bBitmaps,
   (GFXglyph *)GeistMono_ExtraBold6pt7bGlyphs,
-  0x20, 0x7E, 15 };
+  0x20, 0x7E, 15, 0 };
 
 // Approx. 1193 bytes
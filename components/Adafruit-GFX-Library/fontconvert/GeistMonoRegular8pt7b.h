@@ -169,6 +169,6 @@ const GFXglyph GeistMono_Regular8pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_Regular8pt7b PROGMEM = {
   (uint8_t  *)GeistMono_Regular8pt7bBitmaps,
   (GFXglyph *)GeistMono_Regular8pt7bGlyphs,
-  0x20, 0x7E, 20 };
+  0x20, 0x7E, 20, 0 };
 
 // Approx. 1497 bytes
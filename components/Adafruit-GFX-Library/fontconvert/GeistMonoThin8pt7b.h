@@ -165,6 +165,6 @@ const GFXglyph GeistMono_Thin8pt7bGlyphs[] PROGMEM = {
 const GFXfont GeistMono_Thin8pt7b PROGMEM = {
   (uint8_t  *)GeistMono_Thin8pt7bBitmaps,
   (GFXglyph *)GeistMono_Thin8pt7bGlyphs,
-  0x20, 0x7E, 20 };
+  0x20, 0x7E, 20, 0 };
 
 // Approx. 1444 bytes
@@ -783,6 +783,6 @@ const GFXglyph JetBrainsMono_ExtraBold24pt7bGlyphs[] PROGMEM = {
 const GFXfont JetBrainsMono_ExtraBold24pt7b PROGMEM = {
   (uint8_t  *)JetBrainsMono_ExtraBold24pt7bBitmaps,
   (GFXglyph *)JetBrainsMono_ExtraBold24pt7bGlyphs,
-  0x20, 0x7E, 62 };
+  0x20, 0x7E, 62, 0 };
 
 // Approx. 8858 bytes
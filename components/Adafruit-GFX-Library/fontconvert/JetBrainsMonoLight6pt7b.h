@@ -142,6 +142,6 @@ const GFXglyph JetBrainsMono_Light6pt7bGlyphs[] PROGMEM = {
 const GFXfont JetBrainsMono_Light6pt7b PROGMEM = {
   (uint8_t  *)JetBrainsMono_Light6pt7bBitmaps,
   (GFXglyph *)JetBrainsMono_Light6pt7bGlyphs,
-  0x20, 0x7E, 16 };
+  0x20, 0x7E, 16, 0 };
 
 // Approx. 1174 bytes
@@ -721,6 +721,6 @@ const GFXglyph Oxanium_Bold24pt7bGlyphs[] PROGMEM = {
 const GFXfont Oxanium_Bold24pt7b PROGMEM = {
   (uint8_t  *)Oxanium_Bold24pt7bBitmaps,
   (GFXglyph *)Oxanium_Bold24pt7bGlyphs,
-  0x20, 0x7E, 59 };
+  0x20, 0x7E, 59, 0 };
 
 // Approx. 8114 bytes
@@ -142,6 +142,6 @@ const GFXglyph Oxanium_ExtraLight6pt7bGlyphs[] PROGMEM = {
 const GFXfont Oxanium_ExtraLight6pt7b PROGMEM = {
   (uint8_t  *)Oxanium_ExtraLight6pt7bBitmaps,
   (GFXglyph *)Oxanium_ExtraLight6pt7bGlyphs,
-  0x20, 0x7E, 15 };
+  0x20, 0x7E, 15, 0 };
 
 // Approx. 1175 bytes
@@ -8,6 +8,12 @@ fonts to be used with the Adafruit_GFX Arduino library.
 For UNIX-like systems.  Outputs to stdout; redirect to header file, e.g.:
   ./fontconvert ~/Library/Fonts/FreeSans.ttf 18 > FreeSans18pt7b.h
 
+With -r as the first argument, glyphs are run-length encoded instead
+(GFX_FONT_RLE, see gfxfont.h) and the font name gets an 'RLE' suffix:
+  ./fontconvert -r ~/Library/Fonts/FreeSans.ttf 24 > FreeSans24pt7bRLE.h
+This is usually a good deal smaller (and faster to draw) for large sizes,
+but larger for small ones.
+
 REQUIRES FREETYPE LIBRARY.  www.freetype.org
 
 Currently this only extracts the printable 7-bit ASCII chars of a font.
@@ -29,25 +35,61 @@ See notes at end for glyph nomenclature & other tidbits.
 
 #define DPI 141 // Approximate res. of Adafruit 2.8" TFT
 
+// Write one hexadecimal byte to the output table
+void enbyte(uint8_t value) {
+  static uint8_t row = 0, firstCall = 1;
+  if (!firstCall) {    // Format output table nicely
+    if (++row >= 12) { // Last entry on line?
+      printf(",\n  "); //   Newline format output
+      row = 0;         //   Reset row counter
+    } else {           // Not end of line
+      printf(", ");    //   Simple comma delim
+    }
+  }
+  printf("0x%02X", value); // Write byte value
+  firstCall = 0;           // Formatting flag
+}
+
 // Accumulate bits for output, with periodic hexadecimal byte write
 void enbit(uint8_t value) {
-  static uint8_t row = 0, sum = 0, bit = 0x80, firstCall = 1;
+  static uint8_t sum = 0, bit = 0x80;
   if (value)
-    sum |= bit;          // Set bit if needed
-  if (!(bit >>= 1)) {    // Advance to next bit, end of byte reached?
-    if (!firstCall) {    // Format output table nicely
-      if (++row >= 12) { // Last entry on line?
-        printf(",\n  "); //   Newline format output
-        row = 0;         //   Reset row counter
-      } else {           // Not end of line
-        printf(", ");    //   Simple comma delim
+    sum |= bit;       // Set bit if needed
+  if (!(bit >>= 1)) { // Advance to next bit, end of byte reached?
+    enbyte(sum);      // Write byte value
+    sum = 0;          // Clear for next byte
+    bit = 0x80;       // Reset bit counter
+  }
+}
+
+// Write a glyph as GFX_FONT_RLE (unlit << 4 | lit) run pairs, scanlines
+// concatenated; returns the number of bytes written
+int enrle(FT_Bitmap *bitmap) {
+  int x, y, count = 0, unlit = 0, lit = 0;
+  for (y = 0; y < bitmap->rows; y++) {
+    for (x = 0; x < bitmap->width; x++) {
+      if (bitmap->buffer[y * bitmap->pitch + x / 8] & (0x80 >> (x & 7))) {
+        if (lit == 15) { // Lit run full, start a new pair
+          enbyte((unlit << 4) | lit);
+          count++;
+          unlit = lit = 0;
+        }
+        lit++;
+      } else {
+        if (lit || (unlit == 15)) { // Pair complete, start the next one
+          enbyte((unlit << 4) | lit);
+          count++;
+          unlit = lit = 0;
+        }
+        unlit++;
       }
     }
-    printf("0x%02X", sum); // Write byte value
-    sum = 0;               // Clear for next byte
-    bit = 0x80;            // Reset bit counter
-    firstCall = 0;         // Formatting flag
   }
+  if (unlit || lit) {
+    enbyte((unlit << 4) | lit);
+    count++;
+  }
+  return count;
 }
 
 int main(int argc, char *argv[]) {
@@ -59,17 +101,25 @@ int main(int argc, char *argv[]) {
   FT_Bitmap *bitmap;
   FT_BitmapGlyphRec *g;
   GFXglyph *table;
-  uint8_t bit;
+  uint8_t bit, rle = 0;
 
   // Parse command line.  Valid syntaxes are:
-  //   fontconvert [filename] [size]
-  //   fontconvert [filename] [size] [last char]
-  //   fontconvert [filename] [size] [first char] [last char]
+  //   fontconvert [-r] [filename] [size]
+  //   fontconvert [-r] [filename] [size] [last char]
+  //   fontconvert [-r] [filename] [size] [first char] [last char]
   // Unless overridden, default first and last chars are
-  // ' ' (space) and '~', respectively
+  // ' ' (space) and '~', respectively.  -r selects run-length glyphs.
+
+  if ((argc > 1) && !strcmp(argv[1], "-r")) {
+    rle = 1;
+    argv[1] = argv[0];
+    argv++;
+    argc--;
+  }
 
   if (argc < 3) {
-    fprintf(stderr, "Usage: %s fontfile size [first] [last]\n", argv[0]);
+    fprintf(stderr, "Usage: %s [-r] fontfile size [first] [last]\n",
+            argv[0]);
     return 1;
   }
 
@@ -109,7 +159,7 @@ int main(int argc, char *argv[]) {
     ptr = &fontName[strlen(fontName)]; // If none, append
   // Insert font size and 7/8 bit.  fontName was alloc'd w/extra
   // space to allow this, we're not sprintfing into Forbidden Zone.
-  sprintf(ptr, "%dpt%db", size, (last > 127) ? 8 : 7);
+  sprintf(ptr, "%dpt%db%s", size, (last > 127) ? 8 : 7, rle ? "RLE" : "");
   // Space and punctuation chars in name replaced w/ underscores.
   for (i = 0; (c = fontName[i]); i++) {
     if (isspace(c) || ispunct(c))
@@ -184,6 +234,12 @@ int main(int argc, char *argv[]) {
     table[j].xOffset = g->left;
     table[j].yOffset = 1 - g->top;
 
+    if (rle) {
+      bitmapOffset += enrle(bitmap);
+      FT_Done_Glyph(glyph);
+      continue;
+    }
+
     for (y = 0; y < bitmap->rows; y++) {
       for (x = 0; x < bitmap->width; x++) {
         byte = x / 8;
@@ -231,12 +287,13 @@ int main(int argc, char *argv[]) {
   printf("  (GFXglyph *)%sGlyphs,\n", fontName);
   if (face->size->metrics.height == 0) {
     // No face height info, assume fixed width and get from a glyph.
-    printf("  0x%02X, 0x%02X, %d };\n\n", first, last, table[0].height);
+    printf("  0x%02X, 0x%02X, %d", first, last, table[0].height);
   } else {
-    printf("  0x%02X, 0x%02X, %ld };\n\n", first, last,
+    printf("  0x%02X, 0x%02X, %ld", first, last,
            face->size->metrics.height >> 6);
   }
-  printf("// Approx. %d bytes\n", bitmapOffset + (last - first + 1) * 7 + 7);
+  printf(rle ? ", GFX_FONT_RLE };\n\n" : ", 0 };\n\n");
+  printf("// Approx. %d bytes\n", bitmapOffset + (last - first + 1) * 7 + 8);
   // Size estimate is based on AVR struct and pointer sizes;
   // actual size may vary.
 
@@ -7,6 +7,12 @@
 #ifndef _GFXFONT_H_
 #define _GFXFONT_H_
 
+// GFXfont->flags values.  With GFX_FONT_RLE, each glyph's bitmap is a run
+// of bytes ((unlit << 4) | lit), each pair giving 0-15 unlit pixels followed
+// by 0-15 lit pixels, scanlines concatenated, until width * height pixels
+// are covered.  Generated by 'fontconvert -r'; pays off at larger sizes.
+#define GFX_FONT_RLE 0x01 ///< Glyph bitmaps are nibble run-length pairs
+
 /// Font data stored PER GLYPH
 typedef struct {
   uint16_t bitmapOffset; ///< Pointer into GFXfont->bitmap
@@ -24,6 +30,7 @@ typedef struct {
   uint16_t first;   ///< ASCII extents (first char)
   uint16_t last;    ///< ASCII extents (last char)
   uint8_t yAdvance; ///< Newline distance (y axis)
+  uint8_t flags;    ///< GFX_FONT_* format flags, 0 for packed bitmaps
 } GFXfont;
 
 #endif // _GFXFONT_H_
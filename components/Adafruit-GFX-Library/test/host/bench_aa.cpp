@@ -0,0 +1,333 @@
+// Anti-aliased primitives: the coverage drawCircleAA(), drawArcAA() and
+// drawLineAA() hand to blendPixel() is recorded and checked against the exact
+// shapes, and the canvas and GrayOLED blends against exact mixing. Then the
+// time per frame of a gauge (270 degree arc and needle) on GFXcanvas16.
+
+#include <chrono>
+#include <math.h>
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_GrayOLED.h>
+
+#include "mock_host.h"
+
+#define SIZE 256
+#define MID (SIZE / 2)
+
+// Records every blendPixel() call instead of drawing
+class Coverage : public GFXcanvas8 {
+public:
+  Coverage() : GFXcanvas8(SIZE, SIZE) { clear(); }
+
+  void clear(void) {
+    memset(count, 0, sizeof(count));
+    memset(alpha, 0, sizeof(alpha));
+  }
+
+  uint8_t count[SIZE][SIZE], alpha[SIZE][SIZE];
+
+protected:
+  void blendPixel(int16_t x, int16_t y, uint16_t color, uint8_t a) {
+    if ((x < 0) || (y < 0) || (x >= SIZE) || (y >= SIZE)) {
+      fprintf(stderr, "blend at (%d, %d) is off the canvas\n", x, y);
+      mock_failures++;
+      return;
+    }
+    count[y][x]++;
+    alpha[y][x] = a;
+  }
+};
+
+static Coverage cov;
+
+static bool twice(const char *what, int16_t r) {
+  for (int y = 0; y < SIZE; y++) {
+    for (int x = 0; x < SIZE; x++) {
+      if (cov.count[y][x] > 1) {
+        fprintf(stderr, "%s r %d: pixel (%d, %d) blended %d times\n", what, r,
+                x - MID, y - MID, cov.count[y][x]);
+        mock_failures++;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void test_circles(void) {
+  for (int16_t r = 0; r < 90; r++) {
+    cov.clear();
+    cov.drawCircleAA(MID, MID, r, 255);
+    if (twice("drawCircleAA()", r))
+      return;
+    // The coverage-weighted mean distance is the radius
+    double sum = 0, weight = 0;
+    for (int y = 0; y < SIZE; y++) {
+      for (int x = 0; x < SIZE; x++) {
+        sum += cov.alpha[y][x] * hypot(x - MID, y - MID);
+        weight += cov.alpha[y][x];
+      }
+    }
+    if ((r >= 2) && (fabs(sum / weight - r) > 0.05)) {
+      fprintf(stderr, "drawCircleAA() r %d: mean radius %.3f\n", r,
+              sum / weight);
+      mock_failures++;
+    }
+  }
+}
+
+// Coverage of the arc from start to end, clockwise
+static void arc(int16_t r, int16_t start, int16_t end,
+                uint8_t out[SIZE][SIZE]) {
+  cov.clear();
+  cov.drawArcAA(MID, MID, r, start, end, 255);
+  memcpy(out, cov.alpha, sizeof(cov.alpha));
+}
+
+static void test_arcs(void) {
+  static uint8_t full[SIZE][SIZE], first[SIZE][SIZE], other[SIZE][SIZE];
+  srand(6);
+  for (int n = 0; n < 400; n++) {
+    // Ends up to two turns apart, either way round
+    int16_t r = rand() % 100 + 10, start = rand() % 720 - 360,
+            end = start + rand() % 1439 - 719;
+    if ((end - start) % 360 == 0)
+      continue;
+    cov.clear();
+    cov.drawCircleAA(MID, MID, r, 255);
+    memcpy(full, cov.alpha, sizeof(full));
+
+    // Clockwise from start to end, 0 at 12 o'clock: nothing outside
+    cov.clear();
+    cov.drawArcAA(MID, MID, r, start, end, 255);
+    if (twice("drawArcAA()", r))
+      return;
+    if (end - start >= 360) {
+      CHECK(!memcmp(cov.alpha, full, sizeof(full)));
+      continue;
+    }
+    double sweep = fmod(end - start + 1080.0, 360.0);
+    for (int y = 0; y < SIZE; y++) {
+      for (int x = 0; x < SIZE; x++) {
+        if (!cov.count[y][x])
+          continue;
+        double a = atan2(x - MID, MID - y) * 180 / M_PI;
+        double off = fmod(a - start + 1080.0, 360.0);
+        if ((off > sweep + 0.01) && (off < 359.99)) {
+          fprintf(stderr, "drawArcAA() %d to %d: pixel (%d, %d) is outside\n",
+                  start, end, x - MID, y - MID);
+          mock_failures++;
+          return;
+        }
+      }
+    }
+    memcpy(first, cov.alpha, sizeof(first));
+
+    // Only the sweep matters, not how many turns apart the ends are
+    arc(r, start, start + (int16_t)sweep, other);
+    CHECK(!memcmp(first, other, sizeof(first)));
+
+    // The rest of the circle fills the gap exactly
+    arc(r, end, end + 360 - (int16_t)sweep, other);
+    for (int y = 0; y < SIZE; y++) {
+      for (int x = 0; x < SIZE; x++) {
+        uint8_t a = first[y][x] ? first[y][x] : other[y][x];
+        if (a != full[y][x]) {
+          fprintf(stderr,
+                  "drawArcAA() %d to %d and back: pixel (%d, %d) is %d, "
+                  "circle %d\n",
+                  start, end, x - MID, y - MID, a, full[y][x]);
+          mock_failures++;
+          return;
+        }
+      }
+    }
+    if (mock_failures)
+      return;
+  }
+
+  // Ends a whole number of turns apart: nothing, unless a turn or more
+  // clockwise
+  arc(50, 30, -330, other);
+  for (int y = 0; y < SIZE; y++)
+    for (int x = 0; x < SIZE; x++)
+      CHECK(!other[y][x]);
+}
+
+static void test_lines(void) {
+  srand(7);
+  for (int n = 0; n < 2000; n++) {
+    int16_t x0 = rand() % 216 + 20, y0 = rand() % 216 + 20,
+            x1 = rand() % 216 + 20, y1 = rand() % 216 + 20;
+    int16_t dx = x1 - x0, dy = y1 - y0;
+    if (!dx || !dy || (abs(dx) == abs(dy)))
+      continue;
+    cov.clear();
+    cov.drawLineAA(x0, y0, x1, y1, 255);
+    if (twice("drawLineAA()", 0))
+      return;
+    // Each step along the major axis sums to full coverage, centred on the
+    // exact line
+    bool ymajor = abs(dy) > abs(dx);
+    int16_t steps = ymajor ? abs(dy) : abs(dx);
+    for (int16_t i = 1; i < steps; i++) {
+      double exact, sum = 0, pos = 0;
+      for (int16_t j = 0; j < SIZE; j++) {
+        int16_t x, y;
+        if (ymajor) {
+          y = y0 + (dy > 0 ? i : -i);
+          x = j;
+          exact = x0 + (double)dx * i / abs(dy);
+        } else {
+          x = x0 + (dx > 0 ? i : -i);
+          y = j;
+          exact = y0 + (double)dy * i / abs(dx);
+        }
+        if (cov.count[y][x]) {
+          sum += cov.alpha[y][x];
+          pos += cov.alpha[y][x] * j;
+        }
+      }
+      if ((sum != 255) || (fabs(pos / sum - exact) > 0.01)) {
+        fprintf(stderr,
+                "drawLineAA() (%d, %d)-(%d, %d) step %d: coverage %.0f at "
+                "%.3f, line at %.3f\n",
+                x0, y0, x1, y1, i, sum, pos / sum, exact);
+        mock_failures++;
+        return;
+      }
+    }
+  }
+}
+
+template <class T> class Blend : public T {
+public:
+  using T::T;
+  using T::blendPixel;
+};
+
+// The blend of one channel of max levels, rounded
+static int mix(int fg, int bg, int alpha) {
+  return (int)lround(bg + (fg - bg) * alpha / 255.0);
+}
+
+static void test_blends(void) {
+  Blend<GFXcanvas8> c8(1, 1);
+  Blend<GFXcanvas16> c16(1, 1);
+  srand(8);
+  for (int n = 0; n < 20000; n++) {
+    uint16_t fg = rand(), bg = rand();
+    uint8_t alpha = rand();
+    if (n < 512) // Both ends, every level
+      alpha = (n & 1) ? 255 : 0;
+
+    c8.drawPixel(0, 0, bg & 0xFF);
+    c8.blendPixel(0, 0, fg, alpha);
+    int got = c8.getPixel(0, 0), want = mix(fg & 0xFF, bg & 0xFF, alpha);
+    if (abs(got - want) > 1) {
+      fprintf(stderr, "GFXcanvas8: %d over %d at %d is %d, expected %d\n",
+              fg & 0xFF, bg & 0xFF, alpha, got, want);
+      mock_failures++;
+      return;
+    }
+
+    c16.drawPixel(0, 0, bg);
+    c16.blendPixel(0, 0, fg, alpha);
+    uint16_t p = c16.getPixel(0, 0);
+    static const struct {
+      uint8_t shift, max;
+    } ch[] = {{11, 31}, {5, 63}, {0, 31}};
+    for (auto &c : ch) {
+      int g = (p >> c.shift) & c.max,
+          w = mix((fg >> c.shift) & c.max, (bg >> c.shift) & c.max, alpha);
+      // blend565() takes 5 bits of alpha and truncates: within 2 levels,
+      // exact at both ends
+      if ((abs(g - w) > 2) || (((alpha == 0) || (alpha == 255)) && (g != w))) {
+        fprintf(stderr, "GFXcanvas16: %04X over %04X at %d is %04X\n", fg, bg,
+                alpha, p);
+        mock_failures++;
+        return;
+      }
+    }
+  }
+}
+
+// 4-bit GrayOLED: nibble blends and the dirty window
+class GrayBlend : public Adafruit_GrayOLED {
+public:
+  GrayBlend() : Adafruit_GrayOLED(4, 128, 128, &Wire) {}
+  bool begin(void) { return _init(0x3C, false); }
+  void display(void) { displayWindow(0x15, 0x75); }
+  bool oled_commandList(const uint8_t *c, uint8_t n) { return true; }
+  bool oled_data(const uint8_t *d, size_t n) { return true; }
+  using Adafruit_GrayOLED::blendPixel;
+  // getPixel() only reads the 1-bit layout
+  uint8_t level(int16_t x, int16_t y) const {
+    return (buffer[x / 2 + y * WIDTH / 2] >> ((x & 1) ? 0 : 4)) & 0xF;
+  }
+  int16_t x1(void) const { return window_x1; }
+  int16_t x2(void) const { return window_x2; }
+};
+
+static void test_gray(void) {
+  GrayBlend oled;
+  CHECK(oled.begin());
+  srand(9);
+  for (int n = 0; n < 4000; n++) {
+    int16_t x = rand() % 128, y = rand() % 128;
+    uint8_t fg = rand() & 15, bg = rand() & 15, alpha = rand();
+    oled.drawPixel(x, y, bg);
+    // Its neighbour in the same byte must not change
+    int16_t nx = x ^ 1;
+    uint8_t other = oled.level(nx, y);
+    oled.display();
+    oled.blendPixel(x, y, fg, alpha);
+    CHECK(abs(oled.level(x, y) - mix(fg, bg, alpha)) <= 1);
+    CHECK_EQ(oled.level(nx, y), other);
+    CHECK((oled.x1() <= x) && (x <= oled.x2()));
+    if (mock_failures)
+      return;
+  }
+}
+
+// One gauge frame: clear, 270 degree scale, needle
+template <bool aa> static double frame(void) {
+  GFXcanvas16 canvas(240, 240);
+  const int n = 2000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    int16_t deg = i % 270 - 135;
+    int16_t nx = 120 + lround(90 * sin(deg * M_PI / 180)),
+            ny = 120 - lround(90 * cos(deg * M_PI / 180));
+    canvas.fillScreen(0);
+    if (aa) {
+      canvas.drawArcAA(120, 120, 100, -135, 135, 0xFFFF);
+      canvas.drawLineAA(120, 120, nx, ny, 0xF800);
+    } else {
+      canvas.drawCircle(120, 120, 100, 0xFFFF);
+      canvas.drawLine(120, 120, nx, ny, 0xF800);
+    }
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  return s / n * 1e6;
+}
+
+int main(void) {
+  test_circles();
+  test_arcs();
+  test_lines();
+  test_blends();
+  test_gray();
+
+  double plain = frame<false>(), aa = frame<true>();
+  printf("  240x240 GFXcanvas16 gauge: anti-aliased %.1f us/frame, "
+         "drawCircle + drawLine %.1f us/frame (fillScreen included)\n",
+         aa, plain);
+
+  if (mock_failures)
+    return 1;
+  printf("bench_aa: ok\n");
+  return 0;
+}
@@ -0,0 +1,220 @@
+// Adafruit_SPITFT_Banded: a frame recorded to the display list and pushed
+// band by band must leave the panel showing exactly what drawing the same
+// calls on a full-screen GFXcanvas16 gives, for any band height and
+// rotation, and whether or not the list had to grow. Then the memory a
+// 240x320 frame takes and the time per display(), for a status screen and
+// for the random test scenes.
+
+#include <chrono>
+
+#include <Adafruit_SPITFT.h>
+#include <Fonts/FreeSans12pt7b.h>
+
+#include "mock_host.h"
+
+#define TFT_W 240
+#define TFT_H 320
+
+// A panel whose RAM is written through setAddrWindow() and the pixel bytes
+// Adafruit_SPITFT sends on the bus, big-endian
+class ModelTFT : public Adafruit_SPITFT {
+public:
+  ModelTFT(SPIClass *bus) : Adafruit_SPITFT(TFT_W, TFT_H, bus, 10, 9) {
+    model = this;
+    bus->onByte = received;
+  }
+
+  void begin(uint32_t freq) { initSPI(freq); }
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    wx = x;
+    wy = y;
+    ww = w;
+    wh = h;
+    n = 0;
+    windows++;
+  }
+
+  uint16_t ram[TFT_W * TFT_H];
+  long windows = 0, bytes = 0;
+
+private:
+  static void received(uint8_t b) {
+    ModelTFT *m = model;
+    m->bytes++;
+    if (!m->high) {
+      m->msb = b;
+      m->high = true;
+      return;
+    }
+    m->high = false;
+    if (m->n < (long)m->ww * m->wh) {
+      int16_t x = m->wx + m->n % m->ww, y = m->wy + m->n / m->ww;
+      m->ram[x + y * m->width()] = (m->msb << 8) | b;
+      m->n++;
+    }
+  }
+
+  static ModelTFT *model;
+  uint16_t wx = 0, wy = 0, ww = 0, wh = 0;
+  long n = 0;
+  uint8_t msb = 0;
+  bool high = false;
+};
+
+ModelTFT *ModelTFT::model;
+
+static const uint8_t arrow[] = {0x18, 0x3C, 0x7E, 0xFF,
+                                0x18, 0x18, 0x18, 0x18};
+
+// The same random scene on any target
+static void scene(Adafruit_GFX *gfx, unsigned seed) {
+  static uint16_t rgb[16 * 12];
+  srand(seed);
+  for (int i = 0; i < 16 * 12; i++)
+    rgb[i] = rand();
+  int16_t w = gfx->width(), h = gfx->height();
+  gfx->fillScreen(rand());
+  for (int n = 0; n < 60; n++) {
+    int16_t x = rand() % (w + 40) - 20, y = rand() % (h + 40) - 20;
+    int16_t a = rand() % 80 + 1, b = rand() % 80 + 1;
+    uint16_t c = rand();
+    switch (rand() % 11) {
+    case 0:
+      gfx->fillRect(x, y, a, b, c);
+      break;
+    case 1:
+      gfx->drawLine(x, y, x + a - 40, y + b - 40, c);
+      break;
+    case 2:
+      gfx->fillCircle(x, y, a / 2, c);
+      break;
+    case 3:
+      gfx->drawCircle(x, y, a / 2, c);
+      break;
+    case 4:
+      gfx->fillRoundRect(x, y, a, b, a / 4, c);
+      break;
+    case 5:
+      gfx->fillTriangle(x, y, x + a, y + 10, x + 5, y + b, c);
+      break;
+    case 6:
+      gfx->setFont(rand() & 1 ? &FreeSans12pt7b : NULL);
+      gfx->setTextSize(rand() % 2 + 1);
+      gfx->setTextColor(c);
+      gfx->setCursor(x, y);
+      gfx->print("12:34 ok");
+      break;
+    case 7:
+      gfx->drawBitmap(x, y, arrow, 8, 8, c);
+      break;
+    case 8:
+      gfx->drawRGBBitmap(x, y, rgb, 16, 12);
+      break;
+    case 9:
+      gfx->drawLineAA(x, y, x + a - 40, y + b - 40, c);
+      break;
+    default:
+      gfx->drawCircleAA(x, y, a / 2, c);
+      break;
+    }
+  }
+}
+
+static void test_frames(void) {
+  SPIClass bus;
+  ModelTFT tft(&bus);
+  tft.begin(0);
+  unsigned seed = 1;
+  for (uint8_t r = 0; r < 4; r++) {
+    tft.setRotation(r);
+    GFXcanvas16 expect(tft.width(), tft.height());
+    uint16_t bands[] = {0, 1, 7, 19, 64, TFT_H};
+    for (uint16_t band : bands) {
+      // A list that starts tiny has to grow to hold each frame
+      Adafruit_SPITFT_Banded banded(&tft, band, (band & 1) ? 64 : 4096);
+      CHECK(banded.begin());
+      for (int f = 0; f < 10; f++, seed++) {
+        scene(&banded, seed);
+        CHECK(!banded.overflowed());
+        memset(tft.ram, 0xA5, sizeof(tft.ram));
+        CHECK(banded.display());
+        CHECK_EQ(banded.size(), 0);
+        scene(&expect, seed);
+        if (memcmp(tft.ram, expect.getBuffer(),
+                   tft.width() * tft.height() * 2)) {
+          fprintf(stderr, "rotation %d, band %d rows, scene %u: panel differs "
+                          "from the canvas\n",
+                  r, banded.bandHeight(), seed);
+          mock_failures++;
+          return;
+        }
+      }
+    }
+  }
+}
+
+// A status screen: header, labels and values, a trend graph and a button
+static void dashboard(Adafruit_GFX *gfx, unsigned seed) {
+  srand(seed);
+  gfx->fillScreen(0);
+  gfx->fillRect(0, 0, TFT_W, 30, 0x001F);
+  gfx->setFont(&FreeSans12pt7b);
+  gfx->setTextSize(1);
+  gfx->setTextColor(0xFFFF);
+  gfx->setCursor(8, 22);
+  gfx->print("Boiler 2");
+  for (int i = 0; i < 4; i++) {
+    gfx->setCursor(8, 60 + i * 28);
+    gfx->print("Temp");
+    char value[8];
+    snprintf(value, sizeof(value), "%.1f", rand() % 1000 / 10.0);
+    gfx->setCursor(140, 60 + i * 28);
+    gfx->print(value);
+  }
+  gfx->drawRect(8, 170, 224, 100, 0x7BEF);
+  int16_t y = 220;
+  for (int16_t x = 10; x < 230; x += 4) {
+    int16_t next = 180 + (y - 180 + rand() % 21 - 10 + 80) % 80;
+    gfx->drawLine(x, y, x + 4, next, 0x07E0);
+    y = next;
+  }
+  gfx->fillRoundRect(70, 280, 100, 32, 8, 0xF800);
+}
+
+static void bench(const char *name, void (*draw)(Adafruit_GFX *, unsigned)) {
+  SPIClass bus;
+  ModelTFT tft(&bus);
+  tft.begin(0);
+  Adafruit_SPITFT_Banded banded(&tft);
+  CHECK(banded.begin());
+  long list = 0;
+  const int n = 200;
+  tft.windows = tft.bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    draw(&banded, 1000 + i);
+    list += banded.size();
+    banded.display();
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  long strip = (long)TFT_W * banded.bandHeight() * 2;
+  printf("  240x320 %s: %d-row bands, strip %ld bytes + list %ld bytes on "
+         "average (GFXcanvas16 %d bytes); %.0f bands and %.0f bus bytes per "
+         "frame, %.0f us per frame on the host\n",
+         name, banded.bandHeight(), strip, list / n, TFT_W * TFT_H * 2,
+         (double)tft.windows / n, (double)tft.bytes / n, s / n * 1e6);
+}
+
+int main(void) {
+  test_frames();
+  bench("status screen", dashboard);
+  bench("random scene", scene);
+
+  if (mock_failures)
+    return 1;
+  printf("bench_banded: ok\n");
+  return 0;
+}
@@ -0,0 +1,183 @@
+// drawBitmap() through drawBitmap1()/blitBitmap1() against the per-pixel
+// writePixel() path, on a GFXcanvas1 (scanline bytes) and on a page-major
+// buffer laid out like Adafruit_SSD1306's. Random blits in every rotation,
+// clipped, opaque and transparent, must leave both buffers byte for byte the
+// same; then blits per second of a 100x50 image on each path.
+
+#include <chrono>
+
+#include <Adafruit_GFX.h>
+
+#include "mock_host.h"
+
+#define W 128
+#define H 64
+
+// GFXcanvas1 whose blits can be switched off, so drawBitmap() falls back to
+// writePixel()
+class Canvas1 : public GFXcanvas1 {
+public:
+  Canvas1(void) : GFXcanvas1(W, H) {}
+  uint8_t *bytes(void) { return buffer; }
+  size_t size(void) const { return (W + 7) / 8 * H; }
+  bool blit = true;
+
+protected:
+  bool drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                   int16_t h, uint16_t color, uint16_t bg, bool opaque,
+                   bool progmem) {
+    return blit && GFXcanvas1::drawBitmap1(x, y, bitmap, w, h, color, bg,
+                                           opaque, progmem);
+  }
+  bool canBlit1(void) const { return blit; }
+};
+
+// 8-row pages, topmost pixel in the LSB; colors 0, 1 and 2 clear, set and
+// invert, as on Adafruit_SSD1306
+class Pages : public Adafruit_GFX {
+public:
+  Pages(void) : Adafruit_GFX(W, H) { memset(buf, 0, sizeof(buf)); }
+  uint8_t *bytes(void) { return buf; }
+  size_t size(void) const { return sizeof(buf); }
+  bool blit = true;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+      return;
+    int16_t t;
+    switch (getRotation()) {
+    case 1:
+      t = x, x = WIDTH - y - 1, y = t;
+      break;
+    case 2:
+      x = WIDTH - x - 1;
+      y = HEIGHT - y - 1;
+      break;
+    case 3:
+      t = x, x = y, y = HEIGHT - t - 1;
+      break;
+    }
+    uint8_t *b = &buf[x + (y / 8) * WIDTH], bit = 1 << (y & 7);
+    if (color == 1)
+      *b |= bit;
+    else if (color == 0)
+      *b &= ~bit;
+    else
+      *b ^= bit;
+  }
+
+protected:
+  static uint8_t op(uint16_t color) {
+    return (color == 1) ? GFX_BLIT_SET
+                        : (color == 0) ? GFX_BLIT_CLEAR : GFX_BLIT_INVERT;
+  }
+  bool drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                   int16_t h, uint16_t color, uint16_t bg, bool opaque,
+                   bool progmem) {
+    if (!blit)
+      return false;
+    blitBitmap1(buf, true, x, y, bitmap, w, h, op(color),
+                opaque ? op(bg) : GFX_BLIT_NONE, progmem);
+    return true;
+  }
+  bool canBlit1(void) const { return blit; }
+
+private:
+  uint8_t buf[W * H / 8];
+};
+
+static uint8_t image[(100 + 7) / 8 * 64];
+
+static void noise(uint8_t *p, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    p[i] = rand();
+}
+
+// Same blits on a blitting and a per-pixel target
+template <class T> static void compare(const char *name, uint16_t colors) {
+  T fast, slow;
+  slow.blit = false;
+  noise(fast.bytes(), fast.size());
+  memcpy(slow.bytes(), fast.bytes(), fast.size());
+
+  srand(2);
+  for (int n = 0; n < 20000; n++) {
+    uint8_t r = rand() & 3;
+    int16_t w = rand() % 40 + 1, h = rand() % 40 + 1;
+    int16_t x = rand() % (W + 2 * w) - w - 8, y = rand() % (W + 2 * h) - h - 8;
+    uint16_t fg = rand() % colors, bg = rand() % colors;
+    noise(image, (w + 7) / 8 * h);
+    fast.setRotation(r);
+    slow.setRotation(r);
+    switch (rand() & 3) {
+    case 0: // PROGMEM, transparent
+      fast.drawBitmap(x, y, (const uint8_t *)image, w, h, fg);
+      slow.drawBitmap(x, y, (const uint8_t *)image, w, h, fg);
+      break;
+    case 1: // PROGMEM, opaque
+      fast.drawBitmap(x, y, (const uint8_t *)image, w, h, fg, bg);
+      slow.drawBitmap(x, y, (const uint8_t *)image, w, h, fg, bg);
+      break;
+    case 2: // RAM, transparent
+      fast.drawBitmap(x, y, image, w, h, fg);
+      slow.drawBitmap(x, y, image, w, h, fg);
+      break;
+    default: // RAM, opaque
+      fast.drawBitmap(x, y, image, w, h, fg, bg);
+      slow.drawBitmap(x, y, image, w, h, fg, bg);
+      break;
+    }
+    if (memcmp(fast.bytes(), slow.bytes(), fast.size())) {
+      fprintf(stderr,
+              "%s blit %d: %dx%d at (%d, %d), rotation %d, colors %d/%d "
+              "differs from drawPixel()\n",
+              name, n, w, h, x, y, r, fg, bg);
+      mock_failures++;
+      return;
+    }
+  }
+}
+
+// Blits per second of a 100x50 image, transparent and opaque
+template <class T> static double rate(bool blit, uint8_t r, bool opaque) {
+  T t;
+  t.blit = blit;
+  t.setRotation(r);
+  const int n = blit ? 20000 : 2000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    if (opaque)
+      t.drawBitmap(i & 15, i & 7, image, 100, 50, 1, 0);
+    else
+      t.drawBitmap(i & 15, i & 7, image, 100, 50, 1);
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  return n / s;
+}
+
+template <class T> static void bench(const char *name) {
+  noise(image, sizeof(image));
+  for (uint8_t r = 0; r < 2; r++) {
+    for (int opaque = 0; opaque < 2; opaque++) {
+      double px = rate<T>(false, r, opaque), bl = rate<T>(true, r, opaque);
+      printf("  %s rotation %d %s: writePixel %.0f blits/s, blitBitmap1 "
+             "%.0f blits/s (%.1fx)\n",
+             name, r, opaque ? "opaque" : "transparent", px, bl, bl / px);
+    }
+  }
+}
+
+int main(void) {
+  compare<Canvas1>("GFXcanvas1", 2);
+  compare<Pages>("pages", 3);
+
+  bench<Canvas1>("GFXcanvas1");
+  bench<Pages>("pages");
+
+  if (mock_failures)
+    return 1;
+  printf("bench_blit: ok\n");
+  return 0;
+}
@@ -0,0 +1,332 @@
+// GFXcanvas16 word kernels behind fillRect(), fillScreen(), copyRect(),
+// blendRGBBitmap(), byteSwap() and copyRectSwapped(), against plain
+// per-pixel loops on a model of the raw buffer. Odd widths and a buffer
+// starting on a half word put rows and runs at every alignment; rotations
+// and overlapping self copies take the other paths. Then MPixel/s of each
+// kernel against plain loops over the raw rows. Built a second time with
+// GFX_SWAP16_WORDS=1 for the word swap used on ESP32 cores.
+
+#include <chrono>
+
+#include <Adafruit_GFX.h>
+
+#include "mock_host.h"
+
+// A canvas over caller memory, so its buffer can start off a word boundary
+class Canvas16 : public GFXcanvas16 {
+public:
+  Canvas16(uint16_t w, uint16_t h, uint16_t *mem) : GFXcanvas16(w, h, false) {
+    buffer = mem;
+  }
+};
+
+// The raw buffer, as plain loops see it
+struct Model {
+  int16_t w, h; // Raw size
+  uint8_t r;    // Rotation
+  uint16_t *px;
+
+  int16_t width(void) const { return (r & 1) ? h : w; }
+  int16_t height(void) const { return (r & 1) ? w : h; }
+  // Raw pixel under rotated (x, y)
+  uint16_t &at(int16_t x, int16_t y) {
+    switch (r) {
+    case 1:
+      return px[x * w + (w - 1 - y)];
+    case 2:
+      return px[(h - 1 - y) * w + (w - 1 - x)];
+    case 3:
+      return px[(h - 1 - x) * w + y];
+    default:
+      return px[y * w + x];
+    }
+  }
+  bool in(int16_t x, int16_t y) const {
+    return (x >= 0) && (y >= 0) && (x < width()) && (y < height());
+  }
+};
+
+// Each 5/6/5 channel on its own: c = bg + (fg - bg) * a / 32, rounded down
+static uint16_t blendRef(uint16_t fg, uint16_t bg, uint8_t alpha) {
+  int a = (alpha + 4) >> 3, out = 0;
+  const int shift[] = {11, 5, 0}, mask[] = {0x1F, 0x3F, 0x1F};
+  for (int c = 0; c < 3; c++) {
+    int f = (fg >> shift[c]) & mask[c], b = (bg >> shift[c]) & mask[c];
+    int v = b + (((f - b) * a) >> 5);
+    out |= (v & mask[c]) << shift[c];
+  }
+  return out;
+}
+
+static void refFill(Model *m, int16_t x, int16_t y, int16_t w, int16_t h,
+                    uint16_t color) {
+  if (w < 0)
+    w = -w, x -= w - 1;
+  if (h < 0)
+    h = -h, y -= h - 1;
+  for (int16_t j = y; j < y + h; j++)
+    for (int16_t i = x; i < x + w; i++)
+      if (m->in(i, j))
+        m->at(i, j) = color;
+}
+
+static void refCopy(Model *d, int16_t x, int16_t y, Model *s, int16_t sx,
+                    int16_t sy, int16_t w, int16_t h) {
+  uint16_t *tmp = new uint16_t[(w > 0 && h > 0) ? w * h : 1];
+  for (int16_t j = 0; j < h; j++)
+    for (int16_t i = 0; i < w; i++)
+      if (s->in(sx + i, sy + j))
+        tmp[j * w + i] = s->at(sx + i, sy + j);
+  for (int16_t j = 0; j < h; j++)
+    for (int16_t i = 0; i < w; i++)
+      if (s->in(sx + i, sy + j) && d->in(x + i, y + j))
+        d->at(x + i, y + j) = tmp[j * w + i];
+  delete[] tmp;
+}
+
+static void refBlend(Model *m, int16_t x, int16_t y, const uint16_t *bitmap,
+                     const uint8_t *alpha, int16_t w, int16_t h) {
+  for (int16_t j = 0; j < h; j++) {
+    for (int16_t i = 0; i < w; i++) {
+      uint8_t a = alpha[j * w + i];
+      if (a && m->in(x + i, y + j))
+        m->at(x + i, y + j) = blendRef(bitmap[j * w + i], m->at(x + i, y + j), a);
+    }
+  }
+}
+
+static void refSwap(uint16_t *dst, const uint16_t *src, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = (uint16_t)((src[i] << 8) | (src[i] >> 8));
+}
+
+static bool same(const uint16_t *a, const uint16_t *b, uint32_t n,
+                 const char *what, int step) {
+  for (uint32_t i = 0; i < n; i++) {
+    if (a[i] != b[i]) {
+      fprintf(stderr, "%s, step %d: raw pixel %u is %04X, expected %04X\n",
+              what, step, (unsigned)i, a[i], b[i]);
+      mock_failures++;
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint16_t randomColor(void) {
+  // Now and then both bytes equal, for the memset path
+  uint16_t c = rand();
+  return (rand() % 4) ? c : (c & 0xFF) * 0x0101;
+}
+
+// Random operations on two canvases and their models, checked after each
+static void test_kernels(int16_t w, int16_t h, bool offset) {
+  uint16_t *memA = new uint16_t[w * h + 1], *memB = new uint16_t[w * h + 1];
+  Canvas16 a(w, h, memA + offset), b(w, h, memB + offset);
+  uint16_t *refA = new uint16_t[w * h], *refB = new uint16_t[w * h];
+  Model ma = {w, h, 0, refA}, mb = {w, h, 0, refB};
+  char what[48];
+  snprintf(what, sizeof(what), "%dx%d%s", w, h,
+           offset ? ", buffer on a half word" : "");
+
+  for (int32_t i = 0; i < w * h; i++) {
+    refA[i] = a.getBuffer()[i] = rand();
+    refB[i] = b.getBuffer()[i] = rand();
+  }
+
+  uint16_t bitmap[40 * 40], swapped[64 * 64 + 1], expect[64 * 64];
+  uint8_t alpha[40 * 40];
+  for (int step = 0; step < 4000; step++) {
+    uint8_t r = rand() & 3;
+    a.setRotation(r);
+    ma.r = r;
+    int16_t x = rand() % (w + 20) - 10, y = rand() % (w + 20) - 10;
+    int16_t rw = rand() % 45 - 4, rh = rand() % 45 - 4;
+    switch (rand() % 6) {
+    case 0:
+      if (rand() % 50) {
+        uint16_t c = randomColor();
+        a.fillRect(x, y, rw, rh, c);
+        refFill(&ma, x, y, rw, rh, c);
+      } else {
+        uint16_t c = randomColor();
+        a.fillScreen(c);
+        refFill(&ma, 0, 0, ma.width(), ma.height(), c);
+      }
+      break;
+    case 1: { // From the other canvas, rotated or not
+      uint8_t sr = (rand() % 2) ? r : rand() & 3;
+      b.setRotation(sr);
+      mb.r = sr;
+      int16_t sx = rand() % (w + 20) - 10, sy = rand() % (w + 20) - 10;
+      a.copyRect(x, y, &b, sx, sy, rw, rh);
+      refCopy(&ma, x, y, &mb, sx, sy, rw, rh);
+      break;
+    }
+    case 2: { // Within the canvas, overlapping
+      int16_t sx = x + rand() % 9 - 4, sy = y + rand() % 9 - 4;
+      a.copyRect(x, y, &a, sx, sy, rw, rh);
+      refCopy(&ma, x, y, &ma, sx, sy, rw, rh);
+      break;
+    }
+    case 3: {
+      int16_t bw = rand() % 40 + 1, bh = rand() % 40 + 1;
+      for (int i = 0; i < bw * bh; i++) {
+        bitmap[i] = rand();
+        int k = rand() % 4;
+        alpha[i] = (k == 0) ? 0 : (k == 1) ? 255 : rand();
+      }
+      a.blendRGBBitmap(x, y, bitmap, alpha, bw, bh);
+      refBlend(&ma, x, y, bitmap, alpha, bw, bh);
+      break;
+    }
+    case 4:
+      if (rand() % 20 == 0) {
+        a.byteSwap();
+        refSwap(refA, refA, w * h);
+      }
+      break;
+    default: { // Raw rectangle out, to an odd address as well
+      int16_t sx = rand() % w, sy = rand() % h;
+      int16_t sw = (rand() % 3) ? rand() % (w - sx) + 1 : w - sx;
+      int16_t sh = rand() % min<int16_t>(h - sy, 64 * 64 / sw) + 1;
+      if (rand() & 1)
+        sx = 0, sw = w, sh = min<int16_t>(sh, 64 * 64 / w);
+      uint16_t *out = swapped + (rand() & 1);
+      CHECK(a.copyRectSwapped(sx, sy, sw, sh, out));
+      for (int16_t j = 0; j < sh; j++)
+        refSwap(expect + j * sw, refA + (sy + j) * w + sx, sw);
+      if (!same(out, expect, sw * sh, "copyRectSwapped", step))
+        return;
+      CHECK(!a.copyRectSwapped(sx, sy, w + 1 - sx, 1, out));
+      break;
+    }
+    }
+    if (!same(a.getBuffer(), refA, w * h, what, step))
+      break;
+  }
+  delete[] memA;
+  delete[] memB;
+  delete[] refA;
+  delete[] refB;
+}
+
+// Plain loops over raw rows, for timing. Kept out of line with run-time
+// sizes, as the library's kernels are, so neither gets specialized.
+__attribute__((noinline)) static void loopFill(uint16_t *p, int16_t stride,
+                                               int16_t w, int16_t h,
+                                               uint16_t c) {
+  for (int16_t j = 0; j < h; j++, p += stride)
+    for (int16_t i = 0; i < w; i++)
+      p[i] = c;
+}
+
+__attribute__((noinline)) static void loopCopy(uint16_t *d, const uint16_t *s,
+                                               int16_t stride, int16_t w,
+                                               int16_t h) {
+  for (int16_t j = 0; j < h; j++, d += stride, s += stride)
+    for (int16_t i = 0; i < w; i++)
+      d[i] = s[i];
+}
+
+__attribute__((noinline)) static void
+loopBlend(uint16_t *d, int16_t stride, const uint16_t *s, const uint8_t *a,
+          int16_t w, int16_t h) {
+  for (int16_t j = 0; j < h; j++, d += stride, s += w, a += w)
+    for (int16_t i = 0; i < w; i++)
+      if (a[i])
+        d[i] = blendRef(s[i], d[i], a[i]);
+}
+
+__attribute__((noinline)) static void loopSwap(uint16_t *d, const uint16_t *s,
+                                               int16_t stride, int16_t w,
+                                               int16_t h) {
+  for (int16_t j = 0; j < h; j++, d += w, s += stride)
+    for (int16_t i = 0; i < w; i++)
+      d[i] = (uint16_t)((s[i] << 8) | (s[i] >> 8));
+}
+
+// MPixel/s of run(), n pixels per call
+template <typename F> static double mpixels(long n, F run) {
+  const int calls = 2000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; i++)
+    run(i);
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  return n * calls / s / 1e6;
+}
+
+static void bench(void) {
+  const int16_t w = 320, h = 240;
+  GFXcanvas16 canvas(w, h), other(w, h);
+  uint16_t *raw = canvas.getBuffer(), *src = other.getBuffer();
+  uint16_t *out = new uint16_t[w * h];
+  static uint16_t sprite[64 * 64];
+  static uint8_t alpha[64 * 64];
+  for (int i = 0; i < 64 * 64; i++) {
+    sprite[i] = rand();
+    int k = rand() % 4;
+    alpha[i] = (k == 0) ? 0 : (k == 1) ? 255 : rand();
+  }
+
+  struct Row {
+    const char *name;
+    double kernel, loop;
+  } rows[] = {
+      {"fillRect 317x200 at x=1",
+       mpixels(317 * 200,
+               [&](int i) { canvas.fillRect(1, 20, 317, 200, i * 0x0123); }),
+       mpixels(317 * 200,
+               [&](int i) { loopFill(raw + 20 * w + 1, w, 317, 200, i * 0x0123); })},
+      {"copyRect 320x239 scroll",
+       mpixels(320 * 239,
+               [&](int) { canvas.copyRect(0, 0, &canvas, 0, 1, w, h - 1); }),
+       mpixels(320 * 239, [&](int) { loopCopy(raw, raw + w, w, w, h - 1); })},
+      {"copyRect 201x150 at odd x",
+       mpixels(201 * 150,
+               [&](int) { canvas.copyRect(3, 7, &other, 10, 20, 201, 150); }),
+       mpixels(201 * 150, [&](int) {
+         loopCopy(raw + 7 * w + 3, src + 20 * w + 10, w, 201, 150);
+       })},
+      {"blendRGBBitmap 64x64",
+       mpixels(64 * 64,
+               [&](int i) {
+                 canvas.blendRGBBitmap(i & 63, 17, sprite, alpha, 64, 64);
+               }),
+       mpixels(64 * 64, [&](int i) {
+         loopBlend(raw + 17 * w + (i & 63), w, sprite, alpha, 64, 64);
+       })},
+      {"byteSwap 320x240", mpixels(320 * 240, [&](int) { canvas.byteSwap(); }),
+       mpixels(320 * 240, [&](int) { loopSwap(raw, raw, w, w, h); })},
+      {"copyRectSwapped 199x120",
+       mpixels(199 * 120,
+               [&](int) { canvas.copyRectSwapped(1, 5, 199, 120, out); }),
+       mpixels(199 * 120,
+               [&](int) { loopSwap(out, raw + 5 * w + 1, w, 199, 120); })},
+  };
+  for (auto &r : rows)
+    printf("  %s: %.0f MPixel/s, plain loop %.0f MPixel/s (%.1fx)\n", r.name,
+           r.kernel, r.loop, r.kernel / r.loop);
+  delete[] out;
+}
+
+int main(void) {
+  srand(7);
+  test_kernels(37, 23, false);
+  test_kernels(37, 23, true);
+  test_kernels(64, 33, true);
+  test_kernels(61, 61, false);
+
+  bench();
+
+  if (mock_failures)
+    return 1;
+#if GFX_SWAP16_WORDS
+  printf("bench_canvas16 (word swap): ok\n");
+#else
+  printf("bench_canvas16: ok\n");
+#endif
+  return 0;
+}
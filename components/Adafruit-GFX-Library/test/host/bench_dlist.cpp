@@ -0,0 +1,250 @@
+// GFXdisplayList clipped replay and diff: replay() clipped to a rectangle
+// must paint exactly what drawing straight to a canvas does inside it and
+// nothing outside; replaying the region diff() finds between two frames over
+// the old image must give the new one. Then how much of a status screen a
+// changing value redraws, and what that costs against a full replay.
+
+#include <chrono>
+#include <vector>
+
+#include <Adafruit_GFX.h>
+#include <Fonts/FreeSans12pt7b.h>
+
+#include "mock_host.h"
+
+#define W 240
+#define H 200
+
+struct Op {
+  uint8_t type;
+  int16_t x, y, a, b;
+  uint16_t c;
+};
+
+static const uint8_t arrow[] = {0x18, 0x3C, 0x7E, 0xFF,
+                                0x18, 0x18, 0x18, 0x18};
+static uint16_t rgb[16 * 12];
+
+static Op randomOp(void) {
+  Op op;
+  op.type = rand() % 10;
+  op.x = rand() % (W + 40) - 20;
+  op.y = rand() % (H + 40) - 20;
+  op.a = rand() % 60 + 1;
+  op.b = rand() % 60 + 1;
+  op.c = rand();
+  return op;
+}
+
+static void draw(Adafruit_GFX *gfx, const std::vector<Op> &ops) {
+  gfx->fillScreen(0);
+  for (const Op &op : ops) {
+    switch (op.type) {
+    case 0:
+      gfx->fillRect(op.x, op.y, op.a, op.b, op.c);
+      break;
+    case 1:
+      gfx->drawLine(op.x, op.y, op.x + op.a - 30, op.y + op.b - 30, op.c);
+      break;
+    case 2:
+      gfx->fillCircle(op.x, op.y, op.a / 2, op.c);
+      break;
+    case 3:
+      gfx->drawRoundRect(op.x, op.y, op.a, op.b, op.a / 4, op.c);
+      break;
+    case 4:
+      gfx->fillTriangle(op.x, op.y, op.x + op.a, op.y + 10, op.x + 5,
+                        op.y + op.b, op.c);
+      break;
+    case 5:
+      gfx->setFont((op.a & 1) ? &FreeSans12pt7b : NULL);
+      gfx->setTextSize(1);
+      gfx->setTextColor(op.c);
+      gfx->setCursor(op.x, op.y);
+      gfx->print((op.b & 1) ? "12:34" : "-7.5");
+      break;
+    case 6:
+      gfx->drawBitmap(op.x, op.y, arrow, 8, 8, op.c);
+      break;
+    case 7:
+      gfx->drawRGBBitmap(op.x, op.y, rgb, 16, 12);
+      break;
+    case 8:
+      gfx->drawLineAA(op.x, op.y, op.x + op.a - 30, op.y + op.b - 30, op.c);
+      break;
+    default:
+      gfx->drawCircleAA(op.x, op.y, op.a / 2, op.c);
+      break;
+    }
+  }
+}
+
+static bool sameRect(GFXcanvas16 *a, GFXcanvas16 *b, int16_t x1, int16_t y1,
+                     int16_t x2, int16_t y2, const char *what, int n) {
+  for (int16_t y = y1; y <= y2; y++) {
+    for (int16_t x = x1; x <= x2; x++) {
+      if (a->getPixel(x, y) != b->getPixel(x, y)) {
+        fprintf(stderr, "%s, case %d: pixel (%d, %d) differs\n", what, n, x,
+                y);
+        mock_failures++;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void test_clipped(void) {
+  GFXdisplayList list(W, H, 16384);
+  GFXcanvas16 direct(W, H), target(W, H);
+  srand(10);
+  for (int i = 0; i < 16 * 12; i++)
+    rgb[i] = rand();
+  for (int n = 0; n < 500; n++) {
+    std::vector<Op> ops(rand() % 30 + 1);
+    for (Op &op : ops)
+      op = randomOp();
+    list.clear();
+    draw(&list, ops);
+    CHECK(!list.overflowed());
+    draw(&direct, ops);
+
+    // A rectangle partly off the list, onto a target full of something else
+    int16_t cx = rand() % (W + 20) - 10, cy = rand() % (H + 20) - 10;
+    int16_t cw = rand() % 120, ch = rand() % 120;
+    target.fillScreen(0xA5A5);
+    list.replay(&target, 0, 0, cx, cy, cw, ch);
+    int16_t x1 = max<int16_t>(cx, 0), y1 = max<int16_t>(cy, 0);
+    int16_t x2 = min<int16_t>(cx + cw, W) - 1;
+    int16_t y2 = min<int16_t>(cy + ch, H) - 1;
+    if (!sameRect(&target, &direct, x1, y1, x2, y2, "inside the clip", n))
+      return;
+    for (int16_t y = 0; y < H; y++) {
+      for (int16_t x = 0; x < W; x++) {
+        if ((x >= x1) && (x <= x2) && (y >= y1) && (y <= y2))
+          continue;
+        if (target.getPixel(x, y) != 0xA5A5) {
+          fprintf(stderr, "case %d: pixel (%d, %d) outside the clip drawn\n",
+                  n, x, y);
+          mock_failures++;
+          return;
+        }
+      }
+    }
+  }
+}
+
+static void test_diff(void) {
+  GFXdisplayList prev(W, H, 16384), next(W, H, 16384);
+  GFXcanvas16 image(W, H), expect(W, H);
+  int16_t x1, y1;
+  uint16_t w, h;
+  srand(11);
+  for (int n = 0; n < 1000; n++) {
+    std::vector<Op> ops(rand() % 30 + 1);
+    for (Op &op : ops)
+      op = randomOp();
+    prev.clear();
+    draw(&prev, ops);
+    draw(&image, ops);
+
+    // Unchanged: nothing to redraw
+    next.clear();
+    draw(&next, ops);
+    CHECK(!next.diff(&prev, &x1, &y1, &w, &h));
+    CHECK((w == 0) && (h == 0));
+
+    // Change, insert and delete a few operations
+    for (int k = rand() % 3 + 1; k; k--) {
+      size_t i = rand() % (ops.size() + 1);
+      switch (rand() % 3) {
+      case 0:
+        if (i < ops.size())
+          ops[i].c ^= 0x0821;
+        break;
+      case 1:
+        ops.insert(ops.begin() + i, randomOp());
+        break;
+      default:
+        if (i < ops.size())
+          ops.erase(ops.begin() + i);
+        break;
+      }
+    }
+    next.clear();
+    draw(&next, ops);
+    draw(&expect, ops);
+    if (next.diff(&prev, &x1, &y1, &w, &h))
+      next.replay(&image, 0, 0, x1, y1, w, h);
+    if (!sameRect(&image, &expect, 0, 0, W - 1, H - 1, "old image + diff", n))
+      return;
+  }
+
+  // No previous list: all of it
+  CHECK(next.diff(NULL, &x1, &y1, &w, &h));
+  CHECK((x1 == 0) && (y1 == 0) && (w == W) && (h == H));
+}
+
+// A status screen with one value that changes every frame
+static void status(Adafruit_GFX *gfx, int value) {
+  gfx->fillScreen(0);
+  gfx->fillRect(0, 0, W, 30, 0x001F);
+  gfx->setFont(&FreeSans12pt7b);
+  gfx->setTextSize(1);
+  gfx->setTextColor(0xFFFF);
+  gfx->setCursor(8, 22);
+  gfx->print("Boiler 2");
+  const char *labels[] = {"Flow", "Return", "Pressure", "Load"};
+  for (int i = 0; i < 4; i++) {
+    gfx->setCursor(8, 60 + i * 28);
+    gfx->print(labels[i]);
+    char text[8];
+    snprintf(text, sizeof(text), "%d", i ? 40 + i : value);
+    gfx->setCursor(160, 60 + i * 28);
+    gfx->print(text);
+  }
+  gfx->drawRoundRect(8, 170, 224, 24, 6, 0x7BEF);
+}
+
+static void bench(void) {
+  GFXdisplayList a(W, H), b(W, H);
+  GFXdisplayList *prev = &a, *next = &b;
+  GFXcanvas16 image(W, H);
+  const int n = 2000;
+  long area = 0;
+  double full = 0, clipped = 0;
+  status(prev, 0);
+  prev->replay(&image);
+  for (int i = 1; i <= n; i++) {
+    next->clear();
+    status(next, i % 100);
+    int16_t x1, y1;
+    uint16_t w, h;
+    auto t0 = std::chrono::steady_clock::now();
+    if (next->diff(prev, &x1, &y1, &w, &h))
+      next->replay(&image, 0, 0, x1, y1, w, h);
+    auto t1 = std::chrono::steady_clock::now();
+    next->replay(&image);
+    auto t2 = std::chrono::steady_clock::now();
+    area += (long)w * h;
+    clipped += std::chrono::duration<double>(t1 - t0).count();
+    full += std::chrono::duration<double>(t2 - t1).count();
+    std::swap(prev, next);
+  }
+  printf("  %dx%d status screen, one value changing: list %u bytes, redraws "
+         "%.1f%% of the screen; diff + clipped replay %.1f us, full replay "
+         "%.1f us (%.1fx)\n",
+         W, H, prev->size(), 100.0 * area / n / (W * H), clipped / n * 1e6,
+         full / n * 1e6, full / clipped);
+}
+
+int main(void) {
+  test_clipped();
+  test_diff();
+  bench();
+
+  if (mock_failures)
+    return 1;
+  printf("bench_dlist: ok\n");
+  return 0;
+}
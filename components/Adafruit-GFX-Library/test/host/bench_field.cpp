@@ -0,0 +1,167 @@
+// Adafruit_GFX_NumericField: after every update the field must look exactly
+// like its box cleared to the background with each character drawChar()'d
+// at its cell, for 1-bit and RGB atlases in every rotation. Then fields/s of
+// a counter readout against clearing the box and print()ing the text.
+
+#include <chrono>
+
+#include <Adafruit_GFX.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans9pt7b.h>
+
+#include "mock_host.h"
+
+#define CHARS 7
+
+// The cell box begin() derives from "0-9 . - space", relative to the cursor
+static void cellBox(const GFXfont *font, int16_t *minx, int16_t *miny,
+                    int16_t *w, int16_t *h) {
+  int16_t maxx = 0, maxy = 0;
+  *minx = *miny = 0;
+  for (const char *c = "0123456789.- "; *c; c++) {
+    const GFXglyph *g = &font->glyph[*c - font->first];
+    *minx = min<int16_t>(*minx, g->xOffset);
+    *miny = min<int16_t>(*miny, g->yOffset);
+    maxx = max<int16_t>(maxx, max<int16_t>(g->xAdvance, g->xOffset + g->width));
+    maxy = max<int16_t>(maxy, g->yOffset + g->height);
+  }
+  *w = maxx - *minx;
+  *h = maxy - *miny;
+}
+
+// What the field should show for text: right-aligned, unknown characters
+// blank and too-long text all '-'
+static void drawExpected(Adafruit_GFX *gfx, const GFXfont *font, int16_t x,
+                         int16_t y, const char *text, uint16_t color,
+                         uint16_t bg) {
+  int16_t minx, miny, w, h;
+  cellBox(font, &minx, &miny, &w, &h);
+  gfx->setFont(font);
+  gfx->fillRect(x + minx, y + miny, w * CHARS, h, bg);
+  size_t len = strlen(text);
+  for (int i = 0; i < CHARS; i++) {
+    char c = ' ';
+    if (len > CHARS)
+      c = '-';
+    else if (i >= CHARS - (int)len)
+      c = text[i - (CHARS - len)];
+    if (!strchr("0123456789.-", c))
+      continue;
+    gfx->drawChar(x + i * w, y, c, color, bg, 1);
+  }
+}
+
+template <class T>
+static bool same(T *a, T *b, const char *name, int n, const char *text) {
+  for (int16_t y = 0; y < a->height(); y++) {
+    for (int16_t x = 0; x < a->width(); x++) {
+      if (a->getPixel(x, y) != b->getPixel(x, y)) {
+        fprintf(stderr, "%s update %d \"%s\": pixel (%d, %d) differs\n", name,
+                n, text, x, y);
+        mock_failures++;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <class T>
+static void test_field(const char *name, uint8_t depth, uint16_t color,
+                       uint16_t bg) {
+  const GFXfont *fonts[] = {&FreeSans9pt7b, &FreeSans12pt7b};
+  srand(4);
+  for (int f = 0; f < 2; f++) {
+    for (uint8_t r = 0; r < 4; r++) {
+      T canvas(160, 100), expect(160, 100);
+      canvas.setRotation(r);
+      expect.setRotation(r);
+      canvas.fillScreen(color);
+      int16_t x = 6, y = 40;
+      Adafruit_GFX_NumericField field;
+      CHECK(field.begin(&canvas, fonts[f], x, y, CHARS, color, bg, depth));
+
+      char text[24];
+      for (int n = 0; n < 300; n++) {
+        switch (rand() % 4) {
+        case 0:
+          snprintf(text, sizeof(text), "%ld", (long)(rand() % 200001) - 100000);
+          field.print(atol(text));
+          break;
+        case 1: {
+          long k = rand() % 2000001 - 1000000;
+          snprintf(text, sizeof(text), "%.2f", k / 100.0);
+          field.print(k / 100.0, 2);
+          break;
+        }
+        case 2: // Too long, or with characters the atlas lacks
+          strcpy(text, (rand() & 1) ? "12345678" : "1e-3 x");
+          field.print(text);
+          break;
+        default:
+          snprintf(text, sizeof(text), "%d", rand() % 100);
+          field.print(text);
+          break;
+        }
+        expect.fillScreen(color);
+        drawExpected(&expect, fonts[f], x, y, text, color, bg);
+        if (!same(&canvas, &expect, name, n, text))
+          return;
+      }
+    }
+  }
+}
+
+// Updates per second of a counter that mostly changes its last digits
+template <class T>
+static double rate(uint8_t depth, uint16_t color, uint16_t bg, bool field) {
+  T canvas(240, 64);
+  canvas.setFont(&FreeSans12pt7b);
+  canvas.setTextColor(color);
+  int16_t minx, miny, w, h;
+  cellBox(&FreeSans12pt7b, &minx, &miny, &w, &h);
+  Adafruit_GFX_NumericField f;
+  CHECK(f.begin(&canvas, &FreeSans12pt7b, 10, 40, CHARS, color, bg, depth));
+  const long n = 100000;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < n; i++) {
+    if (field) {
+      f.print(i * 7);
+    } else {
+      // Clear the same box and draw the text the usual way
+      canvas.fillRect(10 + minx, 40 + miny, w * CHARS, h, bg);
+      char text[12];
+      snprintf(text, sizeof(text), "%ld", i * 7);
+      canvas.setCursor(10, 40);
+      canvas.print(text);
+    }
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  return n / s;
+}
+
+template <class T>
+static void bench(const char *name, uint8_t depth, uint16_t color,
+                  uint16_t bg) {
+  double p = rate<T>(depth, color, bg, false), f = rate<T>(depth, color, bg, true);
+  printf("  %s, %d-bit atlas: fillRect + print %.0fk fields/s, "
+         "NumericField %.0fk fields/s (%.1fx)\n",
+         name, depth, p / 1000, f / 1000, f / p);
+}
+
+int main(void) {
+  test_field<GFXcanvas1>("GFXcanvas1", 1, 1, 0);
+  test_field<GFXcanvas16>("GFXcanvas16", 16, 0xFFE0, 0x001F);
+  test_field<GFXcanvas16>("GFXcanvas16", 1, 0x07E0, 0x0000);
+
+  bench<GFXcanvas1>("GFXcanvas1", 1, 1, 0);
+  bench<GFXcanvas16>("GFXcanvas16", 16, 0xFFE0, 0x001F);
+  bench<GFXcanvas16>("GFXcanvas16", 1, 0xFFE0, 0x001F);
+
+  if (mock_failures)
+    return 1;
+  printf("bench_field: ok\n");
+  return 0;
+}
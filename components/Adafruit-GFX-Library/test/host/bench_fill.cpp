@@ -0,0 +1,413 @@
+// Span fills against the fills they replaced. fillTriangle(), fillCircle(),
+// fillCircleHelper(), fillRoundRect() and fillEllipse() must set exactly the
+// pixels of the previous line-by-line code, drawn here a pixel at a time,
+// for random, degenerate and clipped shapes in every rotation, and never
+// write a pixel twice. Then time per call against the previous code's
+// writeFastHLine()/writeFastVLine() calls on GFXcanvas1 and GFXcanvas16.
+
+#include <chrono>
+
+#include <Adafruit_GFX.h>
+
+#include "mock_host.h"
+
+#define W 160
+#define H 128
+
+// Reference lines: a pixel at a time, or the target's own line fills
+static bool pixels;
+
+static void hline(Adafruit_GFX *g, int16_t x, int16_t y, int16_t w,
+                  uint16_t color) {
+  if (!pixels) {
+    g->writeFastHLine(x, y, w, color);
+    return;
+  }
+  for (int16_t i = 0; i < w; i++)
+    g->drawPixel(x + i, y, color);
+}
+
+static void vline(Adafruit_GFX *g, int16_t x, int16_t y, int16_t h,
+                  uint16_t color) {
+  if (!pixels) {
+    g->writeFastVLine(x, y, h, color);
+    return;
+  }
+  for (int16_t i = 0; i < h; i++)
+    g->drawPixel(x, y + i, color);
+}
+
+// The fills as they were before spans, drawing through hline()/vline()
+
+static void refCircleHelper(Adafruit_GFX *g, int16_t x0, int16_t y0, int16_t r,
+                            uint8_t corners, int16_t delta, uint16_t color) {
+  int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+  delta++;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < (y + 1)) {
+      if (corners & 1)
+        vline(g, x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2)
+        vline(g, x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py) {
+      if (corners & 1)
+        vline(g, x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2)
+        vline(g, x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+static void refCircle(Adafruit_GFX *g, int16_t x0, int16_t y0, int16_t r,
+                      uint16_t color) {
+  vline(g, x0, y0 - r, 2 * r + 1, color);
+  refCircleHelper(g, x0, y0, r, 3, 0, color);
+}
+
+static void refRoundRect(Adafruit_GFX *g, int16_t x, int16_t y, int16_t w,
+                         int16_t h, int16_t r, uint16_t color) {
+  int16_t max_radius = ((w < h) ? w : h) / 2;
+  if (r > max_radius)
+    r = max_radius;
+  for (int16_t i = x + r; i < x + w - r; i++)
+    vline(g, i, y, h, color);
+  refCircleHelper(g, x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  refCircleHelper(g, x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+static void refTriangle(Adafruit_GFX *g, int16_t x0, int16_t y0, int16_t x1,
+                        int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+  int16_t a, b, y, last, t;
+#define SWAP(p, q) (t = p, p = q, q = t)
+  if (y0 > y1)
+    SWAP(y0, y1), SWAP(x0, x1);
+  if (y1 > y2)
+    SWAP(y2, y1), SWAP(x2, x1);
+  if (y0 > y1)
+    SWAP(y0, y1), SWAP(x0, x1);
+  if (y0 == y2) {
+    a = min(x0, min(x1, x2));
+    b = max(x0, max(x1, x2));
+    hline(g, a, y0, b - a + 1, color);
+    return;
+  }
+  int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0,
+          dx12 = x2 - x1, dy12 = y2 - y1;
+  int32_t sa = 0, sb = 0;
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b)
+      SWAP(a, b);
+    hline(g, a, y, b - a + 1, color);
+  }
+  sa = (int32_t)dx12 * (y - y1);
+  sb = (int32_t)dx02 * (y - y0);
+  for (; y <= y2; y++) {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b)
+      SWAP(a, b);
+    hline(g, a, y, b - a + 1, color);
+  }
+#undef SWAP
+}
+
+static void refEllipse(Adafruit_GFX *g, int16_t x0, int16_t y0, int16_t rw,
+                       int16_t rh, uint16_t color) {
+  int16_t x = 0, y = rh;
+  int32_t rw2 = rw * rw, rh2 = rh * rh, twoRw2 = 2 * rw2, twoRh2 = 2 * rh2;
+  int32_t decision = rh2 - (rw2 * rh) + (rw2 / 4);
+  while ((twoRh2 * x) < (twoRw2 * y)) {
+    x++;
+    if (decision < 0) {
+      decision += rh2 + (twoRh2 * x);
+    } else {
+      decision += rh2 + (twoRh2 * x) - (twoRw2 * y);
+      hline(g, x0 - (x - 1), y0 + y, 2 * (x - 1) + 1, color);
+      hline(g, x0 - (x - 1), y0 - y, 2 * (x - 1) + 1, color);
+      y--;
+    }
+  }
+  decision = ((rh2 * (2 * x + 1) * (2 * x + 1)) >> 2) +
+             (rw2 * (y - 1) * (y - 1)) - (rw2 * rh2);
+  while (y >= 0) {
+    hline(g, x0 - x, y0 + y, 2 * x + 1, color);
+    hline(g, x0 - x, y0 - y, 2 * x + 1, color);
+    y--;
+    if (decision > 0) {
+      decision += rw2 - (twoRw2 * y);
+    } else {
+      decision += rw2 + (twoRh2 * x) - (twoRw2 * y);
+      x++;
+    }
+  }
+}
+
+// One random shape, drawn with the library or with the reference
+struct Shape {
+  uint8_t kind;
+  int16_t a[7];
+};
+
+static Shape randomShape(void) {
+  Shape s;
+  s.kind = rand() % 5;
+  for (int i = 0; i < 7; i++)
+    s.a[i] = rand() % (W + 120) - 60;
+  switch (s.kind) {
+  case 0: // Triangles, now and then degenerate
+    switch (rand() % 6) {
+    case 0: // Flat
+      s.a[3] = s.a[5] = s.a[1];
+      break;
+    case 1: // Two vertices the same
+      s.a[2] = s.a[0], s.a[3] = s.a[1];
+      break;
+    case 2: // A point
+      s.a[2] = s.a[4] = s.a[0], s.a[3] = s.a[5] = s.a[1];
+      break;
+    case 3: // Vertical, or on a line
+      s.a[2] = s.a[4] = s.a[0];
+      break;
+    case 4: // Far off screen on both sides
+      s.a[0] = -300, s.a[4] = W + 300;
+      break;
+    }
+    break;
+  case 1: // Circles
+  case 2: // Half circles stretched by delta
+    s.a[2] = rand() % 70;
+    s.a[3] = rand() % 3 + 1;
+    s.a[4] = rand() % 40;
+    break;
+  case 3: // Round rects, sizes from 1
+    s.a[2] = rand() % 170 + 1;
+    s.a[3] = rand() % 140 + 1;
+    s.a[4] = rand() % 60;
+    break;
+  default: // Ellipses, including flat ones
+    s.a[2] = rand() % 80;
+    s.a[3] = (rand() % 4) ? rand() % 60 : rand() % 2;
+    break;
+  }
+  return s;
+}
+
+static void draw(Adafruit_GFX *g, const Shape &s, uint16_t c, bool ref) {
+  const int16_t *a = s.a;
+  switch (s.kind) {
+  case 0:
+    if (ref)
+      refTriangle(g, a[0], a[1], a[2], a[3], a[4], a[5], c);
+    else
+      g->fillTriangle(a[0], a[1], a[2], a[3], a[4], a[5], c);
+    break;
+  case 1:
+    if (ref)
+      refCircle(g, a[0], a[1], a[2], c);
+    else
+      g->fillCircle(a[0], a[1], a[2], c);
+    break;
+  case 2:
+    if (ref)
+      refCircleHelper(g, a[0], a[1], a[2], a[3], a[4], c);
+    else
+      g->fillCircleHelper(a[0], a[1], a[2], a[3], a[4], c);
+    break;
+  case 3:
+    if (ref)
+      refRoundRect(g, a[0], a[1], a[2], a[3], a[4], c);
+    else
+      g->fillRoundRect(a[0], a[1], a[2], a[3], a[4], c);
+    break;
+  default:
+    if (ref)
+      refEllipse(g, a[0], a[1], a[2], a[3], c);
+    else
+      g->fillEllipse(a[0], a[1], a[2], a[3], c);
+    break;
+  }
+}
+
+// Counts the writes to every pixel. Spans go through the default
+// writeSpans(), as rows or, if asked, as columns.
+class Counter : public Adafruit_GFX {
+public:
+  Counter(bool vertical) : Adafruit_GFX(W, H), vertical(vertical) { clear(); }
+  void clear(void) { memset(count, 0, sizeof(count)); }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+      return;
+    int16_t t;
+    switch (getRotation()) {
+    case 1:
+      t = x, x = WIDTH - y - 1, y = t;
+      break;
+    case 2:
+      x = WIDTH - x - 1;
+      y = HEIGHT - y - 1;
+      break;
+    case 3:
+      t = x, x = y, y = HEIGHT - t - 1;
+      break;
+    }
+    count[y][x]++;
+  }
+  uint8_t count[H][W];
+
+protected:
+  bool verticalSpans(void) const { return vertical; }
+
+private:
+  bool vertical;
+};
+
+static const char *const kinds[] = {"fillTriangle", "fillCircle",
+                                    "fillCircleHelper", "fillRoundRect",
+                                    "fillEllipse"};
+
+static void report(const char *target, int n, const Shape &s, int16_t x,
+                   int16_t y, const char *what) {
+  fprintf(stderr, "%s shape %d: %s(%d, %d, %d, %d, %d, %d): pixel (%d, %d) %s\n",
+          target, n, kinds[s.kind], s.a[0], s.a[1], s.a[2], s.a[3], s.a[4],
+          s.a[5], x, y, what);
+  mock_failures++;
+}
+
+static void test_counts(bool vertical) {
+  const char *name = vertical ? "column spans" : "row spans";
+  Counter fast(vertical), slow(false);
+  srand(5);
+  pixels = true;
+  for (int n = 0; n < 6000; n++) {
+    Shape s = randomShape();
+    uint8_t r = rand() & 3;
+    fast.setRotation(r);
+    slow.setRotation(r);
+    fast.clear();
+    slow.clear();
+    draw(&fast, s, 1, false);
+    draw(&slow, s, 1, true);
+    for (int16_t y = 0; y < H; y++) {
+      for (int16_t x = 0; x < W; x++) {
+        if (!fast.count[y][x] != !slow.count[y][x]) {
+          report(name, n, s, x, y,
+                 fast.count[y][x] ? "set, not in the old fill"
+                                  : "missing from the fill");
+          return;
+        }
+        if (fast.count[y][x] > 1) {
+          report(name, n, s, x, y, "written twice");
+          return;
+        }
+      }
+    }
+  }
+
+  // Negative sizes draw nothing
+  fast.clear();
+  fast.setRotation(0);
+  fast.fillRoundRect(50, 50, -20, 30, 5, 1);
+  fast.fillRoundRect(50, 50, 20, -30, 5, 1);
+  fast.fillRoundRect(50, 50, 0, 30, 0, 1);
+  fast.fillCircle(50, 50, -3, 1);
+  for (int16_t y = 0; y < H; y++)
+    for (int16_t x = 0; x < W; x++)
+      CHECK_EQ(fast.count[y][x], 0);
+}
+
+// The canvases' writeSpans() against the reference, colors and all
+template <class T> static void test_canvas(const char *name) {
+  T fast(W, H), slow(W, H);
+  srand(6);
+  pixels = true;
+  for (int n = 0; n < 1500; n++) {
+    Shape s = randomShape();
+    uint8_t r = rand() & 3;
+    uint16_t c = rand();
+    fast.setRotation(r);
+    slow.setRotation(r);
+    draw(&fast, s, c, false);
+    draw(&slow, s, c, true);
+    if ((n % 50) && (n != 1499))
+      continue;
+    fast.setRotation(0);
+    slow.setRotation(0);
+    for (int16_t y = 0; y < H; y++) {
+      for (int16_t x = 0; x < W; x++) {
+        if (fast.getPixel(x, y) != slow.getPixel(x, y)) {
+          report(name, n, s, x, y, "differs");
+          return;
+        }
+      }
+    }
+  }
+}
+
+// Microseconds per call of a shape, spans against the old line calls
+template <class T>
+static void bench(const char *name, uint8_t r, const Shape &s,
+                  const char *label) {
+  T canvas(W, H);
+  canvas.setRotation(r);
+  pixels = false;
+  double us[2];
+  for (int ref = 0; ref < 2; ref++) {
+    const int n = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+      draw(&canvas, s, i & 1, ref);
+    us[ref] = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - start)
+                  .count() /
+              n;
+  }
+  printf("  %s rotation %d, %s: %.2f us, was %.2f us (%.1fx)\n", name, r,
+         label, us[0], us[1], us[1] / us[0]);
+}
+
+template <class T> static void benchAll(const char *name) {
+  const struct {
+    Shape s;
+    const char *label;
+  } shapes[] = {{{1, {80, 64, 50}}, "fillCircle r=50"},
+                {{3, {5, 14, 150, 100, 12}}, "fillRoundRect 150x100 r=12"},
+                {{0, {5, 5, 150, 40, 60, 120}}, "fillTriangle"},
+                {{4, {80, 64, 70, 50}}, "fillEllipse 70x50"}};
+  for (uint8_t r = 0; r < 2; r++)
+    for (auto &s : shapes)
+      bench<T>(name, r, s.s, s.label);
+}
+
+int main(void) {
+  test_counts(false);
+  test_counts(true);
+  test_canvas<GFXcanvas1>("GFXcanvas1");
+  test_canvas<GFXcanvas8>("GFXcanvas8");
+  test_canvas<GFXcanvas16>("GFXcanvas16");
+
+  benchAll<GFXcanvas1>("GFXcanvas1");
+  benchAll<GFXcanvas16>("GFXcanvas16");
+
+  if (mock_failures)
+    return 1;
+  printf("bench_fill: ok\n");
+  return 0;
+}
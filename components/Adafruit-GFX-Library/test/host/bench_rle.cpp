@@ -0,0 +1,138 @@
+// GFX_FONT_RLE glyphs: bundled fonts re-encoded the way fontconvert -r
+// writes them must draw exactly the pixels of the packed originals, on
+// GFXcanvas1 (glyph blits) and GFXcanvas16 (spans), in every rotation and at
+// sizes 1-2. Then bitmap bytes and digits/s, packed against RLE.
+
+#include <chrono>
+#include <vector>
+
+#include <Adafruit_GFX.h>
+#include <Fonts/FreeSans9pt7b.h>
+#include <Fonts/FreeSansBoldOblique24pt7b.h>
+#include <Fonts/JetBrainsMono/JetBrainsMonoExtraBold24pt7b.h>
+#include <Fonts/Oxanium/OxaniumBold24pt7b.h>
+
+#include "mock_host.h"
+
+static const struct {
+  const GFXfont *font;
+  const char *name;
+} fonts[] = {{&FreeSans9pt7b, "FreeSans9pt"},
+             {&FreeSansBoldOblique24pt7b, "FreeSansBoldOblique24pt"},
+             {&JetBrainsMono_ExtraBold24pt7b, "JetBrainsMonoExtraBold24pt"},
+             {&Oxanium_Bold24pt7b, "OxaniumBold24pt"}};
+
+// A packed font and its RLE copy
+struct RleFont {
+  std::vector<uint8_t> bitmap;
+  std::vector<GFXglyph> glyphs;
+  GFXfont font;
+};
+
+// fontconvert.c enrle(), reading the packed bitmap instead of FreeType's
+static void encode(const GFXfont *packed, RleFont *out) {
+  out->glyphs.assign(packed->glyph,
+                     packed->glyph + (packed->last - packed->first + 1));
+  for (GFXglyph &g : out->glyphs) {
+    const uint8_t *src = &packed->bitmap[g.bitmapOffset];
+    g.bitmapOffset = out->bitmap.size();
+    int unlit = 0, lit = 0;
+    for (int bit = 0; bit < g.width * g.height; bit++) {
+      if (src[bit >> 3] & (0x80 >> (bit & 7))) {
+        if (lit == 15) {
+          out->bitmap.push_back((unlit << 4) | lit);
+          unlit = lit = 0;
+        }
+        lit++;
+      } else {
+        if (lit || (unlit == 15)) {
+          out->bitmap.push_back((unlit << 4) | lit);
+          unlit = lit = 0;
+        }
+        unlit++;
+      }
+    }
+    if (unlit || lit)
+      out->bitmap.push_back((unlit << 4) | lit);
+  }
+  out->font = {out->bitmap.data(), out->glyphs.data(), packed->first,
+               packed->last,       packed->yAdvance,   GFX_FONT_RLE};
+}
+
+static size_t packedBytes(const GFXfont *font) {
+  const GFXglyph *last = &font->glyph[font->last - font->first];
+  return last->bitmapOffset + (last->width * last->height + 7) / 8;
+}
+
+template <class T>
+static void test_glyphs(const char *name, const GFXfont *packed,
+                        const GFXfont *rle) {
+  T a(200, 160), b(200, 160);
+  srand(5);
+  for (int n = 0; n < 2000; n++) {
+    uint8_t r = rand() & 3, size = rand() % 2 + 1;
+    int16_t x = rand() % 240 - 30, y = rand() % 200 - 10;
+    unsigned char c =
+        packed->first + rand() % (packed->last - packed->first + 1);
+    uint16_t color = rand() & 1 ? 0xFFFF : rand();
+    a.setRotation(r);
+    b.setRotation(r);
+    a.setFont(packed);
+    b.setFont(rle);
+    a.drawChar(x, y, c, color, color, size, size);
+    b.drawChar(x, y, c, color, color, size, size);
+  }
+  for (int16_t y = 0; y < a.height(); y++) {
+    for (int16_t x = 0; x < a.width(); x++) {
+      if (a.getPixel(x, y) != b.getPixel(x, y)) {
+        fprintf(stderr, "%s: pixel (%d, %d) differs between packed and RLE\n",
+                name, x, y);
+        mock_failures++;
+        return;
+      }
+    }
+  }
+}
+
+// Digits per second drawn across the canvas, line by line
+template <class T> static double rate(const GFXfont *font) {
+  T canvas(320, 240);
+  canvas.setFont(font);
+  canvas.setTextWrap(false);
+  canvas.setTextColor(1);
+  static const char digits[] = "0123456789";
+  int16_t line = font->yAdvance, lines = 240 / line;
+  const int n = 2000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    canvas.setCursor(0, line * (1 + i % lines) - line / 4);
+    canvas.print(digits);
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  return n * (sizeof(digits) - 1) / s;
+}
+
+int main(void) {
+  for (auto &f : fonts) {
+    RleFont rle;
+    encode(f.font, &rle);
+    test_glyphs<GFXcanvas1>(f.name, f.font, &rle.font);
+    test_glyphs<GFXcanvas16>(f.name, f.font, &rle.font);
+
+    double p1 = rate<GFXcanvas1>(f.font), r1 = rate<GFXcanvas1>(&rle.font),
+           p16 = rate<GFXcanvas16>(f.font), r16 = rate<GFXcanvas16>(&rle.font);
+    printf("  %s: packed %zu bytes, RLE %zu bytes (%.0f%%); digits "
+           "GFXcanvas1 %.0fk/s vs %.0fk/s (%.1fx), GFXcanvas16 %.0fk/s vs "
+           "%.0fk/s (%.1fx)\n",
+           f.name, packedBytes(f.font), rle.bitmap.size(),
+           100.0 * rle.bitmap.size() / packedBytes(f.font), p1 / 1000,
+           r1 / 1000, r1 / p1, p16 / 1000, r16 / 1000, r16 / p16);
+  }
+
+  if (mock_failures)
+    return 1;
+  printf("bench_rle: ok\n");
+  return 0;
+}
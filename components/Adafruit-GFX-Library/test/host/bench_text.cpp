@@ -0,0 +1,171 @@
+// GFXfont text: getTextBounds() with a GFXtextCache must agree with
+// measuring, wherever the string starts; drawChar() must set the same pixels
+// as the per-pixel loop it replaced; then print() chars/s per font and text
+// size on GFXcanvas1 (glyph blits) and GFXcanvas16 (spans), against that loop.
+
+#include <chrono>
+
+#include <Adafruit_GFX.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans18pt7b.h>
+#include <Fonts/FreeSans24pt7b.h>
+#include <Fonts/FreeSans9pt7b.h>
+
+#include "mock_host.h"
+
+static const struct {
+  const GFXfont *font;
+  const char *name;
+} fonts[] = {{&FreeSans9pt7b, "FreeSans9pt"},
+             {&FreeSans12pt7b, "FreeSans12pt"},
+             {&FreeSans18pt7b, "FreeSans18pt"},
+             {&FreeSans24pt7b, "FreeSans24pt"}};
+
+// The pre-span drawChar() body for custom fonts: one pixel (or one
+// size_x * size_y rectangle) per lit bit
+static void drawCharPixels(Adafruit_GFX *gfx, const GFXfont *font, int16_t x,
+                           int16_t y, unsigned char c, uint16_t color,
+                           uint8_t size_x, uint8_t size_y) {
+  const GFXglyph *glyph = &font->glyph[c - font->first];
+  const uint8_t *bitmap = font->bitmap;
+  uint16_t bo = glyph->bitmapOffset;
+  uint8_t bits = 0, bit = 0;
+  for (uint8_t yy = 0; yy < glyph->height; yy++) {
+    for (uint8_t xx = 0; xx < glyph->width; xx++) {
+      if (!(bit++ & 7))
+        bits = bitmap[bo++];
+      if (bits & 0x80) {
+        if (size_x == 1 && size_y == 1)
+          gfx->drawPixel(x + glyph->xOffset + xx, y + glyph->yOffset + yy,
+                         color);
+        else
+          gfx->fillRect(x + (glyph->xOffset + xx) * size_x,
+                        y + (glyph->yOffset + yy) * size_y, size_x, size_y,
+                        color);
+      }
+      bits <<= 1;
+    }
+  }
+}
+
+// print() without wrap, drawn the old way
+static void printPixels(Adafruit_GFX *gfx, const GFXfont *font, int16_t x,
+                        int16_t y, const char *s, uint16_t color,
+                        uint8_t size) {
+  for (; *s; s++) {
+    drawCharPixels(gfx, font, x, y, *s, color, size, size);
+    x += font->glyph[*s - font->first].xAdvance * size;
+  }
+}
+
+static void test_bounds(void) {
+  GFXcanvas1 canvas(128, 64);
+  GFXtextCache cache;
+  canvas.setFont(&FreeSans9pt7b);
+  canvas.setTextWrap(false);
+  canvas.setTextCache(&cache);
+
+  const char *strings[] = {"12:34", "AB\ncd", "\nx", "-42.0", "Wide\n1"};
+  // Off to the left first: bounds that miss the screen must not be cached
+  int16_t xs[] = {-200, 10, 50, -30, 0};
+  for (const char *s : strings) {
+    for (int16_t x : xs) {
+      int16_t x1, y1, ex1, ey1;
+      uint16_t w, h, ew, eh;
+      canvas.getTextBounds(s, x, 20, &x1, &y1, &w, &h);
+      canvas.setTextCache(NULL);
+      canvas.getTextBounds(s, x, 20, &ex1, &ey1, &ew, &eh);
+      canvas.setTextCache(&cache);
+      if ((x1 != ex1) || (y1 != ey1) || (w != ew) || (h != eh)) {
+        fprintf(stderr,
+                "\"%s\" at x %d: cached bounds (%d, %d) %ux%u, measured "
+                "(%d, %d) %ux%u\n",
+                s, x, x1, y1, w, h, ex1, ey1, ew, eh);
+        mock_failures++;
+      }
+    }
+  }
+  // Single-line strings measured on screen come from the cache
+  CHECK(cache.hits > 0);
+}
+
+template <class T> static void test_glyphs(const char *name) {
+  T fast(160, 160), slow(160, 160);
+  srand(3);
+  for (int n = 0; n < 3000; n++) {
+    const GFXfont *font = fonts[rand() % 4].font;
+    uint8_t r = rand() & 3, size = rand() % 2 + 1;
+    int16_t x = rand() % 200 - 30, y = rand() % 200 - 10;
+    unsigned char c = font->first + rand() % (font->last - font->first + 1);
+    uint16_t color = rand() & 1 ? 0xFFFF : rand();
+    fast.setRotation(r);
+    slow.setRotation(r);
+    fast.setFont(font);
+    fast.drawChar(x, y, c, color, color, size, size);
+    drawCharPixels(&slow, font, x, y, c, color, size, size);
+  }
+  int16_t w = fast.width(), h = fast.height();
+  for (int16_t y = 0; y < h; y++) {
+    for (int16_t x = 0; x < w; x++) {
+      if (fast.getPixel(x, y) != slow.getPixel(x, y)) {
+        fprintf(stderr, "%s: pixel (%d, %d) differs from the per-pixel "
+                        "drawChar()\n",
+                name, x, y);
+        mock_failures++;
+        return;
+      }
+    }
+  }
+}
+
+static const char text[] = "Temp 21.5C 0123456789";
+
+// Characters per second printing text at the left edge, line by line
+template <class T>
+static double rate(const GFXfont *font, uint8_t size, bool pixels) {
+  T canvas(320, 240);
+  canvas.setFont(font);
+  canvas.setTextSize(size);
+  canvas.setTextWrap(false);
+  canvas.setTextColor(1);
+  int16_t line = font->yAdvance * size, lines = 240 / line;
+  const int n = pixels ? 100 : 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    int16_t y = line * (1 + i % lines) - line / 4;
+    if (pixels) {
+      printPixels(&canvas, font, 0, y, text, 1, size);
+    } else {
+      canvas.setCursor(0, y);
+      canvas.print(text);
+    }
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  return n * (sizeof(text) - 1) / s;
+}
+
+int main(void) {
+  test_bounds();
+  test_glyphs<GFXcanvas1>("GFXcanvas1");
+  test_glyphs<GFXcanvas16>("GFXcanvas16");
+
+  for (auto &f : fonts) {
+    for (uint8_t size = 1; size <= 2; size++) {
+      double b1 = rate<GFXcanvas1>(f.font, size, true),
+             p1 = rate<GFXcanvas1>(f.font, size, false),
+             b16 = rate<GFXcanvas16>(f.font, size, true),
+             p16 = rate<GFXcanvas16>(f.font, size, false);
+      printf("  %s size %d: GFXcanvas1 %.0fk chars/s (per-pixel %.0fk, "
+             "%.1fx), GFXcanvas16 %.0fk chars/s (per-pixel %.0fk, %.1fx)\n",
+             f.name, size, p1 / 1000, b1 / 1000, p1 / b1, p16 / 1000,
+             b16 / 1000, p16 / b16);
+    }
+  }
+
+  if (mock_failures)
+    return 1;
+  printf("bench_text: ok\n");
+  return 0;
+}
@@ -0,0 +1,118 @@
+// Bytes and time per displayWindow() flush on Adafruit_GrayOLED, for a 4 bpp
+// 128x128 panel (SSD1327 style column pairs and rows) and a 1 bpp 128x64 one
+// (pages). The panel's RAM is modelled through the oled_commandList() and
+// oled_data() hooks and must equal the buffer after every flush.
+
+#include <chrono>
+
+#include <Adafruit_GrayOLED.h>
+
+#include "mock_host.h"
+
+class ModelOLED : public Adafruit_GrayOLED {
+public:
+  ModelOLED(uint8_t bpp)
+      : Adafruit_GrayOLED(bpp, 128, (bpp == 4) ? 128 : 64, &Wire) {
+    pitch = (bpp == 4) ? 64 : 128;
+    memset(ram, 0xAA, sizeof(ram));
+  }
+
+  bool begin(void) { return _init(0x3C, false); }
+  void display(void) { displayWindow(0x15, 0x75); }
+  bool same(void) const {
+    return !memcmp(ram, buffer, _bpp * WIDTH * ((HEIGHT + 7) / 8));
+  }
+
+  bool oled_commandList(const uint8_t *c, uint8_t n) {
+    if ((n == 6) && (c[0] == 0x15) && (c[3] == 0x75)) {
+      col1 = col = c[1];
+      col2 = c[2];
+      row1 = row = c[4];
+      row2 = c[5];
+    }
+    return true;
+  }
+
+  bool oled_data(const uint8_t *d, size_t n) {
+    bytes += n;
+    while (n--) {
+      ram[row * pitch + col] = *d++;
+      if (col++ == col2) {
+        col = col1;
+        row = (row == row2) ? row1 : row + 1;
+      }
+    }
+    return true;
+  }
+
+  long bytes = 0; // Data bytes sent
+
+private:
+  uint8_t ram[128 * 128 / 2];
+  int pitch, col1, col2, row1, row2, col, row;
+};
+
+static void bench(uint8_t bpp) {
+  ModelOLED oled(bpp);
+  CHECK(oled.begin());
+  oled.display();
+  long full = oled.bytes;
+  CHECK_EQ(full, bpp * 128 * (((bpp == 4) ? 128 : 64) / 8));
+  CHECK(oled.same());
+
+  // A clean buffer sends nothing
+  oled.bytes = 0;
+  oled.display();
+  CHECK_EQ(oled.bytes, 0);
+
+  // Small widgets all over the panel, in every rotation
+  srand(1);
+  const int updates = 2000;
+  long sent = 0;
+  double us = 0;
+  for (int i = 0; i < updates; i++) {
+    oled.setRotation(rand() & 3);
+    oled.fillRect(rand() % 140 - 6, rand() % 140 - 6, rand() % 24 + 1,
+                  rand() % 12 + 1, rand() & 15);
+    if (rand() % 3 == 0)
+      oled.drawPixel(rand() % 128, rand() % 128, 1);
+    oled.bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    oled.display();
+    us += std::chrono::duration<double, std::micro>(
+              std::chrono::steady_clock::now() - start)
+              .count();
+    sent += oled.bytes;
+    if (!oled.same()) {
+      fprintf(stderr, "%d bpp update %d: RAM differs from the buffer\n", bpp,
+              i);
+      mock_failures++;
+      break;
+    }
+  }
+
+  // A clock redraw in the corner
+  oled.setRotation(0);
+  oled.setTextColor(15);
+  oled.fillRect(90, 0, 36, 8, 0);
+  oled.setCursor(90, 0);
+  oled.print("12:34");
+  oled.bytes = 0;
+  oled.display();
+  CHECK(oled.same());
+
+  printf("  %d bpp: full frame %ld bytes; random widget %.0f bytes (%.1f%%), "
+         "%.2f us per flush; clock text %ld bytes\n",
+         bpp, full, (double)sent / updates, 100.0 * sent / updates / full,
+         us / updates, oled.bytes);
+}
+
+int main(void) {
+  bench(4);
+  bench(1);
+
+  if (mock_failures)
+    return 1;
+  printf("bench_window: ok\n");
+  return 0;
+}
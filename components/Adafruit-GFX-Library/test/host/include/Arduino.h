@@ -0,0 +1,34 @@
+#pragma once
+// Just enough of an Arduino core to build Adafruit_SSD1306, Adafruit_GFX
+// and Adafruit_GenericDevice on a host. Pins and delays do nothing.
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define PROGMEM
+#define F(s) (s)
+
+typedef enum { LSBFIRST = 0, MSBFIRST = 1 } BitOrder;
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t val) {}
+inline int digitalRead(uint8_t pin) { return LOW; }
+inline void delay(unsigned long ms) {}
+inline void delayMicroseconds(unsigned int us) {}
+inline void yield(void) {}
+
+#include "Print.h"
+#include <pgmspace.h>
@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+
+// Not connected: the tests drive the display through Adafruit_GenericDevice
+class TwoWire : public Stream {
+public:
+  void begin() {}
+  void end() {}
+  void setClock(uint32_t freq) {}
+  void beginTransmission(uint8_t addr) {}
+  uint8_t endTransmission(bool stop = true) { return 0; }
+  uint8_t requestFrom(uint8_t addr, size_t len, bool stop = true) { return 0; }
+  size_t write(uint8_t data) { return 1; }
+  size_t write(const uint8_t *data, size_t len) { return len; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,11 @@
+// Buses for the Arduino stand-ins. Nothing is connected; the tests model
+// the display by overriding the library's bus hooks.
+
+#include <SPI.h>
+#include <Wire.h>
+
+#include "mock_host.h"
+
+SPIClass SPI;
+TwoWire Wire;
+int mock_failures = 0;
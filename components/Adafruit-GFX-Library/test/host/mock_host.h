@@ -0,0 +1,26 @@
+#ifndef MOCK_HOST_H_
+#define MOCK_HOST_H_
+
+#include <stdio.h>
+
+extern int mock_failures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      mock_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                             \
+  do {                                                                         \
+    long a_ = (long)(actual), e_ = (long)(expected);                           \
+    if (a_ != e_) {                                                            \
+      fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__,  \
+              #actual, a_, e_);                                                \
+      mock_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#endif // MOCK_HOST_H_
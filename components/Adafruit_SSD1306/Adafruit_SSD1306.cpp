@@ -71,6 +71,9 @@
 #define WIRE_MAX 32 ///< Use common Arduino core default
 #endif
 
+#define SSD1306_WINDOW_COST                                                    \
+  8 ///< Approx. bytes of address/command preamble per display() window
+
 #define ssd1306_swap(a, b)                                                     \
   (((a) ^= (b)), ((b) ^= (a)), ((a) ^= (b))) ///< No-temp-var swap operation
 
@@ -117,11 +120,16 @@
 // so other I2C device types still work).  All of these are encapsulated
 // in the TRANSACTION_* macros.
 
-// Check first if Wire, then hardware SPI, then soft SPI:
+// Functions that talk to the display outside of display() call
+// waitForFlush() first, so they never share the bus with a background
+// flush (see setDoubleBuffer()).
+
+// Check first if Wire, then hardware SPI, then soft SPI (a generic bus
+// needs no setup):
 #define TRANSACTION_START                                                      \
   if (wire) {                                                                  \
     SETWIRECLOCK;                                                              \
-  } else {                                                                     \
+  } else if (!bus) {                                                           \
     if (spi) {                                                                 \
       SPI_TRANSACTION_START;                                                   \
     }                                                                          \
@@ -130,7 +138,7 @@
 #define TRANSACTION_END                                                        \
   if (wire) {                                                                  \
     RESWIRECLOCK;                                                              \
-  } else {                                                                     \
+  } else if (!bus) {                                                           \
     SSD1306_DESELECT;                                                          \
     if (spi) {                                                                 \
       SPI_TRANSACTION_END;                                                     \
@@ -175,8 +183,9 @@
 Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi,
                                    int8_t rst_pin, uint32_t clkDuring,
                                    uint32_t clkAfter)
-    : Adafruit_GFX(w, h), spi(NULL), wire(twi ? twi : &Wire), buffer(NULL),
-      mosiPin(-1), clkPin(-1), dcPin(-1), csPin(-1), rstPin(rst_pin)
+    : Adafruit_GFX(w, h), spi(NULL), wire(twi ? twi : &Wire), bus(NULL),
+      busBuf(NULL), buffer(NULL), mosiPin(-1), clkPin(-1), dcPin(-1),
+      csPin(-1), rstPin(rst_pin)
 #if ARDUINO >= 157
       ,
       wireClk(clkDuring), restoreClk(clkAfter)
@@ -214,9 +223,9 @@ Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi,
 Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, int8_t mosi_pin,
                                    int8_t sclk_pin, int8_t dc_pin,
                                    int8_t rst_pin, int8_t cs_pin)
-    : Adafruit_GFX(w, h), spi(NULL), wire(NULL), buffer(NULL),
-      mosiPin(mosi_pin), clkPin(sclk_pin), dcPin(dc_pin), csPin(cs_pin),
-      rstPin(rst_pin) {}
+    : Adafruit_GFX(w, h), spi(NULL), wire(NULL), bus(NULL), busBuf(NULL),
+      buffer(NULL), mosiPin(mosi_pin), clkPin(sclk_pin), dcPin(dc_pin),
+      csPin(cs_pin), rstPin(rst_pin) {}
 
 /*!
     @brief  Constructor for SPI SSD1306 displays, using native hardware SPI.
@@ -248,13 +257,76 @@ Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, SPIClass *spi_ptr,
                                    int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
                                    uint32_t bitrate)
     : Adafruit_GFX(w, h), spi(spi_ptr ? spi_ptr : &SPI), wire(NULL),
-      buffer(NULL), mosiPin(-1), clkPin(-1), dcPin(dc_pin), csPin(cs_pin),
-      rstPin(rst_pin) {
+      bus(NULL), busBuf(NULL), buffer(NULL), mosiPin(-1), clkPin(-1),
+      dcPin(dc_pin), csPin(cs_pin), rstPin(rst_pin) {
 #ifdef SPI_HAS_TRANSACTION
   spiSettings = SPISettings(bitrate, MSBFIRST, SPI_MODE0);
 #endif
 }
 
+/*!
+    @brief  Constructor for I2C SSD1306 displays on a generic transport,
+            e.g. a native driver or a host-side mock that records the
+            bytes sent.
+    @param  w
+            Display width in pixels
+    @param  h
+            Display height in pixels
+    @param  dev
+            Pointer to an Adafruit_GenericDevice whose write() function
+            issues one complete I2C transmission (START, address, the
+            given bytes, STOP) to the display. The first byte of each is
+            the SSD1306 control byte.
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used
+            (some displays might be wired to share the microcontroller's
+            reset pin).
+    @return Adafruit_SSD1306 object.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h,
+                                   Adafruit_GenericDevice *dev, int8_t rst_pin)
+    : Adafruit_GFX(w, h), spi(NULL), wire(NULL), bus(dev), busBuf(NULL),
+      buffer(NULL), mosiPin(-1), clkPin(-1), dcPin(-1), csPin(-1),
+      rstPin(rst_pin) {}
+
+#if defined(SSD1306_I2C_MASTER)
+/*!
+    @brief  Constructor for I2C SSD1306 displays using the ESP-IDF
+            i2c_master driver directly, bypassing TwoWire and its 128-byte
+            transmit limit: each display() window is a single transmission.
+    @param  w
+            Display width in pixels
+    @param  h
+            Display height in pixels
+    @param  i2c_bus
+            Handle of an i2c_master bus, from i2c_new_master_bus(). If Wire
+            is already using the bus, i2c_master_get_bus_handle() returns
+            its handle, and the two can share it.
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used
+            (some displays might be wired to share the microcontroller's
+            reset pin).
+    @param  clk
+            SCL rate (in Hz) for this display. Defaults to 1 MHz (Fast-mode
+            Plus), which most SSD1306 panels handle though the datasheet
+            only promises 400 KHz; begin() drops to 400 KHz if the display
+            doesn't acknowledge at this rate. Other devices on the bus keep
+            their own rates.
+    @return Adafruit_SSD1306 object.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h,
+                                   i2c_master_bus_handle_t i2c_bus,
+                                   int8_t rst_pin, uint32_t clk)
+    : Adafruit_GFX(w, h), spi(NULL), wire(NULL),
+      bus(new Adafruit_GenericDevice(this, NULL, i2cMasterWrite)),
+      busBuf(NULL), buffer(NULL), mosiPin(-1), clkPin(-1), dcPin(-1),
+      csPin(-1), rstPin(rst_pin), i2cBus(i2c_bus), i2cClk(clk) {}
+#endif
+
 /*!
     @brief  DEPRECATED constructor for SPI SSD1306 displays, using software
             (bitbang) SPI. Provided for older code to maintain compatibility
@@ -284,8 +356,8 @@ Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, SPIClass *spi_ptr,
 Adafruit_SSD1306::Adafruit_SSD1306(int8_t mosi_pin, int8_t sclk_pin,
                                    int8_t dc_pin, int8_t rst_pin, int8_t cs_pin)
     : Adafruit_GFX(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT), spi(NULL), wire(NULL),
-      buffer(NULL), mosiPin(mosi_pin), clkPin(sclk_pin), dcPin(dc_pin),
-      csPin(cs_pin), rstPin(rst_pin) {}
+      bus(NULL), busBuf(NULL), buffer(NULL), mosiPin(mosi_pin),
+      clkPin(sclk_pin), dcPin(dc_pin), csPin(cs_pin), rstPin(rst_pin) {}
 
 /*!
     @brief  DEPRECATED constructor for SPI SSD1306 displays, using native
@@ -310,8 +382,8 @@ Adafruit_SSD1306::Adafruit_SSD1306(int8_t mosi_pin, int8_t sclk_pin,
 */
 Adafruit_SSD1306::Adafruit_SSD1306(int8_t dc_pin, int8_t rst_pin, int8_t cs_pin)
     : Adafruit_GFX(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT), spi(&SPI), wire(NULL),
-      buffer(NULL), mosiPin(-1), clkPin(-1), dcPin(dc_pin), csPin(cs_pin),
-      rstPin(rst_pin) {
+      bus(NULL), busBuf(NULL), buffer(NULL), mosiPin(-1), clkPin(-1),
+      dcPin(dc_pin), csPin(cs_pin), rstPin(rst_pin) {
 #ifdef SPI_HAS_TRANSACTION
   spiSettings = SPISettings(8000000, MSBFIRST, SPI_MODE0);
 #endif
@@ -333,17 +405,29 @@ Adafruit_SSD1306::Adafruit_SSD1306(int8_t dc_pin, int8_t rst_pin, int8_t cs_pin)
 */
 Adafruit_SSD1306::Adafruit_SSD1306(int8_t rst_pin)
     : Adafruit_GFX(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT), spi(NULL), wire(&Wire),
-      buffer(NULL), mosiPin(-1), clkPin(-1), dcPin(-1), csPin(-1),
-      rstPin(rst_pin) {}
+      bus(NULL), busBuf(NULL), buffer(NULL), mosiPin(-1), clkPin(-1),
+      dcPin(-1), csPin(-1), rstPin(rst_pin) {}
 
 /*!
     @brief  Destructor for Adafruit_SSD1306 object.
 */
 Adafruit_SSD1306::~Adafruit_SSD1306(void) {
+  setDoubleBuffer(false);
   if (buffer) {
     free(buffer);
     buffer = NULL;
   }
+  if (busBuf) {
+    free(busBuf);
+    busBuf = NULL;
+  }
+#if defined(SSD1306_I2C_MASTER)
+  if (i2cBus) { // bus was allocated by the i2c_master constructor
+    if (i2cDev)
+      i2c_master_bus_rm_device(i2cDev);
+    delete bus;
+  }
+#endif
 }
 
 // LOW-LEVEL UTILS ---------------------------------------------------------
@@ -394,7 +478,10 @@ inline void Adafruit_SSD1306::SPIwrite(uint8_t d) {
     @note
 */
 void Adafruit_SSD1306::ssd1306_command1(uint8_t c) {
-  if (wire) { // I2C
+  if (bus) { // Generic I2C
+    uint8_t cmd[] = {0x00, c}; // Co = 0, D/C = 0
+    bus->write(cmd, sizeof(cmd));
+  } else if (wire) { // I2C
     wire->beginTransmission(i2caddr);
     WIRE_WRITE((uint8_t)0x00); // Co = 0, D/C = 0
     WIRE_WRITE(c);
@@ -418,7 +505,17 @@ void Adafruit_SSD1306::ssd1306_command1(uint8_t c) {
     @note
 */
 void Adafruit_SSD1306::ssd1306_commandList(const uint8_t *c, uint8_t n) {
-  if (wire) { // I2C
+  if (bus) { // Generic I2C, as few transmissions as busBuf allows
+    uint16_t room = SSD1306_BUS_PREAMBLE + WIDTH * ((HEIGHT + 7) / 8) - 1;
+    while (n) {
+      uint8_t len = min((uint16_t)n, room);
+      busBuf[0] = 0x00; // Co = 0, D/C = 0
+      for (uint8_t i = 1; i <= len; i++)
+        busBuf[i] = pgm_read_byte(c++);
+      bus->write(busBuf, len + 1);
+      n -= len;
+    }
+  } else if (wire) { // I2C
     wire->beginTransmission(i2caddr);
     WIRE_WRITE((uint8_t)0x00); // Co = 0, D/C = 0
     uint16_t bytesOut = 1;
@@ -451,6 +548,7 @@ void Adafruit_SSD1306::ssd1306_commandList(const uint8_t *c, uint8_t n) {
     @return None (void).
 */
 void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  waitForFlush();
   TRANSACTION_START
   ssd1306_command1(c);
   TRANSACTION_END
@@ -496,8 +594,15 @@ void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
 bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr, bool reset,
                              bool periphBegin) {
 
+  if (((HEIGHT + 7) / 8) > SSD1306_MAX_PAGES)
+    return false; // Dirty tracking (and the controller) stop at 64 rows
+
   if ((!buffer) && !(buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))))
     return false;
+  if (bus && (!busBuf) &&
+      !(busBuf = (uint8_t *)malloc(SSD1306_BUS_PREAMBLE +
+                                   WIDTH * ((HEIGHT + 7) / 8))))
+    return false;
 
   clearDisplay();
 
@@ -514,7 +619,10 @@ bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr, bool reset,
   vccstate = vcs;
 
   // Setup pin directions
-  if (wire) { // Using I2C
+  if (bus) { // Generic I2C, address only matters to i2c_master
+    i2caddr = addr ? addr : ((HEIGHT == 32) ? 0x3C : 0x3D);
+    bus->begin();
+  } else if (wire) { // Using I2C
     // If I2C address is unspecified, use default
     // (0x3C for 32-pixel-tall displays, 0x3D for all others).
     i2caddr = addr ? addr : ((HEIGHT == 32) ? 0x3C : 0x3D);
@@ -563,6 +671,11 @@ bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr, bool reset,
     digitalWrite(rstPin, HIGH); // Bring out of reset
   }
 
+#if defined(SSD1306_I2C_MASTER)
+  if (i2cBus && !i2cMasterBegin())
+    return false;
+#endif
+
   TRANSACTION_START
 
   // Init sequence
@@ -662,6 +775,7 @@ void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
       y = HEIGHT - y - 1;
       break;
     }
+    growDirty(x, y, x, y);
     switch (color) {
     case SSD1306_WHITE:
       buffer[x + (y / 8) * WIDTH] |= (1 << (y & 7));
@@ -685,6 +799,7 @@ void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
 */
 void Adafruit_SSD1306::clearDisplay(void) {
   memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+  markDirty();
 }
 
 /*!
@@ -764,6 +879,7 @@ void Adafruit_SSD1306::drawFastHLineInternal(int16_t x, int16_t y, int16_t w,
       w = (WIDTH - x);
     }
     if (w > 0) { // Proceed only if width is positive
+      growDirty(x, y, x + w - 1, y);
       uint8_t *pBuf = &buffer[(y / 8) * WIDTH + x], mask = 1 << (y & 7);
       switch (color) {
       case SSD1306_WHITE:
@@ -863,6 +979,7 @@ void Adafruit_SSD1306::drawFastVLineInternal(int16_t x, int16_t __y,
       __h = (HEIGHT - __y);
     }
     if (__h > 0) { // Proceed only if height is now positive
+      growDirty(x, __y, x, __y + __h - 1);
       // this display doesn't need ints for coordinates,
       // use local byte registers for faster juggling
       uint8_t y = __y, h = __h;
@@ -947,6 +1064,86 @@ void Adafruit_SSD1306::drawFastVLineInternal(int16_t x, int16_t __y,
   } // endif x in bounds
 }
 
+// Map an SSD1306 drawing color onto a GFX_BLIT_* raster operation
+static uint8_t ssd1306_blitop(uint16_t color) {
+  switch (color) {
+  case SSD1306_WHITE:
+    return GFX_BLIT_SET;
+  case SSD1306_BLACK:
+    return GFX_BLIT_CLEAR;
+  case SSD1306_INVERSE:
+    return GFX_BLIT_INVERT;
+  }
+  return GFX_BLIT_NONE;
+}
+
+/*!
+    @brief  Draw a drawBitmap() image straight into the page-major display
+            buffer, a whole column byte at a time.
+    @param  x
+            Top left corner x coordinate.
+    @param  y
+            Top left corner y coordinate.
+    @param  bitmap
+            Byte array with monochrome bitmap, MSB-first scanlines.
+    @param  w
+            Width of bitmap in pixels.
+    @param  h
+            Height of bitmap in pixels.
+    @param  color
+            Pixel color for set bits, one of: SSD1306_BLACK, SSD1306_WHITE or
+            SSD1306_INVERSE.
+    @param  bg
+            Pixel color for unset bits, used only if opaque.
+    @param  opaque
+            If false, unset bits are transparent.
+    @param  progmem
+            True if bitmap is PROGMEM-resident.
+    @return true if handled, false if the buffer is not allocated.
+*/
+bool Adafruit_SSD1306::drawBitmap1(int16_t x, int16_t y,
+                                   const uint8_t *bitmap, int16_t w, int16_t h,
+                                   uint16_t color, uint16_t bg, bool opaque,
+                                   bool progmem) {
+  if (!buffer)
+    return false;
+  int16_t b[4];
+  if (blitBitmap1(buffer, true, x, y, bitmap, w, h, ssd1306_blitop(color),
+                  opaque ? ssd1306_blitop(bg) : GFX_BLIT_NONE, progmem, b))
+    growDirty(b[0], b[1], b[2], b[3]);
+  return true;
+}
+
+/*!
+    @brief  drawBitmap1() blits whenever the display buffer is allocated.
+    @return true if the buffer is allocated.
+*/
+bool Adafruit_SSD1306::canBlit1(void) const { return buffer != NULL; }
+
+/*!
+    @brief  Fill spans straight into the display buffer. Raw columns become
+            page-masked runs, eight rows per byte.
+    @param  batch
+            Spans in rotated coordinates, already clipped.
+    @return None (void).
+*/
+void Adafruit_SSD1306::writeSpans(const GFXspanBatch *batch) {
+  int16_t x, y, w;
+  for (uint8_t i = 0; i < batch->count; i++) {
+    if (rawSpan(batch, i, &x, &y, &w))
+      drawFastVLineInternal(x, y, w, batch->color);
+    else
+      drawFastHLineInternal(x, y, w, batch->color);
+  }
+}
+
+/*!
+    @brief  The buffer is page-major, so round shapes are cheaper to fill
+            as columns when those are vertical in the buffer.
+    @return true in rotations 0 and 2.
+*/
+bool Adafruit_SSD1306::verticalSpans(void) const { return !(rotation & 1); }
+
 /*!
     @brief  Return color of a single pixel in display buffer.
     @param  x
@@ -995,24 +1192,53 @@ uint8_t *Adafruit_SSD1306::getBuffer(void) { return buffer; }
     @note   Drawing operations are not visible until this function is
             called. Call after each graphics command, or after a whole set
             of graphics commands, as best needed by one's own application.
+            If setPartialUpdate(true) is in effect, only the columns touched
+            since the previous display() are sent, one window per run of
+            dirty pages. If setDoubleBuffer(true) is in effect, the frame
+            is copied aside and sent by a background task; this returns as
+            soon as the previous frame has finished.
 */
 void Adafruit_SSD1306::display(void) {
-  TRANSACTION_START
-  static const uint8_t PROGMEM dlist1[] = {
-      SSD1306_PAGEADDR,
-      0,                   // Page start address
-      0xFF,                // Page end (not really, but works here)
-      SSD1306_COLUMNADDR}; // Column start address
-  ssd1306_commandList(dlist1, sizeof(dlist1));
-
-  if (WIDTH == 64) {
-    ssd1306_command1(0x20);             // Column start
-    ssd1306_command1(0x20 + WIDTH - 1); // Column end address
-  } else {
-    ssd1306_command1(0);           // Column start
-    ssd1306_command1((WIDTH - 1)); // Column end address
+  if (flushBuf) { // Double-buffered: snapshot the frame for the flush task
+    uint16_t bytes = WIDTH * ((HEIGHT + 7) / 8);
+#if defined(SSD1306_FLUSH_TASK)
+    xSemaphoreTake(flushIdle, portMAX_DELAY);
+#else
+    waitForFlush();
+#endif
+    memcpy(flushBuf, buffer, bytes);
+    memcpy(flush_x1, dirty_x1, sizeof(flush_x1));
+    memcpy(flush_x2, dirty_x2, sizeof(flush_x2));
+    clearDirty();
+#if defined(SSD1306_FLUSH_TASK)
+    xTaskNotifyGive(flushTask);
+#elif defined(SSD1306_FLUSH_THREAD)
+    {
+      std::lock_guard<std::mutex> lock(flushMutex);
+      flushPending = true;
+    }
+    flushCond.notify_all();
+#endif
+    return;
   }
+  sendFrame(buffer, dirty_x1, dirty_x2);
+  clearDirty();
+}
 
+/*!
+    @brief  Push a frame to the display, all of it or (if partial updates
+            are enabled) just its dirty columns. Called by display(), or by
+            the flush task when double-buffered.
+    @param  frame
+            Buffer to send, WIDTH * ((HEIGHT + 7) / 8) bytes.
+    @param  x1s
+            Per-page first dirty column of frame.
+    @param  x2s
+            Per-page last dirty column of frame.
+    @return None (void).
+*/
+void Adafruit_SSD1306::sendFrame(const uint8_t *frame, const uint8_t *x1s,
+                                 const uint8_t *x2s) {
 #if defined(ESP8266)
   // ESP8266 needs a periodic yield() call to avoid watchdog reset.
   // With the limited size of SSD1306 displays, and the fast bitrate
@@ -1022,34 +1248,346 @@ void Adafruit_SSD1306::display(void) {
   // 32-byte transfer condition below.
   yield();
 #endif
-  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
-  uint8_t *ptr = buffer;
+  TRANSACTION_START
+  if (partialUpdate) {
+    uint8_t pages = (HEIGHT + 7) / 8;
+    for (uint8_t p = 0; p < pages; p++) {
+      if (x1s[p] > x2s[p])
+        continue; // Page is clean
+      // Extend the window down through following dirty pages as long as
+      // the extra (clean) columns this drags in cost fewer bytes than the
+      // PAGEADDR/COLUMNADDR preamble of a separate window would.
+      uint8_t x1 = x1s[p], x2 = x2s[p], last = p;
+      while (((last + 1) < pages) &&
+             (x1s[last + 1] <= x2s[last + 1])) {
+        uint8_t n = last + 1;
+        uint8_t nx1 = min(x1, x1s[n]), nx2 = max(x2, x2s[n]);
+        uint16_t waste = (uint16_t)(n - p) * ((nx2 - nx1) - (x2 - x1)) +
+                         ((nx2 - nx1) - (x2s[n] - x1s[n]));
+        if (waste > SSD1306_WINDOW_COST)
+          break;
+        x1 = nx1;
+        x2 = nx2;
+        last = n;
+      }
+      displayWindow(p, last, x1, x2, frame);
+      p = last;
+    }
+  } else {
+    // Page end: not really, but works
+    displayWindow(0, 0xFF, 0, WIDTH - 1, frame);
+  }
+  TRANSACTION_END
+#if defined(ESP8266)
+  yield();
+#endif
+}
+
+/*!
+    @brief  Stream one rectangular window of the buffer to the display,
+            using PAGEADDR/COLUMNADDR so the controller auto-increments
+            through it in horizontal addressing mode. Transaction must be
+            started/ended in calling function.
+    @param  page1
+            First page (8-row band) of the window.
+    @param  page2
+            Last page of the window. Values past the bottom of the buffer
+            are sent to the controller as-is but clamped for data.
+    @param  col1
+            First column of the window.
+    @param  col2
+            Last column of the window.
+    @param  frame
+            Buffer to take the window's data from.
+    @return None (void).
+*/
+void Adafruit_SSD1306::displayWindow(uint8_t page1, uint8_t page2,
+                                     uint8_t col1, uint8_t col2,
+                                     const uint8_t *frame) {
+  uint8_t colOffset = (WIDTH == 64) ? 0x20 : 0;
+  uint8_t dlist[] = {SSD1306_PAGEADDR,
+                     page1,
+                     page2,
+                     SSD1306_COLUMNADDR,
+                     (uint8_t)(colOffset + col1),
+                     (uint8_t)(colOffset + col2)};
+  uint8_t lastPage = (HEIGHT + 7) / 8 - 1;
+  uint8_t w = col2 - col1 + 1;
+
+  if (bus) { // Generic I2C: preamble and data in one transmission
+    uint8_t *ptr = busBuf;
+    for (uint8_t i = 0; i < sizeof(dlist); i++) {
+      *ptr++ = 0x80; // Co = 1, D/C = 0: one command byte follows
+      *ptr++ = dlist[i];
+    }
+    *ptr++ = 0x40; // Co = 0, D/C = 1: data through end of transmission
+    if (page2 > lastPage)
+      page2 = lastPage;
+    for (uint8_t p = page1; p <= page2; p++, ptr += w)
+      memcpy(ptr, &frame[p * WIDTH + col1], w);
+    bus->write(busBuf, ptr - busBuf);
+    return;
+  }
+
+  if (wire) { // I2C, single transmission for the whole preamble
+    wire->beginTransmission(i2caddr);
+    WIRE_WRITE((uint8_t)0x00); // Co = 0, D/C = 0
+    for (uint8_t i = 0; i < sizeof(dlist); i++)
+      WIRE_WRITE(dlist[i]);
+    wire->endTransmission();
+  } else {
+    SSD1306_MODE_COMMAND
+    for (uint8_t i = 0; i < sizeof(dlist); i++)
+      SPIwrite(dlist[i]);
+  }
+
+  if (page2 > lastPage)
+    page2 = lastPage;
   if (wire) { // I2C
     wire->beginTransmission(i2caddr);
     WIRE_WRITE((uint8_t)0x40);
     uint16_t bytesOut = 1;
-    while (count--) {
-      if (bytesOut >= WIRE_MAX) {
-        wire->endTransmission();
-        wire->beginTransmission(i2caddr);
-        WIRE_WRITE((uint8_t)0x40);
-        bytesOut = 1;
+    for (uint8_t p = page1; p <= page2; p++) {
+      const uint8_t *ptr = &frame[p * WIDTH + col1];
+      for (uint8_t count = w; count--;) {
+        if (bytesOut >= WIRE_MAX) {
+          wire->endTransmission();
+          wire->beginTransmission(i2caddr);
+          WIRE_WRITE((uint8_t)0x40);
+          bytesOut = 1;
+        }
+        WIRE_WRITE(*ptr++);
+        bytesOut++;
       }
-      WIRE_WRITE(*ptr++);
-      bytesOut++;
     }
     wire->endTransmission();
   } else { // SPI
     SSD1306_MODE_DATA
-    while (count--)
-      SPIwrite(*ptr++);
+    for (uint8_t p = page1; p <= page2; p++) {
+      const uint8_t *ptr = &frame[p * WIDTH + col1];
+      for (uint8_t count = w; count--;)
+        SPIwrite(*ptr++);
+    }
+  }
+}
+
+/*!
+    @brief  Select between full-frame and dirty-window display() updates.
+    @param  enable
+            true to have display() send only the buffer regions changed
+            by drawPixel(), drawFastHLine(), drawFastVLine() (and thus most
+            Adafruit_GFX primitives) or clearDisplay() since the previous
+            display(); false (the default) to always send the whole frame.
+    @return None (void).
+    @note   Writes made directly through getBuffer() are not tracked; call
+            markDirty() after them so the next display() sends everything.
+*/
+void Adafruit_SSD1306::setPartialUpdate(bool enable) {
+  partialUpdate = enable;
+}
+
+/*!
+    @brief  Select between sending frames from display() itself and
+            double-buffered updates, where display() copies the frame to a
+            second buffer and a background task (a FreeRTOS task on ESP32,
+            std::thread on host builds) sends it while drawing continues.
+            The frame rate then no longer depends on bus speed, except that
+            display() waits for the previous frame to finish.
+    @param  enable
+            true to start the flush task, false to wait for it to finish
+            and stop it.
+    @param  stackBytes
+            Stack for the flush task (FreeRTOS only).
+    @param  priority
+            Priority of the flush task (FreeRTOS only).
+    @return true if double-buffering is now on (or was turned off), false
+            if the second buffer or the task couldn't be created or this
+            platform has no background task support.
+    @note   Costs WIDTH * HEIGHT / 8 bytes for the second buffer (1 KB for
+            128x64) plus the task's stack. Call after begin(). Functions
+            that send commands (dim(), invertDisplay(), scrolling) first
+            wait for the flush in progress, if any.
+*/
+bool Adafruit_SSD1306::setDoubleBuffer(bool enable, uint32_t stackBytes,
+                                       uint8_t priority) {
+  if (!enable) {
+    if (flushBuf) {
+      waitForFlush();
+#if defined(SSD1306_FLUSH_TASK)
+      vTaskDelete(flushTask); // Idle, blocked waiting for the next frame
+      vSemaphoreDelete(flushIdle);
+      flushTask = NULL;
+      flushIdle = NULL;
+#elif defined(SSD1306_FLUSH_THREAD)
+      {
+        std::lock_guard<std::mutex> lock(flushMutex);
+        flushQuit = true;
+      }
+      flushCond.notify_all();
+      flushThread.join();
+      flushQuit = false;
+#endif
+      free(flushBuf);
+      flushBuf = NULL;
+    }
+    return true;
+  }
+  if (flushBuf)
+    return true;
+#if defined(SSD1306_FLUSH_TASK) || defined(SSD1306_FLUSH_THREAD)
+  if (!buffer || !(flushBuf = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))))
+    return false;
+#if defined(SSD1306_FLUSH_TASK)
+  if ((flushIdle = xSemaphoreCreateBinary())) {
+    xSemaphoreGive(flushIdle);
+    if (xTaskCreate(flushMain, "ssd1306", stackBytes, this, priority,
+                    &flushTask) == pdPASS)
+      return true;
+    vSemaphoreDelete(flushIdle);
+    flushIdle = NULL;
+  }
+  free(flushBuf);
+  flushBuf = NULL;
+  return false;
+#else
+  (void)stackBytes;
+  (void)priority;
+  flushThread = std::thread(flushMain, this);
+  return true;
+#endif
+#else
+  (void)stackBytes;
+  (void)priority;
+  return false;
+#endif
+}
+
+/*!
+    @brief  Wait until the frame handed over by the last display() has
+            been sent, when double-buffering. For example, before putting
+            the MCU to sleep or powering the display down.
+    @return None (void).
+*/
+void Adafruit_SSD1306::waitForFlush(void) {
+#if defined(SSD1306_FLUSH_TASK)
+  if (flushIdle) {
+    xSemaphoreTake(flushIdle, portMAX_DELAY);
+    xSemaphoreGive(flushIdle);
+  }
+#elif defined(SSD1306_FLUSH_THREAD)
+  if (flushBuf) {
+    std::unique_lock<std::mutex> lock(flushMutex);
+    flushCond.wait(lock, [this] { return !flushPending; });
   }
-  TRANSACTION_END
-#if defined(ESP8266)
-  yield();
 #endif
 }
 
+#if defined(SSD1306_FLUSH_TASK) || defined(SSD1306_FLUSH_THREAD)
+/*!
+    @brief  Body of the flush task: send each frame display() hands over.
+    @param  obj
+            The Adafruit_SSD1306 object.
+    @return None (void).
+*/
+void Adafruit_SSD1306::flushMain(void *obj) {
+  Adafruit_SSD1306 *oled = (Adafruit_SSD1306 *)obj;
+  for (;;) {
+#if defined(SSD1306_FLUSH_TASK)
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    oled->sendFrame(oled->flushBuf, oled->flush_x1, oled->flush_x2);
+    xSemaphoreGive(oled->flushIdle);
+#else
+    std::unique_lock<std::mutex> lock(oled->flushMutex);
+    oled->flushCond.wait(
+        lock, [oled] { return oled->flushPending || oled->flushQuit; });
+    if (!oled->flushPending)
+      return; // flushQuit
+    lock.unlock();
+    oled->sendFrame(oled->flushBuf, oled->flush_x1, oled->flush_x2);
+    lock.lock();
+    oled->flushPending = false;
+    lock.unlock();
+    oled->flushCond.notify_all();
+#endif
+  }
+}
+#endif
+
+/*!
+    @brief  Mark the whole buffer as changed, so the next partial
+            display() resends the complete frame.
+    @return None (void).
+*/
+void Adafruit_SSD1306::markDirty(void) {
+  uint8_t pages = (HEIGHT + 7) / 8;
+  for (uint8_t p = 0; p < pages; p++) {
+    dirty_x1[p] = 0;
+    dirty_x2[p] = WIDTH - 1;
+  }
+}
+
+/*!
+    @brief  Reset all per-page dirty column ranges to empty (min > max).
+    @return None (void).
+*/
+void Adafruit_SSD1306::clearDirty(void) {
+  for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+    dirty_x1[p] = 0xFF;
+    dirty_x2[p] = 0;
+  }
+}
+
+#if defined(SSD1306_I2C_MASTER)
+/*!
+    @brief  Add the display to the i2c_master bus at the requested SCL
+            rate, falling back to 400 KHz if it doesn't acknowledge.
+    @return true if the display responded, false otherwise.
+*/
+bool Adafruit_SSD1306::i2cMasterBegin(void) {
+  uint32_t clk = i2cClk;
+  for (;;) {
+    if (i2cDev) {
+      i2c_master_bus_rm_device(i2cDev);
+      i2cDev = NULL;
+    }
+    i2c_device_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    cfg.device_address = i2caddr;
+    cfg.scl_speed_hz = clk;
+    if (i2c_master_bus_add_device(i2cBus, &cfg, &i2cDev) != ESP_OK) {
+      i2cDev = NULL;
+      return false;
+    }
+    static const uint8_t nop[] = {0x00, 0xE3}; // Co = 0, D/C = 0, NOP
+    if (i2c_master_transmit(i2cDev, nop, sizeof(nop), SSD1306_I2C_TIMEOUT) ==
+        ESP_OK)
+      return true;
+    if (clk <= 400000UL)
+      return false;
+    clk = 400000UL; // Fast-mode, per datasheet
+  }
+}
+
+/*!
+    @brief  Adafruit_GenericDevice write function for the i2c_master
+            constructor: one transmission per call.
+    @param  obj
+            The Adafruit_SSD1306 object.
+    @param  buffer
+            Control byte followed by commands or data.
+    @param  len
+            Number of bytes in buffer.
+    @return true if the display acknowledged everything, false otherwise.
+*/
+bool Adafruit_SSD1306::i2cMasterWrite(void *obj, const uint8_t *buffer,
+                                      size_t len) {
+  Adafruit_SSD1306 *oled = (Adafruit_SSD1306 *)obj;
+  return oled->i2cDev && (i2c_master_transmit(oled->i2cDev, buffer, len,
+                                              SSD1306_I2C_TIMEOUT) == ESP_OK);
+}
+#endif
+
 // SCROLLING FUNCTIONS -----------------------------------------------------
 
 /*!
@@ -1062,6 +1600,7 @@ void Adafruit_SSD1306::display(void) {
 */
 // To scroll the whole display, run: display.startscrollright(0x00, 0x0F)
 void Adafruit_SSD1306::startscrollright(uint8_t start, uint8_t stop) {
+  waitForFlush();
   TRANSACTION_START
   static const uint8_t PROGMEM scrollList1a[] = {
       SSD1306_RIGHT_HORIZONTAL_SCROLL, 0X00};
@@ -1085,6 +1624,7 @@ void Adafruit_SSD1306::startscrollright(uint8_t start, uint8_t stop) {
 */
 // To scroll the whole display, run: display.startscrollleft(0x00, 0x0F)
 void Adafruit_SSD1306::startscrollleft(uint8_t start, uint8_t stop) {
+  waitForFlush();
   TRANSACTION_START
   static const uint8_t PROGMEM scrollList2a[] = {SSD1306_LEFT_HORIZONTAL_SCROLL,
                                                  0X00};
@@ -1108,6 +1648,7 @@ void Adafruit_SSD1306::startscrollleft(uint8_t start, uint8_t stop) {
 */
 // display.startscrolldiagright(0x00, 0x0F)
 void Adafruit_SSD1306::startscrolldiagright(uint8_t start, uint8_t stop) {
+  waitForFlush();
   TRANSACTION_START
   static const uint8_t PROGMEM scrollList3a[] = {
       SSD1306_SET_VERTICAL_SCROLL_AREA, 0X00};
@@ -1134,6 +1675,7 @@ void Adafruit_SSD1306::startscrolldiagright(uint8_t start, uint8_t stop) {
 */
 // To scroll the whole display, run: display.startscrolldiagleft(0x00, 0x0F)
 void Adafruit_SSD1306::startscrolldiagleft(uint8_t start, uint8_t stop) {
+  waitForFlush();
   TRANSACTION_START
   static const uint8_t PROGMEM scrollList4a[] = {
       SSD1306_SET_VERTICAL_SCROLL_AREA, 0X00};
@@ -1155,6 +1697,7 @@ void Adafruit_SSD1306::startscrolldiagleft(uint8_t start, uint8_t stop) {
     @return None (void).
 */
 void Adafruit_SSD1306::stopscroll(void) {
+  waitForFlush();
   TRANSACTION_START
   ssd1306_command1(SSD1306_DEACTIVATE_SCROLL);
   TRANSACTION_END
@@ -1176,6 +1719,7 @@ void Adafruit_SSD1306::stopscroll(void) {
    white, SSD1306_WHITE (value 1) will draw black.
 */
 void Adafruit_SSD1306::invertDisplay(bool i) {
+  waitForFlush();
   TRANSACTION_START
   ssd1306_command1(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
   TRANSACTION_END
@@ -1192,6 +1736,7 @@ void Adafruit_SSD1306::invertDisplay(bool i) {
 void Adafruit_SSD1306::dim(bool dim) {
   // the range of contrast to too small to be really useful
   // it is useful to dim the display
+  waitForFlush();
   TRANSACTION_START
   ssd1306_command1(SSD1306_SETCONTRAST);
   ssd1306_command1(dim ? 0 : contrast);
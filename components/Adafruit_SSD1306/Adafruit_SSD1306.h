@@ -40,9 +40,27 @@ typedef class HardwareSPI SPIClass;
 #endif
 
 #include <Adafruit_GFX.h>
+#include <Adafruit_GenericDevice.h>
 #include <SPI.h>
 #include <Wire.h>
 
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#define SSD1306_FLUSH_TASK ///< Double-buffered flush runs as a FreeRTOS task
+#elif defined(__linux__) || defined(__APPLE__)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#define SSD1306_FLUSH_THREAD ///< Double-buffered flush runs as a std::thread
+#endif
+
+#if defined(ESP32) && __has_include(<driver/i2c_master.h>)
+#include <driver/i2c_master.h>
+#define SSD1306_I2C_MASTER ///< ESP-IDF i2c_master constructor is available
+#endif
+
 #if defined(__AVR__)
 typedef volatile uint8_t PortReg;
 typedef uint8_t PortMask;
@@ -99,6 +117,12 @@ typedef uint32_t PortMask;
 #define SSD1306_SETHIGHCOLUMN 0x10 ///< Not currently used
 #define SSD1306_SETSTARTLINE 0x40  ///< See datasheet
 
+#define SSD1306_MAX_PAGES 8 ///< 64 rows max (SETMULTIPLEX), 8 rows per page
+
+#define SSD1306_BUS_PREAMBLE 13 ///< Co=1 PAGEADDR/COLUMNADDR + data ctrl byte
+#define SSD1306_I2C_TIMEOUT 1000 ///< ESP-IDF i2c_master timeout, ms
+#define SSD1306_FLUSH_STACK 3072 ///< Default flush task stack, bytes
+
 #define SSD1306_EXTERNALVCC 0x01  ///< External display voltage source
 #define SSD1306_SWITCHCAPVCC 0x02 ///< Gen. display voltage from 3.3V
 
@@ -138,6 +162,12 @@ public:
                    int8_t dc_pin, int8_t rst_pin, int8_t cs_pin);
   Adafruit_SSD1306(uint8_t w, uint8_t h, SPIClass *spi, int8_t dc_pin,
                    int8_t rst_pin, int8_t cs_pin, uint32_t bitrate = 8000000UL);
+  Adafruit_SSD1306(uint8_t w, uint8_t h, Adafruit_GenericDevice *dev,
+                   int8_t rst_pin = -1);
+#if defined(SSD1306_I2C_MASTER)
+  Adafruit_SSD1306(uint8_t w, uint8_t h, i2c_master_bus_handle_t i2c_bus,
+                   int8_t rst_pin = -1, uint32_t clk = 1000000UL);
+#endif
 
   // DEPRECATED CONSTRUCTORS - for back compatibility, avoid in new projects
   Adafruit_SSD1306(int8_t mosi_pin, int8_t sclk_pin, int8_t dc_pin,
@@ -150,6 +180,11 @@ public:
   bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
              bool reset = true, bool periphBegin = true);
   void display(void);
+  void setPartialUpdate(bool enable);
+  bool setDoubleBuffer(bool enable, uint32_t stackBytes = SSD1306_FLUSH_STACK,
+                       uint8_t priority = 1);
+  void waitForFlush(void);
+  void markDirty(void);
   void clearDisplay(void);
   void invertDisplay(bool i);
   void dim(bool dim);
@@ -171,11 +206,45 @@ protected:
   void drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t color);
   void ssd1306_command1(uint8_t c);
   void ssd1306_commandList(const uint8_t *c, uint8_t n);
+  void sendFrame(const uint8_t *frame, const uint8_t *x1s, const uint8_t *x2s);
+  void displayWindow(uint8_t page1, uint8_t page2, uint8_t col1, uint8_t col2,
+                     const uint8_t *frame);
+  bool drawBitmap1(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                   int16_t h, uint16_t color, uint16_t bg, bool opaque,
+                   bool progmem);
+  bool canBlit1(void) const;
+  void writeSpans(const GFXspanBatch *batch);
+  bool verticalSpans(void) const;
+  void clearDirty(void);
+#if defined(SSD1306_FLUSH_TASK) || defined(SSD1306_FLUSH_THREAD)
+  static void flushMain(void *obj);
+#endif
+#if defined(SSD1306_I2C_MASTER)
+  bool i2cMasterBegin(void);
+  static bool i2cMasterWrite(void *obj, const uint8_t *buffer, size_t len);
+#endif
+
+  /*!
+      @brief  Grow the per-page dirty column ranges to cover a rectangle
+              in native (unrotated, already clipped) buffer coordinates.
+  */
+  inline void growDirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+    for (uint8_t p = y1 / 8; p <= y2 / 8; p++) {
+      if (x1 < dirty_x1[p])
+        dirty_x1[p] = x1;
+      if (x2 > dirty_x2[p])
+        dirty_x2[p] = x2;
+    }
+  }
 
   SPIClass *spi;   ///< Initialized during construction when using SPI. See
                    ///< SPI.cpp, SPI.h
   TwoWire *wire;   ///< Initialized during construction when using I2C. See
                    ///< Wire.cpp, Wire.h
+  Adafruit_GenericDevice *bus; ///< Set during construction when using a
+                               ///< generic I2C transport, each write() is
+                               ///< one complete transmission
+  uint8_t *busBuf; ///< Staging for bus writes, allocated in begin()
   uint8_t *buffer; ///< Buffer data used for display buffer. Allocated when
                    ///< begin method is called.
   int8_t i2caddr;  ///< I2C address initialized when begin method is called.
@@ -198,6 +267,28 @@ protected:
   uint32_t restoreClk; ///< Wire speed following SSD1306 transfers
 #endif
   uint8_t contrast; ///< normal contrast setting for this device
+#if defined(SSD1306_I2C_MASTER)
+  i2c_master_bus_handle_t i2cBus = NULL; ///< ESP-IDF bus, if constructed so
+  i2c_master_dev_handle_t i2cDev = NULL; ///< Display on i2cBus
+  uint32_t i2cClk = 0;                   ///< SCL rate to try first
+#endif
+
+  uint8_t dirty_x1[SSD1306_MAX_PAGES], ///< Per-page dirty column minimum
+      dirty_x2[SSD1306_MAX_PAGES];     ///< Per-page dirty column maximum
+  bool partialUpdate = false; ///< If set, display() sends dirty columns only
+  uint8_t *flushBuf = NULL; ///< Frame being flushed, if double-buffered
+  uint8_t flush_x1[SSD1306_MAX_PAGES], ///< Per-page dirty minimum of flushBuf
+      flush_x2[SSD1306_MAX_PAGES];     ///< Per-page dirty maximum of flushBuf
+#if defined(SSD1306_FLUSH_TASK)
+  TaskHandle_t flushTask = NULL;      ///< Sends flushBuf
+  SemaphoreHandle_t flushIdle = NULL; ///< Given while flushTask is idle
+#elif defined(SSD1306_FLUSH_THREAD)
+  std::thread flushThread;           ///< Sends flushBuf
+  std::mutex flushMutex;             ///< Guards flushPending, flushQuit
+  std::condition_variable flushCond; ///< Signals flushPending changes
+  bool flushPending = false;         ///< Set while flushBuf awaits sending
+  bool flushQuit = false;            ///< Tells flushThread to exit
+#endif
 #if defined(SPI_HAS_TRANSACTION)
 protected:
   // Allow sub-class to change
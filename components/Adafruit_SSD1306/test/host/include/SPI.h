@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+#define SPI_HAS_TRANSACTION 1
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+class SPISettings {
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {}
+};
+
+// Not connected: the tests drive the display through Adafruit_GenericDevice
+class SPIClass {
+public:
+  void begin() {}
+  void beginTransaction(SPISettings settings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) { return 0; }
+  void transfer(void *buf, size_t count) {}
+  void setClockDivider(uint8_t div) {}
+  void setBitOrder(uint8_t order) {}
+  void setDataMode(uint8_t mode) {}
+};
+
+extern SPIClass SPI;
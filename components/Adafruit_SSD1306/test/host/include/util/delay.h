@@ -0,0 +1,2 @@
+#pragma once
+// Empty: the AVR delay routines are not used on a host
@@ -0,0 +1,122 @@
+#include <string.h>
+
+#include <SPI.h>
+#include <Wire.h>
+
+#include "mock_panel.h"
+
+SPIClass SPI;
+TwoWire Wire;
+int mock_failures = 0;
+
+// Argument bytes that follow each multi-byte command the library sends
+static int argCount(uint8_t c) {
+  switch (c) {
+  case 0x20: // MEMORYMODE
+  case 0x81: // SETCONTRAST
+  case 0x8D: // CHARGEPUMP
+  case 0xA8: // SETMULTIPLEX
+  case 0xD3: // SETDISPLAYOFFSET
+  case 0xD5: // SETDISPLAYCLOCKDIV
+  case 0xD9: // SETPRECHARGE
+  case 0xDA: // SETCOMPINS
+  case 0xDB: // SETVCOMDETECT
+    return 1;
+  case 0x21: // COLUMNADDR
+  case 0x22: // PAGEADDR
+  case 0xA3: // SET_VERTICAL_SCROLL_AREA
+    return 2;
+  case 0x29: // VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL
+  case 0x2A: // VERTICAL_AND_LEFT_HORIZONTAL_SCROLL
+    return 5;
+  case 0x26: // RIGHT_HORIZONTAL_SCROLL
+  case 0x27: // LEFT_HORIZONTAL_SCROLL
+    return 6;
+  default:
+    return 0;
+  }
+}
+
+MockPanel::MockPanel() : device(this, NULL, write) { reset(); }
+
+void MockPanel::reset() {
+  memset(ram, 0, sizeof(ram));
+  pendingCount = 0;
+  col1 = col = 0;
+  col2 = 127;
+  page1 = page = 0;
+  page2 = 7;
+  displayOn = false;
+  resetCounters();
+}
+
+void MockPanel::resetCounters() {
+  cmdCount = 0;
+  transmissions = 0;
+  bytes = 0;
+  dataBytes = 0;
+}
+
+bool MockPanel::matches(const uint8_t *buffer, int width, int height,
+                        int colOffset) const {
+  for (int p = 0; p < (height + 7) / 8; p++) {
+    if (memcmp(&ram[p][colOffset], &buffer[p * width], width))
+      return false;
+  }
+  return true;
+}
+
+void MockPanel::command(uint8_t c) {
+  if (cmdCount < (int)sizeof(cmds))
+    cmds[cmdCount++] = c;
+  pending[pendingCount++] = c;
+  if (pendingCount <= argCount(pending[0]))
+    return; // Arguments still to come
+  switch (pending[0]) {
+  case 0x21:
+    col1 = col = pending[1] & 0x7F;
+    col2 = pending[2] & 0x7F;
+    break;
+  case 0x22:
+    page1 = page = pending[1] & 0x07;
+    page2 = pending[2] & 0x07;
+    break;
+  case 0xAE:
+    displayOn = false;
+    break;
+  case 0xAF:
+    displayOn = true;
+    break;
+  }
+  pendingCount = 0;
+}
+
+void MockPanel::data(uint8_t d) {
+  dataBytes++;
+  ram[page][col] = d;
+  if (col++ == col2) {
+    col = col1;
+    if (page++ == page2)
+      page = page1;
+  }
+}
+
+bool MockPanel::write(void *obj, const uint8_t *buffer, size_t len) {
+  MockPanel *panel = (MockPanel *)obj;
+  panel->transmissions++;
+  panel->bytes += len;
+  panel->cmdCount = 0;
+  size_t i = 0;
+  while (i < len) {
+    uint8_t control = buffer[i++];
+    bool dc = control & 0x40;
+    if (control & 0x80) { // Co = 1: one byte, then another control byte
+      if (i < len)
+        dc ? panel->data(buffer[i++]) : panel->command(buffer[i++]);
+    } else { // Co = 0: the rest of the transmission
+      while (i < len)
+        dc ? panel->data(buffer[i++]) : panel->command(buffer[i++]);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,65 @@
+#ifndef MOCK_PANEL_H_
+#define MOCK_PANEL_H_
+
+// SSD1306 controller model behind an Adafruit_GenericDevice write function.
+// Each write() is one I2C transmission: control bytes, commands with their
+// arguments and data are decoded as the chip would, and data lands in a
+// 128x64 GDDRAM model (horizontal addressing, the only mode the library
+// uses). Transmissions and bytes are counted for the tests to check.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <Adafruit_GenericDevice.h>
+
+struct MockPanel {
+  uint8_t ram[8][128];
+  uint8_t cmds[64]; // Command bytes of the last transmission
+  int cmdCount;
+  int transmissions;
+  long bytes;
+  long dataBytes;
+  bool displayOn;
+
+  // Parser state, kept across transmissions like the chip does
+  uint8_t pending[8];
+  int pendingCount;
+  uint8_t col1, col2, page1, page2, col, page;
+
+  Adafruit_GenericDevice device;
+
+  MockPanel();
+  void reset();
+  void resetCounters();
+  // True if GDDRAM columns colOffset.. hold buffer (page-major, width wide)
+  bool matches(const uint8_t *buffer, int width, int height,
+               int colOffset = 0) const;
+
+  static bool write(void *obj, const uint8_t *buffer, size_t len);
+
+private:
+  void command(uint8_t c);
+  void data(uint8_t d);
+};
+
+extern int mock_failures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      mock_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                             \
+  do {                                                                         \
+    long a_ = (long)(actual), e_ = (long)(expected);                           \
+    if (a_ != e_) {                                                            \
+      fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__,  \
+              #actual, a_, e_);                                                \
+      mock_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#endif // MOCK_PANEL_H_
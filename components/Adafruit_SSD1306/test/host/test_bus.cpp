@@ -0,0 +1,47 @@
+// Byte streams Adafruit_SSD1306 sends through an Adafruit_GenericDevice,
+// decoded by the controller model in mock_panel.cpp.
+
+#include <Adafruit_SSD1306.h>
+
+#include "mock_panel.h"
+
+static void testBegin(void) {
+  MockPanel panel;
+  Adafruit_SSD1306 oled(128, 64, &panel.device);
+  CHECK(oled.begin());
+
+  // Command lists go out whole, single commands one transmission each
+  CHECK_EQ(panel.transmissions, 12);
+  CHECK_EQ(panel.dataBytes, 0);
+  CHECK(panel.displayOn);
+
+  // A full frame is one transmission: six Co=1 commands, 0x40, the data
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.bytes, SSD1306_BUS_PREAMBLE + 128 * 64 / 8);
+  CHECK(panel.matches(oled.getBuffer(), 128, 64));
+}
+
+static void testSmallPanel(void) {
+  // 64x32 modules sit in the middle of the 128-column RAM
+  MockPanel panel;
+  Adafruit_SSD1306 oled(64, 32, &panel.device);
+  CHECK(oled.begin());
+  oled.fillRect(5, 5, 20, 20, SSD1306_WHITE);
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.bytes, SSD1306_BUS_PREAMBLE + 64 * 32 / 8);
+  CHECK(panel.matches(oled.getBuffer(), 64, 32, 0x20));
+}
+
+int main(void) {
+  testBegin();
+  testSmallPanel();
+
+  if (mock_failures)
+    return 1;
+  printf("test_bus: ok\n");
+  return 0;
+}
@@ -0,0 +1,182 @@
+// Double-buffered display(): frames handed to the flush thread, through a
+// bus that can hold a transmission in flight and slow every one down.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Adafruit_SSD1306.h>
+
+#include "mock_panel.h"
+
+// The controller model behind a bus that logs 'D' for each transmission
+// carrying data and 'C' for commands only, and keeps the RAM after each
+// data transmission
+struct SlowBus {
+  MockPanel panel;
+  Adafruit_GenericDevice device;
+  std::chrono::microseconds delay{0};
+  std::mutex lock;
+  std::condition_variable cond;
+  bool hold = false, held = false;
+  std::atomic<int> active{0}, overlaps{0};
+  std::string log;
+  std::vector<std::vector<uint8_t>> frames;
+
+  SlowBus() : device(this, NULL, write) {}
+
+  static bool write(void *obj, const uint8_t *buffer, size_t len) {
+    SlowBus *bus = (SlowBus *)obj;
+    if (bus->active++)
+      bus->overlaps++;
+    std::this_thread::sleep_for(bus->delay);
+    std::unique_lock<std::mutex> lock(bus->lock);
+    if (bus->hold) {
+      bus->held = true;
+      bus->cond.notify_all();
+      bus->cond.wait_for(lock, std::chrono::seconds(2),
+                         [bus] { return !bus->hold; });
+      bus->held = false;
+    }
+    long data = bus->panel.dataBytes;
+    MockPanel::write(&bus->panel, buffer, len);
+    bool frame = bus->panel.dataBytes != data;
+    bus->log += frame ? 'D' : 'C';
+    if (frame)
+      bus->frames.emplace_back(&bus->panel.ram[0][0],
+                               &bus->panel.ram[0][0] + 1024);
+    lock.unlock();
+    bus->active--;
+    return true;
+  }
+
+  // Wait up to a second for a transmission to be held
+  bool waitHeld(void) {
+    std::unique_lock<std::mutex> l(lock);
+    return cond.wait_for(l, std::chrono::seconds(1), [this] { return held; });
+  }
+
+  void release(void) {
+    std::lock_guard<std::mutex> l(lock);
+    hold = false;
+    cond.notify_all();
+  }
+};
+
+static void testHandOver(void) {
+  SlowBus bus;
+  Adafruit_SSD1306 oled(128, 64, &bus.device);
+  CHECK(oled.begin());
+  CHECK(oled.setDoubleBuffer(true));
+  CHECK(oled.setDoubleBuffer(true)); // Already on
+
+  // display() returns while its frame is still on the bus, and drawing
+  // after it does not reach that frame
+  oled.fillCircle(64, 32, 20, SSD1306_WHITE);
+  std::vector<uint8_t> sent(oled.getBuffer(), oled.getBuffer() + 1024);
+  bus.hold = true;
+  oled.display();
+  CHECK(bus.waitHeld());
+  oled.fillRect(0, 0, 128, 64, SSD1306_INVERSE);
+  bus.release();
+  oled.waitForFlush();
+  CHECK(bus.panel.matches(sent.data(), 128, 64));
+  CHECK(!bus.panel.matches(oled.getBuffer(), 128, 64));
+
+  // Off again: display() sends before returning
+  CHECK(oled.setDoubleBuffer(false));
+  oled.display();
+  CHECK(bus.panel.matches(oled.getBuffer(), 128, 64));
+}
+
+static void testFrames(void) {
+  SlowBus bus;
+  bus.delay = std::chrono::microseconds(300);
+  Adafruit_SSD1306 oled(128, 64, &bus.device);
+  CHECK(oled.begin());
+  CHECK(oled.setDoubleBuffer(true));
+
+  // Every frame arrives whole and in order, none dropped or mixed with the
+  // next one being drawn
+  std::vector<std::vector<uint8_t>> expect;
+  for (int i = 0; i < 100; i++) {
+    oled.clearDisplay();
+    oled.fillCircle(64, 32, i % 30, SSD1306_WHITE);
+    oled.setCursor(0, 0);
+    oled.setTextColor(SSD1306_WHITE);
+    char text[12];
+    snprintf(text, sizeof(text), "%d", i);
+    oled.print(text);
+    expect.emplace_back(oled.getBuffer(), oled.getBuffer() + 1024);
+    oled.display();
+  }
+  oled.waitForFlush();
+  CHECK(bus.frames == expect);
+
+  // Commands wait for the frame in flight instead of cutting into it
+  bus.log.clear();
+  oled.display();
+  oled.invertDisplay(true);
+  oled.display();
+  oled.dim(true);
+  oled.waitForFlush();
+  CHECK(bus.log == "DCDCC");
+  CHECK_EQ(bus.overlaps, 0);
+
+  // Partial updates hand over the dirty ranges with the frame
+  oled.setPartialUpdate(true);
+  oled.display();
+  oled.waitForFlush();
+  bus.panel.resetCounters();
+  oled.drawPixel(3, 3, SSD1306_WHITE);
+  oled.display();
+  oled.drawPixel(100, 60, SSD1306_WHITE);
+  oled.display();
+  oled.waitForFlush();
+  CHECK_EQ(bus.panel.transmissions, 2);
+  CHECK_EQ(bus.panel.dataBytes, 2);
+  CHECK(bus.panel.matches(oled.getBuffer(), 128, 64));
+  CHECK(oled.setDoubleBuffer(false));
+}
+
+// Frames of 2 ms of drawing and 2 ms of bus time, with and without the
+// flush thread
+static double frameTime(bool doubleBuffer) {
+  SlowBus bus;
+  bus.delay = std::chrono::microseconds(2000);
+  Adafruit_SSD1306 oled(128, 64, &bus.device);
+  CHECK(oled.begin());
+  CHECK(oled.setDoubleBuffer(doubleBuffer));
+  const int n = 50;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    oled.display();
+  }
+  oled.waitForFlush();
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+  CHECK(oled.setDoubleBuffer(false));
+  return s / n * 1e3;
+}
+
+int main(void) {
+  testHandOver();
+  testFrames();
+
+  double sync = frameTime(false), overlapped = frameTime(true);
+  CHECK(overlapped < sync * 0.9);
+  printf("  2 ms drawing + 2 ms bus per frame: %.1f ms synchronous, %.1f ms "
+         "double-buffered\n",
+         sync, overlapped);
+
+  if (mock_failures)
+    return 1;
+  printf("test_double_buffer: ok\n");
+  return 0;
+}
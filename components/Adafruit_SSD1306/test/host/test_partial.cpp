@@ -0,0 +1,158 @@
+// Partial display(): the dirty column ranges drawing leaves per page, and the
+// windows display() turns them into, decoded by the model in mock_panel.cpp.
+
+#include <Adafruit_SSD1306.h>
+
+#include "mock_panel.h"
+
+// Exposes the per-page dirty ranges display() is about to send
+class Probe : public Adafruit_SSD1306 {
+public:
+  using Adafruit_SSD1306::Adafruit_SSD1306;
+  bool dirty(uint8_t page) const { return dirty_x1[page] <= dirty_x2[page]; }
+  uint8_t x1(uint8_t page) const { return dirty_x1[page]; }
+  uint8_t x2(uint8_t page) const { return dirty_x2[page]; }
+};
+
+static void testWindows(void) {
+  MockPanel panel;
+  Probe oled(128, 64, &panel.device);
+  CHECK(oled.begin());
+  oled.display();
+  oled.setPartialUpdate(true);
+
+  // Nothing drawn, nothing sent
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 0);
+
+  // One pixel is one byte of data
+  oled.drawPixel(10, 10, SSD1306_WHITE);
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.bytes, SSD1306_BUS_PREAMBLE + 1);
+
+  // A full-height line is one column of every page: one window
+  oled.drawFastVLine(5, 0, 64, SSD1306_WHITE);
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.bytes, SSD1306_BUS_PREAMBLE + 8);
+
+  // Close columns on neighbouring pages share a window...
+  oled.drawPixel(10, 0, SSD1306_WHITE);
+  oled.drawPixel(12, 8, SSD1306_WHITE);
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.dataBytes, 2 * 3);
+
+  // ...far apart they don't, and neither do pages with a clean one between
+  oled.drawPixel(0, 0, SSD1306_WHITE);
+  oled.drawPixel(120, 8, SSD1306_WHITE);
+  oled.drawPixel(60, 24, SSD1306_WHITE);
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 3);
+  CHECK_EQ(panel.bytes, 3 * (SSD1306_BUS_PREAMBLE + 1));
+  CHECK(panel.matches(oled.getBuffer(), 128, 64));
+
+  // clearDisplay() and markDirty() send the whole frame
+  oled.clearDisplay();
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.dataBytes, 1024);
+  memset(oled.getBuffer(), 0x5A, 1024);
+  oled.markDirty();
+  panel.resetCounters();
+  oled.display();
+  CHECK_EQ(panel.transmissions, 1);
+  CHECK_EQ(panel.dataBytes, 1024);
+  CHECK(panel.matches(oled.getBuffer(), 128, 64));
+}
+
+static void testRandom(void) {
+  MockPanel panel;
+  Probe oled(128, 64, &panel.device);
+  CHECK(oled.begin());
+  oled.display();
+  oled.setPartialUpdate(true);
+
+  // Random drawing in every rotation: every changed byte is inside its
+  // page's dirty range, merged windows never cost more than one window per
+  // dirty page, and the panel always ends up equal to the buffer
+  static uint8_t before[1024];
+  srand(1);
+  long sent = 0;
+  const int updates = 2000;
+  for (int i = 0; i < updates; i++) {
+    memcpy(before, oled.getBuffer(), sizeof(before));
+    oled.setRotation(i & 3);
+    int16_t x = rand() % 160 - 16, y = rand() % 160 - 16;
+    int16_t w = rand() % 40, h = rand() % 40;
+    uint16_t color = rand() % 3;
+    switch (rand() % 6) {
+    case 0:
+      oled.fillRect(x, y, w, h, color);
+      break;
+    case 1:
+      oled.drawLine(x, y, x + w, y + h, color);
+      break;
+    case 2:
+      oled.fillCircle(x, y, w / 2, color);
+      break;
+    case 3:
+      oled.setTextColor(color);
+      oled.setCursor(x, y);
+      oled.print("12:34");
+      break;
+    case 4:
+      oled.drawFastHLine(x, y, w, color);
+      oled.drawFastVLine(x, y, h, color);
+      break;
+    default:
+      oled.drawPixel(x, y, color);
+      break;
+    }
+
+    long separate = 0;
+    for (uint8_t p = 0; p < 8; p++) {
+      for (int c = 0; c < 128; c++) {
+        if (oled.getBuffer()[p * 128 + c] == before[p * 128 + c])
+          continue;
+        if (!oled.dirty(p) || (c < oled.x1(p)) || (c > oled.x2(p))) {
+          fprintf(stderr, "update %d: page %d column %d changed, not dirty\n",
+                  i, p, c);
+          mock_failures++;
+          return;
+        }
+      }
+      if (oled.dirty(p))
+        separate += SSD1306_BUS_PREAMBLE + oled.x2(p) - oled.x1(p) + 1;
+    }
+
+    panel.resetCounters();
+    oled.display();
+    sent += panel.bytes;
+    CHECK(panel.bytes <= separate);
+    if (!panel.matches(oled.getBuffer(), 128, 64)) {
+      fprintf(stderr, "update %d: panel differs from the buffer\n", i);
+      mock_failures++;
+      return;
+    }
+  }
+  printf("  partial 128x64: %.1f bytes per update, %d for a full frame\n",
+         (double)sent / updates, SSD1306_BUS_PREAMBLE + 1024);
+}
+
+int main(void) {
+  testWindows();
+  testRandom();
+
+  if (mock_failures)
+    return 1;
+  printf("test_partial: ok\n");
+  return 0;
+}
@@ -0,0 +1,84 @@
+#ifndef CAN_RING_H_
+#define CAN_RING_H_
+
+#include <stddef.h>
+#include <atomic>
+
+#include "can.h"
+
+/*
+ * Single-producer single-consumer ring of CAN frames.
+ * One task calls push() and one calls pop(); neither takes a lock.
+ * The indices run freely and wrap at 2^32, the capacity is a power of two.
+ */
+class CANRing
+{
+    public:
+        explicit CANRing(size_t capacity)
+        {
+            size_t n = 1;
+            while (n < capacity) {
+                n <<= 1;
+            }
+            frames = new struct can_frame[n];
+            mask = n - 1;
+        }
+
+        ~CANRing()
+        {
+            delete[] frames;
+        }
+
+        CANRing(const CANRing &) = delete;
+        CANRing &operator=(const CANRing &) = delete;
+
+        // Producer side. Returns false and counts an overflow when full.
+        bool push(const struct can_frame *frame)
+        {
+            uint32_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) > mask) {
+                overflows.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            frames[h & mask] = *frame;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Returns false when empty.
+        bool pop(struct can_frame *frame)
+        {
+            uint32_t t = tail.load(std::memory_order_relaxed);
+            if (t == head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            *frame = frames[t & mask];
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t size() const
+        {
+            uint32_t t = tail.load(std::memory_order_acquire);
+            return head.load(std::memory_order_acquire) - t;
+        }
+
+        size_t capacity() const
+        {
+            return mask + 1;
+        }
+
+        uint32_t getOverflows() const
+        {
+            return overflows.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct can_frame *frames;
+        uint32_t mask;
+        std::atomic<uint32_t> head{0};      // written by the producer
+        std::atomic<uint32_t> tail{0};      // written by the consumer
+        std::atomic<uint32_t> overflows{0}; // frames dropped by push()
+};
+
+#endif /* CAN_RING_H_ */
@@ -2,14 +2,14 @@
 #include "mcp2515.h"
 
 const struct MCP2515::TXBn_REGS MCP2515::TXB[MCP2515::N_TXBUFFERS] = {
-    {MCP_TXB0CTRL, MCP_TXB0SIDH, MCP_TXB0DATA},
-    {MCP_TXB1CTRL, MCP_TXB1SIDH, MCP_TXB1DATA},
-    {MCP_TXB2CTRL, MCP_TXB2SIDH, MCP_TXB2DATA}
+    {MCP_TXB0CTRL, MCP_TXB0SIDH, MCP_TXB0DATA, INSTRUCTION_LOAD_TX0, INSTRUCTION_RTS_TX0, STAT_TX0REQ},
+    {MCP_TXB1CTRL, MCP_TXB1SIDH, MCP_TXB1DATA, INSTRUCTION_LOAD_TX1, INSTRUCTION_RTS_TX1, STAT_TX1REQ},
+    {MCP_TXB2CTRL, MCP_TXB2SIDH, MCP_TXB2DATA, INSTRUCTION_LOAD_TX2, INSTRUCTION_RTS_TX2, STAT_TX2REQ}
 };
 
 const struct MCP2515::RXBn_REGS MCP2515::RXB[N_RXBUFFERS] = {
-    {MCP_RXB0CTRL, MCP_RXB0SIDH, MCP_RXB0DATA, CANINTF_RX0IF},
-    {MCP_RXB1CTRL, MCP_RXB1SIDH, MCP_RXB1DATA, CANINTF_RX1IF}
+    {MCP_RXB0CTRL, MCP_RXB0SIDH, MCP_RXB0DATA, CANINTF_RX0IF, INSTRUCTION_READ_RX0},
+    {MCP_RXB1CTRL, MCP_RXB1SIDH, MCP_RXB1DATA, CANINTF_RX1IF, INSTRUCTION_READ_RX1}
 };
 
 MCP2515::MCP2515(const uint8_t _CS, const uint32_t _SPI_CLOCK, SPIClass * _SPI)
@@ -24,6 +24,13 @@ MCP2515::MCP2515(const uint8_t _CS, const uint32_t _SPI_CLOCK, SPIClass * _SPI)
 
     SPICS = _CS;
     SPI_CLOCK = _SPI_CLOCK;
+#ifdef ESP32
+    rxRing = nullptr;
+    rxTask = nullptr;
+    rxStop = false;
+    rxIntPin = 0;
+    rxChipOverflows = 0;
+#endif
     pinMode(SPICS, OUTPUT);
     digitalWrite(SPICS, HIGH);
 }
@@ -614,14 +621,20 @@ MCP2515::ERROR MCP2515::sendMessage(const TXBn txbn, const struct can_frame *fra
 
     memcpy(&data[MCP_DATA], frame->data, frame->can_dlc);
 
-    setRegisters(txbuf->SIDH, data, 5 + frame->can_dlc);
+    // LOAD TX BUFFER: id, DLC and data in one burst, no address byte
+    startSPI();
+    SPIn->transfer(txbuf->LOAD_TX);
+    for (uint8_t i=0; i<5 + frame->can_dlc; i++) {
+        SPIn->transfer(data[i]);
+    }
+    endSPI();
 
-    modifyRegister(txbuf->CTRL, TXB_TXREQ, TXB_TXREQ);
+    // RTS sets TXREQ, which also clears ABTF, MLOA and TXERR, so there is
+    // nothing to read back until the frame has been on the bus
+    startSPI();
+    SPIn->transfer(txbuf->RTS);
+    endSPI();
 
-    uint8_t ctrl = readRegister(txbuf->CTRL);
-    if ((ctrl & (TXB_ABTF | TXB_MLOA | TXB_TXERR)) != 0) {
-        return ERROR_FAILTX;
-    }
     return ERROR_OK;
 }
 
@@ -633,10 +646,11 @@ MCP2515::ERROR MCP2515::sendMessage(const struct can_frame *frame)
 
     TXBn txBuffers[N_TXBUFFERS] = {TXB0, TXB1, TXB2};
 
+    // READ STATUS has the TXREQ bit of all three buffers
+    uint8_t stat = getStatus();
     for (int i=0; i<N_TXBUFFERS; i++) {
         const struct TXBn_REGS *txbuf = &TXB[txBuffers[i]];
-        uint8_t ctrlval = readRegister(txbuf->CTRL);
-        if ( (ctrlval & TXB_TXREQ) == 0 ) {
+        if ( (stat & txbuf->STAT_TXnREQ) == 0 ) {
             return sendMessage(txBuffers[i], frame);
         }
     }
@@ -650,39 +664,57 @@ MCP2515::ERROR MCP2515::readMessage(const RXBn rxbn, struct can_frame *frame)
 
     uint8_t tbufdata[5];
 
-    readRegisters(rxb->SIDH, tbufdata, 5);
+    // READ RX BUFFER: header and data in one burst, no address byte.
+    // Raising CS clears RXnIF, also when the frame is dropped below.
+    startSPI();
+    SPIn->transfer(rxb->READ_RX);
+    for (uint8_t i=0; i<5; i++) {
+        tbufdata[i] = SPIn->transfer(0x00);
+    }
+
+    uint8_t dlc = (tbufdata[MCP_DLC] & DLC_MASK);
+    if (dlc > CAN_MAX_DLEN) {
+        endSPI();
+        return ERROR_FAIL;
+    }
+
+    for (uint8_t i=0; i<dlc; i++) {
+        frame->data[i] = SPIn->transfer(0x00);
+    }
+    endSPI();
 
     uint32_t id = (tbufdata[MCP_SIDH]<<3) + (tbufdata[MCP_SIDL]>>5);
 
+    // RTR is in SIDL.SRR for standard frames and DLC.RTR for extended ones,
+    // the same as RXBnCTRL.RXRTR without reading it
+    bool rtr;
     if ( (tbufdata[MCP_SIDL] & TXB_EXIDE_MASK) ==  TXB_EXIDE_MASK ) {
         id = (id<<2) + (tbufdata[MCP_SIDL] & 0x03);
         id = (id<<8) + tbufdata[MCP_EID8];
         id = (id<<8) + tbufdata[MCP_EID0];
         id |= CAN_EFF_FLAG;
+        rtr = (tbufdata[MCP_DLC] & RTR_MASK) != 0;
+    } else {
+        rtr = (tbufdata[MCP_SIDL] & RXBnSIDL_SRR) != 0;
     }
-
-    uint8_t dlc = (tbufdata[MCP_DLC] & DLC_MASK);
-    if (dlc > CAN_MAX_DLEN) {
-        return ERROR_FAIL;
-    }
-
-    uint8_t ctrl = readRegister(rxb->CTRL);
-    if (ctrl & RXBnCTRL_RTR) {
+    if (rtr) {
         id |= CAN_RTR_FLAG;
     }
 
     frame->can_id = id;
     frame->can_dlc = dlc;
 
-    readRegisters(rxb->DATA, frame->data, dlc);
-
-    modifyRegister(MCP_CANINTF, rxb->CANINTF_RXnIF, 0);
-
     return ERROR_OK;
 }
 
 MCP2515::ERROR MCP2515::readMessage(struct can_frame *frame)
 {
+#ifdef ESP32
+    if (rxRing != nullptr) {
+        return rxRing->pop(frame) ? ERROR_OK : ERROR_NOMSG;
+    }
+#endif
+
     ERROR rc;
     uint8_t stat = getStatus();
 
@@ -781,4 +813,139 @@ uint8_t MCP2515::errorCountRX(void)
 uint8_t MCP2515::errorCountTX(void)                             
 {
     return readRegister(MCP_TEC);
-}
\ No newline at end of file
+}
+
+#ifdef ESP32
+/*
+ * Interrupt-driven receive.
+ * The INT pin (active low) wakes a task that drains RXB0/RXB1 into a ring as
+ * soon as a frame lands, so the two hardware buffers do not overflow between
+ * polls. readMessage(frame) then pops from the ring without any SPI traffic.
+ * While it runs, do not call readMessage(rxbn, frame) or change CANINTE, and
+ * only call readMessage(frame) from one task.
+ */
+MCP2515::ERROR MCP2515::beginRxInterrupt(const uint8_t intPin, const size_t ringSize, const UBaseType_t priority)
+{
+    if (rxRing != nullptr) {
+        return ERROR_FAIL;
+    }
+
+    rxRing = new CANRing(ringSize);
+    rxStop = false;
+    rxIntPin = intPin;
+    rxChipOverflows = 0;
+
+    // INT is only driven by flags the task clears, so it always goes high again
+    setRegister(MCP_CANINTE, CANINTF_RX0IF | CANINTF_RX1IF | CANINTF_ERRIF | CANINTF_MERRF);
+
+    TaskHandle_t task;
+    if (xTaskCreate(rxTaskMain, "mcp2515_rx", RX_TASK_STACK, this, priority, &task) != pdPASS) {
+        delete rxRing;
+        rxRing = nullptr;
+        return ERROR_FAIL;
+    }
+    rxTask = task;
+
+    pinMode(rxIntPin, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(rxIntPin), rxISR, this, FALLING);
+    // Pick up a frame that was already pending (INT low, no edge to come)
+    xTaskNotifyGive(task);
+    return ERROR_OK;
+}
+
+void MCP2515::endRxInterrupt(void)
+{
+    if (rxRing == nullptr) {
+        return;
+    }
+
+    detachInterrupt(digitalPinToInterrupt(rxIntPin));
+    // Let the task finish its SPI transfers and exit by itself
+    rxStop = true;
+    xTaskNotifyGive(rxTask);
+    while (rxTask != nullptr) {
+        delay(1);
+    }
+
+    delete rxRing;
+    rxRing = nullptr;
+}
+
+size_t MCP2515::availableMessages(void)
+{
+    return (rxRing != nullptr) ? rxRing->size() : 0;
+}
+
+// Frames drained from the chip but dropped because the ring was full
+uint32_t MCP2515::getRxRingOverflows(void)
+{
+    return (rxRing != nullptr) ? rxRing->getOverflows() : 0;
+}
+
+// Overflows inside the chip (RX0OVR/RX1OVR seen) before the task drained
+// RXB0/RXB1. Each one lost at least one frame.
+uint32_t MCP2515::getRxChipOverflows(void)
+{
+    return rxChipOverflows.load(std::memory_order_relaxed);
+}
+
+void IRAM_ATTR MCP2515::rxISR(void *arg)
+{
+    MCP2515 *mcp = static_cast<MCP2515 *>(arg);
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(mcp->rxTask, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void MCP2515::rxTaskMain(void *arg)
+{
+    MCP2515 *mcp = static_cast<MCP2515 *>(arg);
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (mcp->rxStop) {
+            break;
+        }
+        mcp->drainRx();
+    }
+    mcp->rxTask = nullptr;
+    vTaskDelete(NULL);
+}
+
+// Loop until no enabled flag is left, so INT is high again and the next
+// frame gives a new falling edge.
+void MCP2515::drainRx(void)
+{
+    const uint8_t enabled = CANINTF_RX0IF | CANINTF_RX1IF | CANINTF_ERRIF | CANINTF_MERRF;
+    uint8_t irq;
+
+    while ((irq = getInterrupts() & enabled) != 0) {
+        struct can_frame frame;
+
+        // RXB0 first: after a rollover it holds the older frame
+        for (int i=0; i<N_RXBUFFERS; i++) {
+            if ((irq & RXB[i].CANINTF_RXnIF) == 0) {
+                continue;
+            }
+            // A frame with a bad DLC is dropped, its flag is cleared all the same
+            if (readMessage((RXBn)i, &frame) == ERROR_OK) {
+                rxRing->push(&frame);
+            }
+        }
+
+        if (irq & CANINTF_ERRIF) {
+            uint8_t eflg = getErrorFlags();
+            if (eflg & (EFLG_RX0OVR | EFLG_RX1OVR)) {
+                rxChipOverflows.fetch_add(((eflg & EFLG_RX0OVR) ? 1 : 0) + ((eflg & EFLG_RX1OVR) ? 1 : 0), std::memory_order_relaxed);
+                clearRXnOVRFlags();
+            }
+            clearERRIF();
+        }
+
+        if (irq & CANINTF_MERRF) {
+            clearMERR();
+        }
+    }
+}
+#endif
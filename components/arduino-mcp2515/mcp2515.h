@@ -4,6 +4,12 @@
 #include <SPI.h>
 #include "can.h"
 
+#ifdef ESP32
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "can_ring.h"
+#endif
+
 /*
  *  Speed 8M
  */
@@ -296,6 +302,7 @@ class MCP2515
         static const uint8_t RXBnCTRL_RXM_STDEXT = 0x00;
         static const uint8_t RXBnCTRL_RXM_MASK   = 0x60;
         static const uint8_t RXBnCTRL_RTR        = 0x08;
+        static const uint8_t RXBnSIDL_SRR        = 0x10;
         static const uint8_t RXB0CTRL_BUKT       = 0x04;
         static const uint8_t RXB0CTRL_FILHIT_MASK = 0x03;
         static const uint8_t RXB1CTRL_FILHIT_MASK = 0x07;
@@ -311,7 +318,10 @@ class MCP2515
 
         enum /*class*/ STAT : uint8_t {
             STAT_RX0IF = (1<<0),
-            STAT_RX1IF = (1<<1)
+            STAT_RX1IF = (1<<1),
+            STAT_TX0REQ = (1<<2),
+            STAT_TX1REQ = (1<<4),
+            STAT_TX2REQ = (1<<6)
         };
 
         static const uint8_t STAT_RXIF_MASK = STAT_RX0IF | STAT_RX1IF;
@@ -431,6 +441,11 @@ class MCP2515
 
         static const uint32_t DEFAULT_SPI_CLOCK = 10000000; // 10MHz
 
+#ifdef ESP32
+        static const size_t DEFAULT_RX_RING_SIZE = 32;
+        static const uint32_t RX_TASK_STACK = 3072;
+#endif
+
         static const int N_TXBUFFERS = 3;
         static const int N_RXBUFFERS = 2;
 
@@ -438,6 +453,9 @@ class MCP2515
             REGISTER CTRL;
             REGISTER SIDH;
             REGISTER DATA;
+            INSTRUCTION LOAD_TX;    // writes from SIDH on
+            INSTRUCTION RTS;
+            STAT     STAT_TXnREQ;
         } TXB[N_TXBUFFERS];
 
         static const struct RXBn_REGS {
@@ -445,6 +463,7 @@ class MCP2515
             REGISTER SIDH;
             REGISTER DATA;
             CANINTF  CANINTF_RXnIF;
+            INSTRUCTION READ_RX;    // reads from SIDH on, clears RXnIF at the end
         } RXB[N_RXBUFFERS];
 
         uint8_t SPICS;
@@ -465,6 +484,19 @@ class MCP2515
         void modifyRegister(const REGISTER reg, const uint8_t mask, const uint8_t data);
 
         void prepareId(uint8_t *buffer, const bool ext, const uint32_t id);
+
+#ifdef ESP32
+        // Interrupt-driven receive, see beginRxInterrupt()
+        CANRing *rxRing;
+        std::atomic<TaskHandle_t> rxTask;
+        std::atomic<bool> rxStop;
+        uint8_t rxIntPin;
+        std::atomic<uint32_t> rxChipOverflows;
+
+        static void rxISR(void *arg);
+        static void rxTaskMain(void *arg);
+        void drainRx(void);
+#endif
     
     public:
         MCP2515(const uint8_t _CS, const uint32_t _SPI_CLOCK = DEFAULT_SPI_CLOCK, SPIClass * _SPI = nullptr);
@@ -498,6 +530,13 @@ class MCP2515
         void clearERRIF();
         uint8_t errorCountRX(void);
         uint8_t errorCountTX(void);
+#ifdef ESP32
+        ERROR beginRxInterrupt(const uint8_t intPin, const size_t ringSize = DEFAULT_RX_RING_SIZE, const UBaseType_t priority = configMAX_PRIORITIES - 2);
+        void endRxInterrupt(void);
+        size_t availableMessages(void);
+        uint32_t getRxRingOverflows(void);
+        uint32_t getRxChipOverflows(void);
+#endif
 };
 
 #endif
\ No newline at end of file
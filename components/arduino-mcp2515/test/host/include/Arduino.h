@@ -0,0 +1,28 @@
+#pragma once
+// Just enough of the ESP32 Arduino core for mcp2515.cpp
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define FALLING 0x02
+#define MSBFIRST 1
+#define IRAM_ATTR
+
+#define digitalPinToInterrupt(p) (p)
+
+using std::min;
+using std::max;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+void delay(unsigned long ms);
+unsigned long millis(void);
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode);
+void detachInterrupt(uint8_t pin);
@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+
+class SPISettings
+{
+    public:
+        SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {}
+};
+
+// Transfers go to the simulated MCP2515 in mcp2515_sim.cpp
+class SPIClass
+{
+    public:
+        void begin() {}
+        void beginTransaction(SPISettings settings);
+        void endTransaction();
+        uint8_t transfer(uint8_t data);
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define portMAX_DELAY 0xffffffffu
+#define portYIELD_FROM_ISR() do {} while (0)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define configMAX_PRIORITIES 25
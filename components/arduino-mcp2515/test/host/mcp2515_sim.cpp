@@ -0,0 +1,260 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "freertos/task.h"
+#include "mcp2515_sim.h"
+
+// Registers the model gives meaning to
+enum {
+    CANSTAT  = 0x0E,
+    CANCTRL  = 0x0F,
+    CANINTE  = 0x2B,
+    CANINTF  = 0x2C,
+    EFLG     = 0x2D,
+    TXB0CTRL = 0x30,
+    RXB0CTRL = 0x60,
+    RXB1CTRL = 0x70
+};
+
+SPIClass SPI;
+std::atomic<long> sim_spi_bytes{0};
+std::atomic<long> sim_spi_transactions{0};
+std::atomic<long> sim_chip_lost{0};
+int sim_failures = 0;
+void (*sim_transmitted)(const uint8_t *sidh) = [](const uint8_t *) {};
+
+static std::mutex spiLock;   // SPIClass transaction lock, as in arduino-esp32
+static std::mutex chipLock;  // chip state, shared with the bus thread
+static uint8_t reg[128];
+static int idx, cmd, addr, mask;
+static bool intLow;
+static void (*isr)(void *);
+static void *isrArg;
+
+// Keep SPI time roughly real (10 MHz plus overhead) so the receive task has
+// to keep up with the bus
+static void spin_us(int us)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// Returns true if INT just fell
+static bool updateInt(void)
+{
+    bool low = (reg[CANINTF] & reg[CANINTE]) != 0;
+    bool fell = low && !intLow;
+    intLow = low;
+    return fell;
+}
+
+static void fireIfFell(bool fell)
+{
+    if (fell && isr) {
+        isr(isrArg);
+    }
+}
+
+void sim_reset_counters(void)
+{
+    sim_spi_bytes = 0;
+    sim_spi_transactions = 0;
+    sim_chip_lost = 0;
+}
+
+void SPIClass::beginTransaction(SPISettings settings) { spiLock.lock(); }
+void SPIClass::endTransaction() { spiLock.unlock(); }
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+    spin_us(1);
+    sim_spi_bytes++;
+    std::lock_guard<std::mutex> lock(chipLock);
+    uint8_t out = 0;
+    if (idx == 0) {
+        cmd = data;
+        if (cmd == 0xC0) {                      // RESET
+            memset(reg, 0, sizeof(reg));
+        }
+    } else if (cmd == 0x03) {                   // READ
+        if (idx == 1) addr = data; else out = reg[addr++ & 0x7F];
+    } else if (cmd == 0x02) {                   // WRITE
+        if (idx == 1) addr = data; else reg[addr++ & 0x7F] = data;
+    } else if (cmd == 0x05) {                   // BIT MODIFY
+        if (idx == 1) addr = data;
+        else if (idx == 2) mask = data;
+        else if (idx == 3) reg[addr] = (reg[addr] & ~mask) | (data & mask);
+    } else if (cmd == 0xA0) {                   // READ STATUS
+        uint8_t flags = reg[CANINTF];
+        out = (flags & 0x03) | ((reg[0x30] & 0x08) ? 0x04 : 0) |
+              ((reg[0x40] & 0x08) ? 0x10 : 0) | ((reg[0x50] & 0x08) ? 0x40 : 0);
+    } else if ((cmd & 0xF8) == 0x40 && cmd <= 0x45) {   // LOAD TX BUFFER
+        if (idx == 1) addr = 0x31 + 16 * ((cmd >> 1) & 3) + ((cmd & 1) ? 5 : 0);
+        reg[addr++ & 0x7F] = data;
+    } else if ((cmd & 0xF9) == 0x90) {          // READ RX BUFFER
+        if (idx == 1) addr = ((cmd & 0x04) ? RXB1CTRL : RXB0CTRL) + ((cmd & 0x02) ? 6 : 1);
+        out = reg[addr++ & 0x7F];
+    }
+    if (cmd == 0x02 || cmd == 0x05) {           // CANSTAT.OPMOD follows REQOP at once
+        reg[CANSTAT] = (reg[CANSTAT] & 0x1F) | (reg[CANCTRL] & 0xE0);
+    }
+    idx++;
+    return out;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin != SIM_CS_PIN) {
+        return;
+    }
+    bool fell = false;
+    {
+        std::lock_guard<std::mutex> lock(chipLock);
+        if (val == LOW) {
+            idx = 0;
+            sim_spi_transactions++;
+            spin_us(2);
+        } else {
+            // READ RX BUFFER clears RXnIF when CS rises
+            if ((cmd & 0xF9) == 0x90 && idx > 0) {
+                reg[CANINTF] &= (cmd & 0x04) ? ~0x02 : ~0x01;
+            }
+            // RTS, or TXREQ set by a register write: the frame goes out at once
+            if ((cmd & 0xF8) == 0x80) {
+                for (int n = 0; n < 3; n++) {
+                    if (cmd & (1 << n)) reg[TXB0CTRL + 16 * n] |= 0x08;
+                }
+            }
+            for (int n = 0; n < 3; n++) {
+                if (reg[TXB0CTRL + 16 * n] & 0x08) {
+                    sim_transmitted(&reg[TXB0CTRL + 16 * n + 1]);
+                    reg[TXB0CTRL + 16 * n] &= ~0x08;
+                }
+            }
+            fell = updateInt();
+        }
+    }
+    fireIfFell(fell);
+}
+
+void sim_receive(uint32_t id, uint32_t seq)
+{
+    bool fell;
+    {
+        std::lock_guard<std::mutex> lock(chipLock);
+        int rxb;
+        if (!(reg[CANINTF] & 0x01)) {
+            rxb = RXB0CTRL;
+        } else if ((reg[RXB0CTRL] & 0x04) && !(reg[CANINTF] & 0x02)) {
+            rxb = RXB1CTRL;                     // BUKT rollover
+        } else {
+            reg[EFLG] |= (reg[RXB0CTRL] & 0x04) ? 0x80 : 0x40;
+            reg[CANINTF] |= 0x20;               // ERRIF
+            sim_chip_lost++;
+            rxb = -1;
+        }
+        if (rxb >= 0) {
+            reg[rxb + 1] = id >> 3;
+            reg[rxb + 2] = (id & 7) << 5;
+            reg[rxb + 5] = 4;
+            memcpy(&reg[rxb + 6], &seq, 4);
+            reg[CANINTF] |= (rxb == RXB0CTRL) ? 0x01 : 0x02;
+        }
+        fell = updateInt();
+    }
+    fireIfFell(fell);
+}
+
+void sim_receive_raw(const uint8_t hdr[5], const uint8_t *data, bool rtr)
+{
+    std::lock_guard<std::mutex> lock(chipLock);
+    memcpy(&reg[RXB0CTRL + 1], hdr, 5);
+    memcpy(&reg[RXB0CTRL + 6], data, 8);
+    reg[RXB0CTRL] = (reg[RXB0CTRL] & ~0x08) | (rtr ? 0x08 : 0);
+    reg[CANINTF] |= 0x01;
+    updateInt();
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode)
+{
+    std::lock_guard<std::mutex> lock(chipLock);
+    isrArg = arg;
+    isr = handler;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    std::lock_guard<std::mutex> lock(chipLock);
+    isr = nullptr;
+}
+
+void delay(unsigned long ms) { usleep(ms * 1000); }
+
+unsigned long millis(void)
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// FreeRTOS: one detached thread per task, notifications on a condition variable
+struct tskTaskControlBlock {
+    std::mutex m;
+    std::condition_variable c;
+    uint32_t notified = 0;
+};
+
+static thread_local TaskHandle_t currentTask;
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stackDepth, void *arg, UBaseType_t priority, TaskHandle_t *createdTask)
+{
+    TaskHandle_t t = new tskTaskControlBlock;
+    *createdTask = t;
+    std::thread([=] {
+        currentTask = t;
+        task(arg);
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL) {
+        delete currentTask;
+        pthread_exit(NULL);
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait)
+{
+    TaskHandle_t t = currentTask;
+    std::unique_lock<std::mutex> lock(t->m);
+    t->c.wait(lock, [t] { return t->notified > 0; });
+    uint32_t value = t->notified;
+    t->notified = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    std::lock_guard<std::mutex> lock(task->m);
+    task->notified++;
+    task->c.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdTRUE;
+    }
+}
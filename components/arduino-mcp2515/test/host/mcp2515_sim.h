@@ -0,0 +1,46 @@
+#ifndef MCP2515_SIM_H_
+#define MCP2515_SIM_H_
+
+// Host model of an MCP2515 behind SPIClass, for driving mcp2515.cpp.
+// The chip implements the SPI instructions the driver uses, both receive
+// buffers with rollover, overflow flags and the INT pin. digitalWrite() on
+// SIM_CS_PIN frames transactions; INT falling calls the handler attached
+// with attachInterruptArg(). FreeRTOS tasks run on host threads.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+
+#define SIM_CS_PIN 5
+#define SIM_INT_PIN 4
+
+extern std::atomic<long> sim_spi_bytes;         // bytes clocked since sim_reset_counters()
+extern std::atomic<long> sim_spi_transactions;  // CS low cycles since sim_reset_counters()
+extern std::atomic<long> sim_chip_lost;         // frames dropped by the chip itself
+extern int sim_failures;
+
+// Called with TXBnSIDH..TXBnD7 (13 bytes) of each frame the chip sends
+extern void (*sim_transmitted)(const uint8_t *sidh);
+
+void sim_reset_counters(void);
+// A standard frame with a 4-byte sequence number arrives from the bus
+void sim_receive(uint32_t id, uint32_t seq);
+// A frame arrives in RXB0 as raw SIDH..DLC registers and data
+void sim_receive_raw(const uint8_t hdr[5], const uint8_t *data, bool rtr);
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        sim_failures++; \
+    } \
+} while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+    long a_ = (long)(actual), e_ = (long)(expected); \
+    if (a_ != e_) { \
+        fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__, #actual, a_, e_); \
+        sim_failures++; \
+    } \
+} while (0)
+
+#endif /* MCP2515_SIM_H_ */
@@ -0,0 +1,166 @@
+// CANRing on its own, then the INT-driven receive path against a simulated
+// bus that outruns a consumer polling every 10 ms.
+
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+
+#include "can_ring.h"
+#include "mcp2515.h"
+#include "mcp2515_sim.h"
+
+static struct can_frame frame(uint32_t seq)
+{
+    struct can_frame f = {};
+    f.can_id = 0x100;
+    f.can_dlc = 4;
+    memcpy(f.data, &seq, 4);
+    return f;
+}
+
+static uint32_t sequence(const struct can_frame *f)
+{
+    uint32_t seq;
+    memcpy(&seq, f->data, 4);
+    return seq;
+}
+
+static void testRing(void)
+{
+    CANRing ring(5);
+    CHECK_EQ(ring.capacity(), 8);
+
+    // Fill, overflow once, then drain in order
+    for (uint32_t i = 0; i < 8; i++) {
+        struct can_frame f = frame(i);
+        CHECK(ring.push(&f));
+    }
+    struct can_frame f = frame(8);
+    CHECK(!ring.push(&f));
+    CHECK_EQ(ring.getOverflows(), 1);
+    CHECK_EQ(ring.size(), 8);
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(ring.pop(&f));
+        CHECK_EQ(sequence(&f), i);
+    }
+    CHECK(!ring.pop(&f));
+    CHECK_EQ(ring.size(), 0);
+
+    // Indices keep running past the capacity
+    for (uint32_t i = 0; i < 100; i++) {
+        struct can_frame g = frame(i);
+        CHECK(ring.push(&g));
+        CHECK(ring.pop(&f));
+        CHECK_EQ(sequence(&f), i);
+    }
+}
+
+// One producer and one consumer thread; every frame arrives once, in order
+static void testRingThreads(void)
+{
+    const uint32_t total = 200000;
+    CANRing ring(16);
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total; ) {
+            struct can_frame f = frame(i);
+            if (ring.push(&f)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t expect = 0, bad = 0;
+    while (expect < total) {
+        struct can_frame f;
+        if (ring.pop(&f)) {
+            if (sequence(&f) != expect) {
+                bad++;
+            }
+            expect++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(ring.size(), 0);
+}
+
+// Frames arrive every gapUs microseconds; the application reads every 10 ms.
+// Returns the frames read.
+static long receive(bool irq, int total, int gapUs)
+{
+    MCP2515 mcp(SIM_CS_PIN);
+    CHECK_EQ(mcp.reset(), MCP2515::ERROR_OK);
+    CHECK_EQ(mcp.setNormalMode(), MCP2515::ERROR_OK);
+    sim_reset_counters();
+    if (irq) {
+        CHECK_EQ(mcp.beginRxInterrupt(SIM_INT_PIN, 64), MCP2515::ERROR_OK);
+    }
+
+    std::atomic<bool> done{false};
+    std::thread bus([&] {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < total; i++) {
+            while (std::chrono::steady_clock::now() < start + std::chrono::microseconds(i * gapUs)) {
+                std::this_thread::yield();
+            }
+            sim_receive(0x100, i);
+        }
+        done = true;
+    });
+
+    long got = 0, bad = 0;
+    uint32_t expect = 0;
+    while (1) {
+        bool last = done;
+        struct can_frame f;
+        while (mcp.readMessage(&f) == MCP2515::ERROR_OK) {
+            if (f.can_id != 0x100 || f.can_dlc != 4 || sequence(&f) < expect) {
+                bad++;
+            }
+            expect = sequence(&f) + 1;
+            got++;
+        }
+        if (last && (!irq || mcp.availableMessages() == 0)) {
+            // Give the receive task time to drain what is left in the chip
+            usleep(20000);
+            if (!irq || mcp.availableMessages() == 0) {
+                break;
+            }
+        }
+        usleep(10000);
+    }
+    bus.join();
+    CHECK_EQ(bad, 0);
+
+    long ringLost = irq ? mcp.getRxRingOverflows() : 0;
+    printf("  %-9s %ld of %d frames, lost %ld in the chip and %ld in the ring, %.1f SPI bytes per frame\n",
+           irq ? "interrupt" : "polling", got, total, (long)sim_chip_lost, ringLost,
+           got ? (double)sim_spi_bytes / got : 0.0);
+    // Every frame is either read or counted as lost
+    CHECK_EQ(got + sim_chip_lost + ringLost, total);
+    if (irq) {
+        mcp.endRxInterrupt();
+        CHECK_EQ(mcp.availableMessages(), 0);
+    }
+    return got;
+}
+
+int main(void)
+{
+    testRing();
+    testRingThreads();
+
+    // 2000 frames/s for half a second
+    long polled = receive(false, 1000, 500);
+    long irq = receive(true, 1000, 500);
+    CHECK(irq > polled);
+
+    if (sim_failures) {
+        return 1;
+    }
+    printf("test_ring: ok\n");
+    return 0;
+}
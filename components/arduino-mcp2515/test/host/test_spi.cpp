@@ -0,0 +1,99 @@
+// SPI transactions (CS low cycles) and bytes per frame moved, with every
+// frame sent looped back through RXB0 and compared.
+
+#include "mcp2515.h"
+#include "mcp2515_sim.h"
+
+static uint8_t sent[13];
+
+static void testSend(MCP2515 &mcp)
+{
+    sim_transmitted = [](const uint8_t *sidh) { memcpy(sent, sidh, 13); };
+    for (int i = 0; i < 4000; i++) {
+        struct can_frame f = {}, g = {};
+        bool ext = i & 1, rtr = (i & 6) == 6;
+        f.can_id = ext ? (((i * 2654435761u) & CAN_EFF_MASK) | CAN_EFF_FLAG) : ((i * 7) & CAN_SFF_MASK);
+        if (rtr) {
+            f.can_id |= CAN_RTR_FLAG;
+        }
+        f.can_dlc = i % 9;
+        for (int k = 0; k < f.can_dlc; k++) {
+            f.data[k] = i + k;
+        }
+
+        // READ STATUS, LOAD TX BUFFER with the header and data, RTS
+        sim_reset_counters();
+        CHECK_EQ(mcp.sendMessage(&f), MCP2515::ERROR_OK);
+        CHECK_EQ(sim_spi_transactions, 3);
+        CHECK_EQ(sim_spi_bytes, 2 + (1 + 5 + f.can_dlc) + 1);
+
+        // The same frame as it arrives from the bus
+        uint8_t hdr[5];
+        memcpy(hdr, sent, 5);
+        if (!ext && rtr) {
+            hdr[1] |= 0x10;     // SRR
+        }
+        hdr[4] &= ext ? 0x4F : 0x0F;
+        sim_receive_raw(hdr, sent + 5, rtr);
+
+        // READ STATUS, READ RX BUFFER with the header and data
+        sim_reset_counters();
+        CHECK_EQ(mcp.readMessage(&g), MCP2515::ERROR_OK);
+        CHECK_EQ(sim_spi_transactions, 2);
+        CHECK_EQ(sim_spi_bytes, 2 + (1 + 5 + f.can_dlc));
+        CHECK_EQ(g.can_id, f.can_id);
+        CHECK_EQ(g.can_dlc, f.can_dlc);
+        CHECK(memcmp(g.data, f.data, f.can_dlc) == 0);
+    }
+}
+
+static void testBuffers(MCP2515 &mcp)
+{
+    // A chosen TX buffer needs no READ STATUS
+    struct can_frame f = {};
+    f.can_id = 0x123;
+    f.can_dlc = 8;
+    sim_reset_counters();
+    CHECK_EQ(mcp.sendMessage(MCP2515::TXB2, &f), MCP2515::ERROR_OK);
+    CHECK_EQ(sim_spi_transactions, 2);
+    CHECK_EQ(sim_spi_bytes, (1 + 5 + 8) + 1);
+
+    // Two frames roll over into RXB1; each buffer is one transaction
+    sim_receive(0x100, 1);
+    sim_receive(0x100, 2);
+    uint32_t seq;
+    sim_reset_counters();
+    CHECK_EQ(mcp.readMessage(MCP2515::RXB1, &f), MCP2515::ERROR_OK);
+    CHECK_EQ(sim_spi_transactions, 1);
+    CHECK_EQ(sim_spi_bytes, 1 + 5 + 4);
+    memcpy(&seq, f.data, 4);
+    CHECK_EQ(seq, 2);
+    sim_reset_counters();
+    CHECK_EQ(mcp.readMessage(MCP2515::RXB0, &f), MCP2515::ERROR_OK);
+    CHECK_EQ(sim_spi_transactions, 1);
+    CHECK_EQ(sim_spi_bytes, 1 + 5 + 4);
+    memcpy(&seq, f.data, 4);
+    CHECK_EQ(seq, 1);
+
+    // Reading cleared RXnIF, so there is nothing left
+    sim_reset_counters();
+    CHECK_EQ(mcp.readMessage(&f), MCP2515::ERROR_NOMSG);
+    CHECK_EQ(sim_spi_transactions, 1);
+    CHECK_EQ(sim_spi_bytes, 2);
+}
+
+int main(void)
+{
+    MCP2515 mcp(SIM_CS_PIN);
+    CHECK_EQ(mcp.reset(), MCP2515::ERROR_OK);
+    CHECK_EQ(mcp.setNormalMode(), MCP2515::ERROR_OK);
+
+    testSend(mcp);
+    testBuffers(mcp);
+
+    if (sim_failures) {
+        return 1;
+    }
+    printf("test_spi: ok\n");
+    return 0;
+}
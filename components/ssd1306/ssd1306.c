@@ -1,33 +1,100 @@
+#include <stdlib.h>
 #include <string.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "ssd1306.h"
 #include "font8x8_basic.h"
 
-#define PACK8 __attribute__((aligned( __alignof__( uint8_t ) ), packed ))
+#define TAG "SSD1306"
 
-typedef union out_column_t {
-	uint32_t u32;
-	uint8_t  u8[4];
-} PACK8 out_column_t;
+// A new device has nothing allocated by the driver yet. The transports call this
+// before they set the device up, so SSD1306_t may start out with any contents.
+void ssd1306_reset_state(SSD1306_t * dev)
+{
+	dev->_page = NULL;
+	dev->_own_page = false;
+	dev->_pages = 0;
+	dev->_horizontal = false;
+	dev->_shadow = NULL;
+	dev->_flush_page = NULL;
+	dev->_flush_task = NULL;
+	dev->_flush_event = NULL;
+	dev->_flush_failed = false;
+	dev->_console = NULL;
+	dev->_effect = NULL;
+}
+
+// Stop the optional features, which are allocated on first use
+static void ssd1306_features_deinit(SSD1306_t * dev)
+{
+	ssd1306_effect_deinit(dev);
+	ssd1306_async_deinit(dev);
+	free(dev->_console);
+	dev->_console = NULL;
+	free(dev->_shadow);
+	dev->_shadow = NULL;
+}
 
-void ssd1306_init(SSD1306_t * dev, int width, int height)
+// The frame buffer holds exactly one PAGE_t per 8 lines and is allocated here.
+// Calling it again, after a panel reset for example, reuses the buffer if the page count is the same.
+// The buffer is freed by ssd1306_deinit(), which must be called before the SSD1306_t goes away.
+// Returns false if it could not be allocated: the panel is set up, but there are no pages to draw to.
+bool ssd1306_init(SSD1306_t * dev, int width, int height)
 {
+	int pages = (height == 32) ? 4 : 8;
+	PAGE_t * page;
+	if (dev->_own_page && dev->_pages == pages) {
+		page = dev->_page;
+	} else {
+		page = malloc(sizeof(PAGE_t) * pages);
+		if (page == NULL) ESP_LOGE(TAG, "page allocation fail");
+	}
+	ssd1306_init_pages(dev, width, height, page);
+	dev->_own_page = (page != NULL);
+	return page != NULL;
+}
+
+// Same as ssd1306_init(), with a caller-owned frame buffer of height / 8 pages.
+// Initializing again stops the optional features and frees a buffer ssd1306_init() allocated.
+void ssd1306_init_pages(SSD1306_t * dev, int width, int height, PAGE_t * page)
+{
+	ssd1306_features_deinit(dev);
+	if (dev->_own_page && dev->_page != page) free(dev->_page);
 	if (dev->_address == SPI_ADDRESS) {
 		spi_init(dev, width, height);
 	} else {
 		i2c_init(dev, width, height);
 	}
 	// Initialize internal buffer
+	dev->_page = page;
+	dev->_own_page = false;
+	if (page == NULL) dev->_pages = 0;
 	for (int i=0;i<dev->_pages;i++) {
 		memset(dev->_page[i]._segs, 0, 128);
 	}
 }
 
+// Stop the optional features and free what the driver allocated, the transfer buffer included:
+// start again from i2c_master_init() / spi_master_init(). The panel is left as it is.
+void ssd1306_deinit(SSD1306_t * dev)
+{
+	ssd1306_features_deinit(dev);
+	if (dev->_own_page) free(dev->_page);
+	dev->_page = NULL;
+	dev->_own_page = false;
+	dev->_pages = 0;
+	if (dev->_address == SPI_ADDRESS) {
+		spi_deinit(dev);
+	} else {
+		i2c_deinit(dev);
+	}
+}
+
 int ssd1306_get_width(SSD1306_t * dev)
 {
 	return dev->_width;
@@ -43,19 +110,400 @@ int ssd1306_get_pages(SSD1306_t * dev)
 	return dev->_pages;
 }
 
+// The shadow is what ssd1306_show_buffer_diff() believes is on the panel.
+// Every page write records what it sent. A failed write, or one that does not
+// map RAM pages to _page[] one to one (console ring, hardware scroll), drops
+// the shadow instead, and the next diff sends a full frame.
+static void ssd1306_shadow_drop(SSD1306_t * dev)
+{
+	free(dev->_shadow);
+	dev->_shadow = NULL;
+}
+
+static void ssd1306_shadow_sent(SSD1306_t * dev, int page, int seg, const uint8_t * segs, int width, int sent)
+{
+	if (dev->_shadow == NULL) return;
+	if (sent == 0) {
+		ssd1306_shadow_drop(dev);
+		return;
+	}
+	memcpy(&dev->_shadow[page]._segs[seg], segs, width);
+}
+
 void ssd1306_show_buffer(SSD1306_t * dev)
 {
+	int sent;
 	if (dev->_address == SPI_ADDRESS) {
-		for (int page=0; page<dev->_pages;page++) {
-			spi_display_image(dev, page, 0, dev->_page[page]._segs, dev->_width);
-		}
+		sent = spi_display_frame(dev, dev->_page);
+	} else {
+		sent = i2c_display_frame(dev, dev->_page);
+	}
+	if (dev->_shadow == NULL) return;
+	if (sent == 0) {
+		ssd1306_shadow_drop(dev);
+		return;
+	}
+	memcpy(dev->_shadow, dev->_page, sizeof(PAGE_t) * dev->_pages);
+}
+
+static inline uint32_t load32(const uint8_t * p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Send a run of columns that is already in _page[] and record it in the shadow.
+static void ssd1306_send_run(SSD1306_t * dev, int page, int seg, int width)
+{
+	const uint8_t * segs = &dev->_page[page]._segs[seg];
+	int sent;
+	if (dev->_address == SPI_ADDRESS) {
+		sent = spi_display_image(dev, page, seg, segs, width);
 	} else {
-		for (int page=0; page<dev->_pages;page++) {
-			i2c_display_image(dev, page, 0, dev->_page[page]._segs, dev->_width);
+		sent = i2c_display_image(dev, page, seg, segs, width);
+	}
+	ssd1306_shadow_sent(dev, page, seg, segs, width, sent);
+}
+
+// Send only the columns that differ from what the panel shows.
+// The first call, and the first after the shadow was dropped, allocates the shadow copy and sends everything.
+// Returns the number of data bytes sent.
+int ssd1306_show_buffer_diff(SSD1306_t * dev)
+{
+	if (dev->_flush_task) {
+		ssd1306_wait_flush(dev, portMAX_DELAY);
+		if (dev->_flush_failed) {
+			dev->_flush_failed = false;
+			ssd1306_shadow_drop(dev);
+		}
+	}
+	if (dev->_shadow == NULL) {
+		dev->_shadow = malloc(sizeof(PAGE_t) * dev->_pages);
+		if (dev->_shadow == NULL) ESP_LOGE(TAG, "shadow allocation fail");
+		ssd1306_show_buffer(dev);
+		return dev->_width * dev->_pages;
+	}
+
+	// Unchanged bytes up to the cost of opening another window are sent with the runs around them
+	int merge_gap = (dev->_address == SPI_ADDRESS) ? SPI_WINDOW_COST : I2C_WINDOW_COST;
+	int sent = 0;
+	for (int page=0; page<dev->_pages; page++) {
+		const uint8_t * cur = dev->_page[page]._segs;
+		const uint8_t * old = dev->_shadow[page]._segs;
+		int run_start = -1;
+		int run_end = -1;
+		for (int seg=0; seg<dev->_width; seg+=4) {
+			// A width that is not a multiple of 4 ends with a partial word
+			int last = seg + 3;
+			if (last >= dev->_width) {
+				last = dev->_width - 1;
+			} else if (load32(&cur[seg]) == load32(&old[seg])) {
+				continue;
+			}
+			// Narrow the changed word down to bytes
+			int first = seg;
+			while (first <= last && cur[first] == old[first]) first++;
+			if (first > last) continue;
+			while (cur[last] == old[last]) last--;
+			if (run_start >= 0 && first - run_end - 1 <= merge_gap) {
+				run_end = last;
+				continue;
+			}
+			if (run_start >= 0) {
+				int width = run_end - run_start + 1;
+				ssd1306_send_run(dev, page, run_start, width);
+				sent = sent + width;
+			}
+			run_start = first;
+			run_end = last;
+		}
+		if (run_start >= 0) {
+			int width = run_end - run_start + 1;
+			ssd1306_send_run(dev, page, run_start, width);
+			sent = sent + width;
+		}
+	}
+	return sent;
+}
+
+#define FLUSH_DONE_BIT (1 << 0)
+#define FLUSH_TASK_STACK 2048
+
+static void ssd1306_flush_task(void * arg)
+{
+	SSD1306_t * dev = (SSD1306_t *)arg;
+	while(1) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		int sent;
+		if (dev->_address == SPI_ADDRESS) {
+			sent = spi_display_frame(dev, dev->_flush_page);
+		} else {
+			sent = i2c_display_frame(dev, dev->_flush_page);
 		}
+		dev->_flush_failed = (sent == 0);
+		if (dev->_flush_cb) (*dev->_flush_cb)(dev, dev->_flush_arg);
+		xEventGroupSetBits(dev->_flush_event, FLUSH_DONE_BIT);
 	}
 }
 
+// Start a flush task that sends a back buffer while the caller keeps drawing into _page[].
+// The task runs at the caller's priority. callback may be NULL.
+// If the task is already running, only the callback is replaced, once no flush is in progress.
+bool ssd1306_async_init(SSD1306_t * dev, ssd1306_flush_cb_t callback, void * arg)
+{
+	if (dev->_flush_task) {
+		ssd1306_wait_flush(dev, portMAX_DELAY);
+		dev->_flush_cb = callback;
+		dev->_flush_arg = arg;
+		return true;
+	}
+	dev->_flush_cb = callback;
+	dev->_flush_arg = arg;
+	dev->_flush_failed = false;
+	dev->_flush_page = malloc(sizeof(PAGE_t) * dev->_pages);
+	dev->_flush_event = xEventGroupCreate();
+	if (dev->_flush_page == NULL || dev->_flush_event == NULL) {
+		ESP_LOGE(TAG, "async flush allocation fail");
+		ssd1306_async_deinit(dev);
+		return false;
+	}
+	xEventGroupSetBits(dev->_flush_event, FLUSH_DONE_BIT);
+	if (xTaskCreate(ssd1306_flush_task, "ssd1306_flush", FLUSH_TASK_STACK, dev, uxTaskPriorityGet(NULL), &dev->_flush_task) != pdPASS) {
+		ESP_LOGE(TAG, "async flush task create fail");
+		ssd1306_async_deinit(dev);
+		return false;
+	}
+	return true;
+}
+
+void ssd1306_async_deinit(SSD1306_t * dev)
+{
+	if (dev->_flush_task) {
+		ssd1306_wait_flush(dev, portMAX_DELAY);
+		vTaskDelete(dev->_flush_task);
+		dev->_flush_task = NULL;
+	}
+	if (dev->_flush_event) {
+		vEventGroupDelete(dev->_flush_event);
+		dev->_flush_event = NULL;
+	}
+	free(dev->_flush_page);
+	dev->_flush_page = NULL;
+}
+
+// Snapshot _page[] and hand it to the flush task. Only waits if the previous flush is still running.
+// Do not call other functions that write to the panel until ssd1306_wait_flush() returns true.
+void ssd1306_show_buffer_async(SSD1306_t * dev)
+{
+	if (dev->_flush_task == NULL) {
+		ssd1306_show_buffer(dev);
+		return;
+	}
+	xEventGroupWaitBits(dev->_flush_event, FLUSH_DONE_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+	memcpy(dev->_flush_page, dev->_page, sizeof(PAGE_t) * dev->_pages);
+	// The shadow takes the frame now; ssd1306_show_buffer_diff() waits for
+	// the flush and drops it if the frame did not get to the panel
+	if (dev->_shadow) memcpy(dev->_shadow, dev->_page, sizeof(PAGE_t) * dev->_pages);
+	xTaskNotifyGive(dev->_flush_task);
+}
+
+// Returns true once no flush is in progress, false on timeout.
+bool ssd1306_wait_flush(SSD1306_t * dev, TickType_t ticks_to_wait)
+{
+	if (dev->_flush_event == NULL) return true;
+	EventBits_t bits = xEventGroupWaitBits(dev->_flush_event, FLUSH_DONE_BIT, pdFALSE, pdTRUE, ticks_to_wait);
+	return (bits & FLUSH_DONE_BIT) != 0;
+}
+
+// Display manager: one task owns every panel on a bus and sends one page at a time,
+// so a full frame for one panel never holds up another. The caller draws into
+// dev->_page[] and commits; pages that changed since the last commit are marked
+// dirty, and a page committed again before it went out is sent once, with the
+// latest content. Panels flagged with ssd1306_manager_alarm() are served first,
+// the others round-robin. A page write that fails is counted and sent again.
+// Do not call other functions that write to a managed panel.
+#define MANAGER_TASK_STACK 3072
+
+// Find the next panel with dirty pages: alarm panels first, then the rest, both round-robin
+static int ssd1306_manager_pick(MANAGER_t * mgr)
+{
+	for (int pass=0; pass<2; pass++) {
+		for (int i=0; i<mgr->_count; i++) {
+			int index = (mgr->_next + i) % mgr->_count;
+			MANAGER_PANEL_t * panel = &mgr->_panel[index];
+			if (panel->_dirty == 0) continue;
+			if (pass == 0 && !panel->_alarm) continue;
+			return index;
+		}
+	}
+	return -1;
+}
+
+static void ssd1306_manager_task(void * arg)
+{
+	MANAGER_t * mgr = (MANAGER_t *)arg;
+	uint8_t segs[128];
+	while(1) {
+		// Copy the page out, so commits never wait for the bus
+		xSemaphoreTake(mgr->_lock, portMAX_DELAY);
+		int index = ssd1306_manager_pick(mgr);
+		if (index < 0) {
+			xSemaphoreGive(mgr->_lock);
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			continue;
+		}
+		MANAGER_PANEL_t * panel = &mgr->_panel[index];
+		SSD1306_t * dev = panel->_dev;
+		// Pages go out in order from where the last one left off, so a panel
+		// committed faster than the bus still gets every page
+		int page = panel->_cursor;
+		while ((panel->_dirty & (1 << page)) == 0) page = (page + 1) % dev->_pages;
+		panel->_dirty &= ~(1 << page);
+		panel->_cursor = (page + 1) % dev->_pages;
+		memcpy(segs, panel->_staged[page]._segs, dev->_width);
+		mgr->_next = (index + 1) % mgr->_count;
+		xSemaphoreGive(mgr->_lock);
+
+		xSemaphoreTake(mgr->_bus, portMAX_DELAY);
+		int64_t start = esp_timer_get_time();
+		int sent;
+		if (dev->_address == SPI_ADDRESS) {
+			sent = spi_display_image(dev, page, 0, segs, dev->_width);
+		} else {
+			sent = i2c_display_image(dev, page, 0, segs, dev->_width);
+		}
+		int64_t busy = esp_timer_get_time() - start;
+		ssd1306_shadow_sent(dev, page, 0, segs, dev->_width, sent);
+		xSemaphoreGive(mgr->_bus);
+
+		xSemaphoreTake(mgr->_lock, portMAX_DELAY);
+		panel->_busy_us += busy;
+		panel->_bytes += sent;
+		if (sent == 0) {
+			// Retried on the panel's next turn, unless a newer commit already marked it
+			panel->_errors++;
+			panel->_dirty |= (1 << page);
+		} else if (panel->_dirty == 0) {
+			panel->_frames++;
+		}
+		xSemaphoreGive(mgr->_lock);
+		// Do not spin on a bus that keeps failing
+		if (sent == 0) vTaskDelay(1);
+	}
+}
+
+bool ssd1306_manager_init(MANAGER_t * mgr)
+{
+	memset(mgr, 0, sizeof(MANAGER_t));
+	mgr->_lock = xSemaphoreCreateMutex();
+	mgr->_bus = xSemaphoreCreateMutex();
+	if (mgr->_lock == NULL || mgr->_bus == NULL) {
+		ESP_LOGE(TAG, "manager allocation fail");
+		ssd1306_manager_deinit(mgr);
+		return false;
+	}
+	if (xTaskCreate(ssd1306_manager_task, "ssd1306_manager", MANAGER_TASK_STACK, mgr, uxTaskPriorityGet(NULL), &mgr->_task) != pdPASS) {
+		ESP_LOGE(TAG, "manager task create fail");
+		mgr->_task = NULL;
+		ssd1306_manager_deinit(mgr);
+		return false;
+	}
+	return true;
+}
+
+void ssd1306_manager_deinit(MANAGER_t * mgr)
+{
+	if (mgr->_task) {
+		// Never stop the task in the middle of a page
+		xSemaphoreTake(mgr->_bus, portMAX_DELAY);
+		vTaskDelete(mgr->_task);
+		mgr->_task = NULL;
+		xSemaphoreGive(mgr->_bus);
+	}
+	if (mgr->_lock) {
+		vSemaphoreDelete(mgr->_lock);
+		mgr->_lock = NULL;
+	}
+	if (mgr->_bus) {
+		vSemaphoreDelete(mgr->_bus);
+		mgr->_bus = NULL;
+	}
+	mgr->_count = 0;
+}
+
+// Add an initialized panel. Its current buffer goes out in full as the first frame.
+// Returns the panel index, or -1 if the manager is full.
+int ssd1306_manager_add(MANAGER_t * mgr, SSD1306_t * dev)
+{
+	xSemaphoreTake(mgr->_lock, portMAX_DELAY);
+	int index = mgr->_count;
+	if (index >= MANAGER_MAX_PANELS) {
+		xSemaphoreGive(mgr->_lock);
+		ESP_LOGE(TAG, "manager is full");
+		return -1;
+	}
+	MANAGER_PANEL_t * panel = &mgr->_panel[index];
+	memset(panel, 0, sizeof(MANAGER_PANEL_t));
+	panel->_dev = dev;
+	memcpy(panel->_staged, dev->_page, sizeof(PAGE_t) * dev->_pages);
+	panel->_dirty = (1 << dev->_pages) - 1;
+	panel->_commits = 1;
+	panel->_since_us = esp_timer_get_time();
+	mgr->_count++;
+	xSemaphoreGive(mgr->_lock);
+	xTaskNotifyGive(mgr->_task);
+	return index;
+}
+
+// Queue the panel's buffer. Returns as soon as the changed pages are copied.
+void ssd1306_manager_commit(MANAGER_t * mgr, int index)
+{
+	MANAGER_PANEL_t * panel = &mgr->_panel[index];
+	SSD1306_t * dev = panel->_dev;
+	xSemaphoreTake(mgr->_lock, portMAX_DELAY);
+	uint8_t dirty = 0;
+	for (int page=0; page<dev->_pages; page++) {
+		if (memcmp(panel->_staged[page]._segs, dev->_page[page]._segs, dev->_width) == 0) continue;
+		memcpy(panel->_staged[page]._segs, dev->_page[page]._segs, dev->_width);
+		dirty |= (1 << page);
+	}
+	panel->_dirty |= dirty;
+	if (dirty) panel->_commits++;
+	xSemaphoreGive(mgr->_lock);
+	if (dirty) xTaskNotifyGive(mgr->_task);
+}
+
+void ssd1306_manager_alarm(MANAGER_t * mgr, int index, bool alarm)
+{
+	xSemaphoreTake(mgr->_lock, portMAX_DELAY);
+	mgr->_panel[index]._alarm = alarm;
+	xSemaphoreGive(mgr->_lock);
+}
+
+// Report the panel's stats since the previous call and start a new interval.
+void ssd1306_manager_stats(MANAGER_t * mgr, int index, ssd1306_manager_stats_t * stats)
+{
+	MANAGER_PANEL_t * panel = &mgr->_panel[index];
+	xSemaphoreTake(mgr->_lock, portMAX_DELAY);
+	int64_t now = esp_timer_get_time();
+	int64_t elapsed = now - panel->_since_us;
+	if (elapsed < 1) elapsed = 1;
+	stats->fps = panel->_frames * 1000000.0f / elapsed;
+	stats->bus_load = (float)panel->_busy_us / elapsed;
+	stats->commits = panel->_commits;
+	stats->frames = panel->_frames;
+	stats->bytes = panel->_bytes;
+	stats->errors = panel->_errors;
+	panel->_commits = 0;
+	panel->_frames = 0;
+	panel->_bytes = 0;
+	panel->_errors = 0;
+	panel->_busy_us = 0;
+	panel->_since_us = now;
+	xSemaphoreGive(mgr->_lock);
+}
+
 void ssd1306_set_buffer(SSD1306_t * dev, const uint8_t * buffer)
 {
 	int index = 0;
@@ -76,23 +524,28 @@ void ssd1306_get_buffer(SSD1306_t * dev, uint8_t * buffer)
 
 void ssd1306_set_page(SSD1306_t * dev, int page, const uint8_t * buffer)
 {
+	if (page < 0 || page >= dev->_pages) return;
 	memcpy(&dev->_page[page]._segs, buffer, 128);
 }
 
 void ssd1306_get_page(SSD1306_t * dev, int page, uint8_t * buffer)
 {
+	if (page < 0 || page >= dev->_pages) return;
 	memcpy(buffer, &dev->_page[page]._segs, 128);
 }
 
 void ssd1306_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width)
 {
+	if (page < 0 || page >= dev->_pages) return;
+	int sent;
 	if (dev->_address == SPI_ADDRESS) {
-		spi_display_image(dev, page, seg, images, width);
+		sent = spi_display_image(dev, page, seg, images, width);
 	} else {
-		i2c_display_image(dev, page, seg, images, width);
+		sent = i2c_display_image(dev, page, seg, images, width);
 	}
-	// Set to internal buffer
-	memcpy(&dev->_page[page]._segs[seg], images, width);
+	// Set to internal buffer, unless the caller drew there and passed it back
+	if (images != &dev->_page[page]._segs[seg]) memcpy(&dev->_page[page]._segs[seg], images, width);
+	ssd1306_shadow_sent(dev, page, seg, images, width, sent);
 }
 
 void ssd1306_display_text(SSD1306_t * dev, int page, const char * text, int text_len, bool invert)
@@ -199,60 +652,79 @@ void ssd1306_display_text_box2(SSD1306_t * dev, int page, int seg, const char *
 	}
 }
 
-// by Coert Vonk
-void 
-ssd1306_display_text_x3(SSD1306_t * dev, int page, const char * text, int text_len, bool invert)
+// Nibble to byte stretch tables: every bit becomes 2, 3 or 4 copies of itself
+static const uint8_t stretch_x2[16] = {
+	0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+static const uint16_t stretch_x3[16] = {
+	0x0000, 0x0007, 0x0038, 0x003F, 0x01C0, 0x01C7, 0x01F8, 0x01FF,
+	0x0E00, 0x0E07, 0x0E38, 0x0E3F, 0x0FC0, 0x0FC7, 0x0FF8, 0x0FFF
+};
+static const uint16_t stretch_x4[16] = {
+	0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+	0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF
+};
+
+// Make one 8 pixel high glyph column 'scale' times as high (2 to 4)
+static inline uint32_t ssd1306_stretch_column(uint8_t column, int scale)
+{
+	switch (scale) {
+	case 2:
+		return stretch_x2[column & 0x0F] | ((uint32_t)stretch_x2[column >> 4] << 8);
+	case 3:
+		return stretch_x3[column & 0x0F] | ((uint32_t)stretch_x3[column >> 4] << 12);
+	default:
+		return stretch_x4[column & 0x0F] | ((uint32_t)stretch_x4[column >> 4] << 16);
+	}
+}
+
+// Text 'scale' times as wide and high (2 to 4), over 'scale' pages starting at page.
+// Each page goes out as one image for the whole line.
+static void ssd1306_display_text_scaled(SSD1306_t * dev, int page, const char * text, int text_len, bool invert, int scale)
 {
 	if (page >= dev->_pages) return;
 	int _text_len = text_len;
-	if (_text_len > 5) _text_len = 5;
-
-	int seg = 0;
+	if (_text_len > 16 / scale) _text_len = 16 / scale;
+	if (_text_len <= 0) return;
+	int width = _text_len * 8 * scale;
 
+	uint32_t columns[64]; // Up to 8 characters of 8 columns
 	for (int nn = 0; nn < _text_len; nn++) {
-
 		uint8_t const * const in_columns = font8x8_basic_tr[(uint8_t)text[nn]];
-
-		// make the character 3x as high
-		out_column_t out_columns[8];
-		memset(out_columns, 0, sizeof(out_columns));
-
-		for (int xx = 0; xx < 8; xx++) { // for each column (x-direction)
-
-			uint32_t in_bitmask = 0b1;
-			uint32_t out_bitmask = 0b111;
-
-			for (int yy = 0; yy < 8; yy++) { // for pixel (y-direction)
-				if (in_columns[xx] & in_bitmask) {
-					out_columns[xx].u32 |= out_bitmask;
-				}
-				in_bitmask <<= 1;
-				out_bitmask <<= 3;
-			}
+		for (int xx = 0; xx < 8; xx++) {
+			columns[nn*8+xx] = ssd1306_stretch_column(in_columns[xx], scale);
 		}
+	}
 
-		// render character in 8 column high pieces, making them 3x as wide
-		for (int yy = 0; yy < 3; yy++)	{ // for each group of 8 pixels high (y-direction)
-
-			uint8_t image[24];
-			for (int xx = 0; xx < 8; xx++) { // for each column (x-direction)
-				image[xx*3+0] = 
-				image[xx*3+1] = 
-				image[xx*3+2] = out_columns[xx].u8[yy];
-			}
-			if (invert) ssd1306_invert(image, 24);
-			if (dev->_flip) ssd1306_flip(image, 24);
-			if (dev->_address == SPI_ADDRESS) {
-				spi_display_image(dev, page+yy, seg, image, 24);
-			} else {
-				i2c_display_image(dev, page+yy, seg, image, 24);
-			}
-			memcpy(&dev->_page[page+yy]._segs[seg], image, 24);
+	uint8_t image[128];
+	for (int yy = 0; yy < scale && page+yy < dev->_pages; yy++) {
+		// Each column is also repeated 'scale' times to make it as wide
+		for (int xx = 0; xx < _text_len * 8; xx++) {
+			memset(&image[xx*scale], (uint8_t)(columns[xx] >> (yy*8)), scale);
 		}
-		seg = seg + 24;
+		if (invert) ssd1306_invert(image, width);
+		if (dev->_flip) ssd1306_flip(image, width);
+		ssd1306_display_image(dev, page+yy, 0, image, width);
 	}
 }
 
+void ssd1306_display_text_x2(SSD1306_t * dev, int page, const char * text, int text_len, bool invert)
+{
+	ssd1306_display_text_scaled(dev, page, text, text_len, invert, 2);
+}
+
+// by Coert Vonk
+void 
+ssd1306_display_text_x3(SSD1306_t * dev, int page, const char * text, int text_len, bool invert)
+{
+	ssd1306_display_text_scaled(dev, page, text, text_len, invert, 3);
+}
+
+void ssd1306_display_text_x4(SSD1306_t * dev, int page, const char * text, int text_len, bool invert)
+{
+	ssd1306_display_text_scaled(dev, page, text, text_len, invert, 4);
+}
+
 void ssd1306_clear_screen(SSD1306_t * dev, bool invert)
 {
 	char space[16];
@@ -300,7 +772,7 @@ void ssd1306_scroll_text(SSD1306_t * dev, const char * text, int text_len, bool
 	ESP_LOGD(__FUNCTION__, "dev->_scEnable=%d", dev->_scEnable);
 	if (dev->_scEnable == false) return;
 
-	void (*func)(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
+	int (*func)(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
 	if (dev->_address == SPI_ADDRESS) {
 		func = spi_display_image;
 	} else {
@@ -314,7 +786,8 @@ void ssd1306_scroll_text(SSD1306_t * dev, const char * text, int text_len, bool
 		for(int seg = 0; seg < dev->_width; seg++) {
 			dev->_page[dstIndex]._segs[seg] = dev->_page[srcIndex]._segs[seg];
 		}
-		(*func)(dev, dstIndex, 0, dev->_page[dstIndex]._segs, sizeof(dev->_page[dstIndex]._segs));
+		int sent = (*func)(dev, dstIndex, 0, dev->_page[dstIndex]._segs, sizeof(dev->_page[dstIndex]._segs));
+		ssd1306_shadow_sent(dev, dstIndex, 0, dev->_page[dstIndex]._segs, sizeof(dev->_page[dstIndex]._segs), sent);
 		if (srcIndex == dev->_scStart) break;
 		srcIndex = srcIndex - dev->_scDirection;
 	}
@@ -343,6 +816,8 @@ void ssd1306_scroll_clear(SSD1306_t * dev)
 
 void ssd1306_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll)
 {
+	// The controller moves RAM contents itself
+	ssd1306_shadow_drop(dev);
 	if (dev->_address == SPI_ADDRESS) {
 		spi_hardware_scroll(dev, scroll);
 	} else {
@@ -520,17 +995,154 @@ void ssd1306_wrap_arround(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int sta
 
 	if (delay >= 0) {
 		for (int page=0;page<dev->_pages;page++) {
+			int sent;
 			if (dev->_address == SPI_ADDRESS) {
-				spi_display_image(dev, page, 0, dev->_page[page]._segs, 128);
+				sent = spi_display_image(dev, page, 0, dev->_page[page]._segs, 128);
 			} else {
-				i2c_display_image(dev, page, 0, dev->_page[page]._segs, 128);
+				sent = i2c_display_image(dev, page, 0, dev->_page[page]._segs, 128);
 			}
+			ssd1306_shadow_sent(dev, page, 0, dev->_page[page]._segs, 128, sent);
 			if (delay) vTaskDelay(delay);
 		}
 	}
 
 }
 
+// Terminal-style console over the whole panel.
+// The display start line turns the controller's 8 RAM pages into a ring,
+// so a new line costs one page write and one command instead of rewriting every page.
+// _page[] is kept in step (in RAM only) so ssd1306_console_deinit() can restore a normal layout.
+// Other drawing functions do not know about the ring: call ssd1306_console_deinit() before using them.
+#define CONSOLE_RAM_PAGES 8
+
+static void ssd1306_console_send(SSD1306_t * dev, int ram_page, const uint8_t * images, int start_line)
+{
+	if (dev->_address == SPI_ADDRESS) {
+		spi_console_page(dev, ram_page, images, start_line);
+	} else {
+		i2c_console_page(dev, ram_page, images, start_line);
+	}
+}
+
+// RAM page currently shown as text line (page) 'page'
+static int ssd1306_console_ram_page(SSD1306_t * dev, int page)
+{
+	int row = page;
+	if (dev->_flip) row = (dev->_pages - page) - 1;
+	return (dev->_console->_top + row) % CONSOLE_RAM_PAGES;
+}
+
+// Render backlog line 'age' (0 = newest) into segs, blank if there is no such line
+static void ssd1306_console_render(SSD1306_t * dev, int age, uint8_t * segs)
+{
+	CONSOLE_t * con = dev->_console;
+	memset(segs, 0, 128);
+	if (age >= con->_count) return;
+	int slot = (con->_head - age + CONSOLE_BACKLOG) % CONSOLE_BACKLOG;
+	for (int i = 0; i < dev->_width / 8; i++) {
+		if (con->_text[slot][i] == 0) break;
+		memcpy(&segs[i * 8], font8x8_basic_tr[(uint8_t)con->_text[slot][i]], 8);
+		if (con->_invert[slot]) ssd1306_invert(&segs[i * 8], 8);
+	}
+	if (dev->_flip) ssd1306_flip(segs, 128);
+}
+
+static void ssd1306_console_line(SSD1306_t * dev, const char * text, int text_len, bool invert)
+{
+	CONSOLE_t * con = dev->_console;
+	con->_head = (con->_head + 1) % CONSOLE_BACKLOG;
+	if (con->_count < CONSOLE_BACKLOG) con->_count++;
+	memset(con->_text[con->_head], 0, sizeof(con->_text[0]));
+	memcpy(con->_text[con->_head], text, text_len);
+	con->_invert[con->_head] = invert;
+	if (con->_back != 0) {
+		ssd1306_console_redraw(dev, 0);
+		return;
+	}
+
+	// Scroll the ring by one page and write the new bottom line
+	if (dev->_flip) {
+		con->_top = (con->_top + CONSOLE_RAM_PAGES - 1) % CONSOLE_RAM_PAGES;
+	} else {
+		con->_top = (con->_top + 1) % CONSOLE_RAM_PAGES;
+	}
+	int last = dev->_pages - 1;
+	memmove(&dev->_page[0], &dev->_page[1], sizeof(PAGE_t) * last);
+	ssd1306_console_render(dev, 0, dev->_page[last]._segs);
+	ssd1306_console_send(dev, ssd1306_console_ram_page(dev, last), dev->_page[last]._segs, con->_top * 8);
+}
+
+// Start the console on a blank panel. Returns false if the backlog could not be allocated.
+bool ssd1306_console_init(SSD1306_t * dev)
+{
+	if (dev->_pages == 0) return false;
+	if (dev->_console == NULL) {
+		dev->_console = malloc(sizeof(CONSOLE_t));
+		if (dev->_console == NULL) {
+			ESP_LOGE(TAG, "console allocation fail");
+			return false;
+		}
+	}
+	memset(dev->_console, 0, sizeof(CONSOLE_t));
+	dev->_console->_head = CONSOLE_BACKLOG - 1;
+	// RAM pages become a ring: the next diff after ssd1306_console_deinit() sends a full frame
+	ssd1306_shadow_drop(dev);
+	ssd1306_console_redraw(dev, 0);
+	return true;
+}
+
+// Stop the console: reset the start line and rewrite the panel from _page[], which holds the console text.
+void ssd1306_console_deinit(SSD1306_t * dev)
+{
+	if (dev->_console == NULL) return;
+	free(dev->_console);
+	dev->_console = NULL;
+	if (dev->_address == SPI_ADDRESS) {
+		spi_console_page(dev, -1, NULL, 0);
+	} else {
+		i2c_console_page(dev, -1, NULL, 0);
+	}
+	ssd1306_show_buffer(dev);
+}
+
+// Append text at the bottom, scrolling up one line per text line.
+// '\n' starts a new line and long lines wrap at the panel width.
+void ssd1306_console_print(SSD1306_t * dev, const char * text, int text_len, bool invert)
+{
+	if (dev->_console == NULL) return;
+	int cols = dev->_width / 8;
+	int start = 0;
+	for (int i = 0; i < text_len; i++) {
+		if (text[i] == '\n') {
+			ssd1306_console_line(dev, &text[start], i - start, invert);
+			start = i + 1;
+		} else if (i - start == cols) {
+			ssd1306_console_line(dev, &text[start], cols, invert);
+			start = i;
+		}
+	}
+	if (start < text_len || text_len == 0) {
+		ssd1306_console_line(dev, &text[start], text_len - start, invert);
+	}
+}
+
+// Rewrite every line from the backlog, 'back' lines up from the newest (0 = live view).
+// The next ssd1306_console_print() returns to the live view.
+void ssd1306_console_redraw(SSD1306_t * dev, int back)
+{
+	CONSOLE_t * con = dev->_console;
+	if (con == NULL) return;
+	if (back > con->_count - dev->_pages) back = con->_count - dev->_pages;
+	if (back < 0) back = 0;
+	con->_back = back;
+	for (int page = 0; page < dev->_pages; page++) {
+		int start_line = -1;
+		if (page == dev->_pages - 1) start_line = con->_top * 8;
+		ssd1306_console_render(dev, (dev->_pages - 1 - page) + back, dev->_page[page]._segs);
+		ssd1306_console_send(dev, ssd1306_console_ram_page(dev, page), dev->_page[page]._segs, start_line);
+	}
+}
+
 void _ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitmap, int width, int height, bool invert)
 {
 	if ( (width % 8) != 0) {
@@ -549,6 +1161,14 @@ void _ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitma
 	for(int _height=0;_height<height;_height++) {
 		for (int index=0;index<_width;index++) {
 			for (int srcBits=7; srcBits>=0; srcBits--) {
+				if (_seg >= 128) {
+					ESP_LOGW(__FUNCTION__, "segment is out of range");
+					break;
+				}
+				if (page >= dev->_pages) {
+					ESP_LOGW(__FUNCTION__, "page is out of range");
+					break;
+				}
 				wk0 = dev->_page[page]._segs[_seg];
 				if (dev->_flip) wk0 = ssd1306_rotate_byte(wk0);
 
@@ -560,14 +1180,6 @@ void _ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitma
 				if (dev->_flip) wk2 = ssd1306_rotate_byte(wk2);
 
 				ESP_LOGD(__FUNCTION__, "index=%d offset=%d wk1=0x%x page=%d _seg=%d, wk2=%02x", index, offset, wk1, page, _seg, wk2);
-				if (_seg >= 128) {
-					ESP_LOGW(__FUNCTION__, "segment is out of range");
-					break;
-				}
-				if (page >= dev->_pages) {
-					ESP_LOGW(__FUNCTION__, "page is out of range");
-					break;
-				}
 				dev->_page[page]._segs[_seg] = wk2;
 				_seg++;
 			}
@@ -603,6 +1215,8 @@ void ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitmap
 	int end_page = (ypos + height - 1) / 8;
 	int start_seg = xpos;
 	int end_seg = xpos + width - 1;
+	if (end_page >= dev->_pages) end_page = dev->_pages - 1;
+	if (end_seg > 127) end_seg = 127;
 
 	// Update only the modified pages and segments
 	for (int page = start_page; page <= end_page; page++) {
@@ -617,6 +1231,7 @@ void ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitmap
 // Set pixel to internal buffer. Not show it.
 void _ssd1306_pixel(SSD1306_t * dev, int xpos, int ypos, bool invert)
 {
+	if (xpos < 0 || xpos >= dev->_width || ypos < 0 || ypos >= dev->_pages * 8) return;
 	uint8_t _page = (ypos / 8);
 	uint8_t _bits = (ypos % 8);
 	uint8_t _seg = xpos;
@@ -782,72 +1397,351 @@ uint8_t ssd1306_copy_bit(uint8_t src, int srcBits, uint8_t dst, int dstBits)
 }
 
 
+// Bit-reversed nibbles
+static const uint8_t reverse_nibble[16] = {
+	0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
 // Rotate 8-bit data
 // 0x12-->0x48
 uint8_t ssd1306_rotate_byte(uint8_t ch1) {
-	uint8_t ch2 = 0;
-	for (int j=0;j<8;j++) {
-		ch2 = (ch2 << 1) + (ch1 & 0x01);
-		ch1 = ch1 >> 1;
-	}
-	return ch2;
+	return (reverse_nibble[ch1 & 0x0F] << 4) | reverse_nibble[ch1 >> 4];
 }
 
 
 void ssd1306_fadeout(SSD1306_t * dev)
 {
-	void (*func)(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
+	int (*func)(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
 	if (dev->_address == SPI_ADDRESS) {
 		func = spi_display_image;
 	} else {
 		func = i2c_display_image;
 	}
 
-	uint8_t image[1];
+	uint8_t image;
 	for(int page=0; page<dev->_pages; page++) {
-		image[0] = 0xFF;
+		image = 0xFF;
 		for(int line=0; line<8; line++) {
 			if (dev->_flip) {
-				image[0] = image[0] >> 1;
+				image = image >> 1;
 			} else {
-				image[0] = image[0] << 1;
+				image = image << 1;
 			}
-			for(int seg=0; seg<128; seg++) {
-				(*func)(dev, page, seg, image, 1);
-				dev->_page[page]._segs[seg] = image[0];
+			// One write per line instead of one per segment
+			memset(dev->_page[page]._segs, image, 128);
+			int sent = (*func)(dev, page, 0, dev->_page[page]._segs, 128);
+			ssd1306_shadow_sent(dev, page, 0, dev->_page[page]._segs, 128, sent);
+		}
+	}
+}
+
+// Effect engine. Effects run from an esp_timer, so starting one does not block.
+// All of them except EFFECT_WIPE are a few command bytes per step (contrast,
+// display on/off or the controller's own fade/blink), with no page writes.
+// EFFECT_WIPE changes every byte of the panel, so it sends full frames, shifted
+// from a copy of _page[] taken at the start: drawing into _page[] may go on, but
+// the wipe owns the bus and nothing may be sent until ssd1306_effect_running() == false.
+// The timer task shares the bus: on I2C, drawing may go on during contrast and
+// blink effects, on SPI (shared D/C pin) wait for ssd1306_effect_running() == false.
+#define EFFECT_STEP_MS 20
+#define EFFECT_FRAME_HZ 100 // Approximate refresh rate with the default clock divider
+#define EFFECT_HW_STEPS 16  // Approximate contrast steps in a hardware fade
+
+struct EFFECT_t {
+	esp_timer_handle_t _timer;
+	SemaphoreHandle_t _lock; // Held by a step, and by start and stop while they write to the panel
+	PAGE_t *_frame; // Panel contents shifted by EFFECT_WIPE
+	ssd1306_effect_type_t _type;
+	int _level; // Contrast ramped from or to
+	int _contrast; // Last contrast sent, -1 if none
+	int _step;
+	int _steps; // Timer steps per ramp
+	int _bytes; // Bus bytes sent for this effect
+	bool _running;
+};
+
+static int ssd1306_commands(SSD1306_t * dev, const uint8_t * commands, int len)
+{
+	if (dev->_address == SPI_ADDRESS) {
+		return spi_master_write_commands(dev, commands, len) ? len : 0;
+	} else {
+		return i2c_write_commands(dev, commands, len);
+	}
+}
+
+static void ssd1306_effect_contrast(SSD1306_t * dev, int contrast)
+{
+	struct EFFECT_t * fx = dev->_effect;
+	if (contrast == fx->_contrast) return;
+	uint8_t commands[2] = { OLED_CMD_SET_CONTRAST, contrast };
+	fx->_bytes += ssd1306_commands(dev, commands, 2);
+	fx->_contrast = contrast;
+}
+
+static void ssd1306_effect_done(SSD1306_t * dev)
+{
+	struct EFFECT_t * fx = dev->_effect;
+	esp_timer_stop(fx->_timer);
+	fx->_running = false;
+	ESP_LOGD(TAG, "effect %d done, %d bytes", fx->_type, fx->_bytes);
+}
+
+static void ssd1306_effect_step(void * arg)
+{
+	SSD1306_t * dev = (SSD1306_t *)arg;
+	struct EFFECT_t * fx = dev->_effect;
+	// Start and stop hold the lock after stopping the timer: skip this step, it is the last
+	if (xSemaphoreTake(fx->_lock, 0) != pdTRUE) return;
+	if (!fx->_running) {
+		xSemaphoreGive(fx->_lock);
+		return;
+	}
+	int step = ++fx->_step;
+	uint8_t command;
+
+	switch (fx->_type) {
+	case EFFECT_FADE_IN:
+		ssd1306_effect_contrast(dev, fx->_level * step / fx->_steps);
+		if (step >= fx->_steps) ssd1306_effect_done(dev);
+		break;
+	case EFFECT_FADE_OUT:
+		ssd1306_effect_contrast(dev, fx->_level * (fx->_steps - step) / fx->_steps);
+		if (step >= fx->_steps) {
+			// Contrast 0 is dim, not dark
+			command = OLED_CMD_DISPLAY_OFF;
+			fx->_bytes += ssd1306_commands(dev, &command, 1);
+			ssd1306_effect_done(dev);
+		}
+		break;
+	case EFFECT_BREATHE: {
+		int phase = step % (2 * fx->_steps);
+		int distance = (phase < fx->_steps) ? fx->_steps - phase : phase - fx->_steps;
+		ssd1306_effect_contrast(dev, fx->_level * distance / fx->_steps);
+		break;
+	}
+	case EFFECT_BLINK:
+		command = (step & 1) ? OLED_CMD_DISPLAY_OFF : OLED_CMD_DISPLAY_ON;
+		fx->_bytes += ssd1306_commands(dev, &command, 1);
+		break;
+	case EFFECT_WIPE:
+		for (int page = 0; page < dev->_pages; page++) {
+			for (int seg = 0; seg < dev->_width; seg++) {
+				if (dev->_flip) {
+					fx->_frame[page]._segs[seg] >>= 1;
+				} else {
+					fx->_frame[page]._segs[seg] <<= 1;
+				}
 			}
 		}
+		if (dev->_address == SPI_ADDRESS) {
+			fx->_bytes += spi_display_frame(dev, fx->_frame);
+		} else {
+			fx->_bytes += i2c_display_frame(dev, fx->_frame);
+		}
+		if (step >= 8) ssd1306_effect_done(dev);
+		break;
+	default:
+		ssd1306_effect_done(dev);
+		break;
 	}
+	xSemaphoreGive(fx->_lock);
+}
+
+static void ssd1306_effect_sync(void * arg)
+{
+	xSemaphoreGive((SemaphoreHandle_t)arg);
+}
+
+// Wait for a step the timer task may already have started. Callbacks run one at a time in
+// that task, so once a callback queued after esp_timer_stop() has run, no step is left.
+static void ssd1306_effect_flush(void)
+{
+	SemaphoreHandle_t done = xSemaphoreCreateBinary();
+	if (done == NULL) return;
+	esp_timer_create_args_t timer_args = {
+		.callback = ssd1306_effect_sync,
+		.arg = done,
+		.dispatch_method = ESP_TIMER_TASK,
+		.name = "ssd1306_sync",
+	};
+	esp_timer_handle_t timer;
+	if (esp_timer_create(&timer_args, &timer) == ESP_OK) {
+		esp_timer_start_once(timer, 0);
+		xSemaphoreTake(done, portMAX_DELAY);
+		esp_timer_delete(timer);
+	}
+	vSemaphoreDelete(done);
+}
+
+// Start an effect, replacing the one running. level is the contrast (0-255) to ramp from or to.
+// duration_ms is the ramp time for FADE_IN, FADE_OUT and WIPE, half a breath for BREATHE,
+// the off and on time for BLINK and the approximate fade time for HW_FADE_OUT and HW_BLINK.
+// Returns false if the timer, or the copy of the frame EFFECT_WIPE shifts, could not be allocated.
+bool ssd1306_effect_start(SSD1306_t * dev, ssd1306_effect_type_t effect, int level, int duration_ms)
+{
+	struct EFFECT_t * fx = dev->_effect;
+	if (fx == NULL) {
+		fx = calloc(1, sizeof(struct EFFECT_t));
+		if (fx == NULL) {
+			ESP_LOGE(TAG, "effect allocation fail");
+			return false;
+		}
+		esp_timer_create_args_t timer_args = {
+			.callback = ssd1306_effect_step,
+			.arg = dev,
+			.dispatch_method = ESP_TIMER_TASK,
+			.name = "ssd1306_effect",
+		};
+		fx->_lock = xSemaphoreCreateMutex();
+		if (fx->_lock == NULL || esp_timer_create(&timer_args, &fx->_timer) != ESP_OK) {
+			ESP_LOGE(TAG, "effect timer create fail");
+			if (fx->_lock) vSemaphoreDelete(fx->_lock);
+			free(fx);
+			return false;
+		}
+		dev->_effect = fx;
+	}
+	esp_timer_stop(fx->_timer);
+	xSemaphoreTake(fx->_lock, portMAX_DELAY);
+	if (fx->_type == EFFECT_HW_FADE_OUT || fx->_type == EFFECT_HW_BLINK) {
+		uint8_t off[2] = { OLED_CMD_SET_FADE_BLINK, OLED_FADE_BLINK_OFF };
+		ssd1306_commands(dev, off, 2);
+	}
+
+	if (level < 0) level = 0;
+	if (level > 0xFF) level = 0xFF;
+	if (duration_ms < EFFECT_STEP_MS) duration_ms = EFFECT_STEP_MS;
+	fx->_type = effect;
+	fx->_level = level;
+	fx->_contrast = -1;
+	fx->_step = 0;
+	fx->_steps = duration_ms / EFFECT_STEP_MS;
+	fx->_bytes = 0;
+	fx->_running = true;
+
+	int period_ms = EFFECT_STEP_MS;
+	uint8_t commands[4];
+	switch (effect) {
+	case EFFECT_FADE_IN:
+		commands[0] = OLED_CMD_SET_CONTRAST;
+		commands[1] = 0;
+		commands[2] = OLED_CMD_DISPLAY_ON;
+		fx->_bytes += ssd1306_commands(dev, commands, 3);
+		fx->_contrast = 0;
+		break;
+	case EFFECT_BLINK:
+		period_ms = duration_ms;
+		break;
+	case EFFECT_WIPE:
+		if (fx->_frame == NULL) fx->_frame = malloc(sizeof(PAGE_t) * dev->_pages);
+		if (fx->_frame == NULL) {
+			ESP_LOGE(TAG, "wipe frame allocation fail");
+			fx->_running = false;
+			xSemaphoreGive(fx->_lock);
+			return false;
+		}
+		memcpy(fx->_frame, dev->_page, sizeof(PAGE_t) * dev->_pages);
+		// The panel will no longer match the shadow: the next diff sends a full frame
+		ssd1306_shadow_drop(dev);
+		period_ms = duration_ms / 8;
+		if (period_ms < 1) period_ms = 1;
+		break;
+	case EFFECT_HW_FADE_OUT:
+	case EFFECT_HW_BLINK: {
+		// One command, then the controller runs the effect with no bus traffic
+		int interval = duration_ms * EFFECT_FRAME_HZ / 1000 / EFFECT_HW_STEPS / 8 - 1;
+		if (interval < 0) interval = 0;
+		if (interval > 0x0F) interval = 0x0F;
+		commands[0] = OLED_CMD_SET_CONTRAST;
+		commands[1] = level;
+		commands[2] = OLED_CMD_SET_FADE_BLINK;
+		commands[3] = ((effect == EFFECT_HW_BLINK) ? OLED_BLINK : OLED_FADE_OUT) | interval;
+		fx->_bytes += ssd1306_commands(dev, commands, 4);
+		fx->_contrast = level;
+		xSemaphoreGive(fx->_lock);
+		return true;
+	}
+	default:
+		break;
+	}
+	xSemaphoreGive(fx->_lock);
+	esp_timer_start_periodic(fx->_timer, (uint64_t)period_ms * 1000);
+	return true;
+}
+
+// Cancel the effect and put the panel back on at the effect's level.
+// A step already running finishes first, so the commands below are not interleaved with it.
+void ssd1306_effect_stop(SSD1306_t * dev)
+{
+	struct EFFECT_t * fx = dev->_effect;
+	if (fx == NULL) return;
+	esp_timer_stop(fx->_timer);
+	xSemaphoreTake(fx->_lock, portMAX_DELAY);
+	uint8_t commands[5];
+	int len = 0;
+	if (fx->_type == EFFECT_HW_FADE_OUT || fx->_type == EFFECT_HW_BLINK) {
+		commands[len++] = OLED_CMD_SET_FADE_BLINK;
+		commands[len++] = OLED_FADE_BLINK_OFF;
+	}
+	commands[len++] = OLED_CMD_SET_CONTRAST;
+	commands[len++] = fx->_level;
+	commands[len++] = OLED_CMD_DISPLAY_ON;
+	fx->_bytes += ssd1306_commands(dev, commands, len);
+	fx->_contrast = fx->_level;
+	fx->_type = 0;
+	fx->_running = false;
+	xSemaphoreGive(fx->_lock);
+}
+
+// Stop the effect and free it once the timer task is done with it. Do not call from an effect callback.
+void ssd1306_effect_deinit(SSD1306_t * dev)
+{
+	struct EFFECT_t * fx = dev->_effect;
+	if (fx == NULL) return;
+	ssd1306_effect_stop(dev);
+	ssd1306_effect_flush();
+	esp_timer_delete(fx->_timer);
+	vSemaphoreDelete(fx->_lock);
+	free(fx->_frame);
+	free(fx);
+	dev->_effect = NULL;
+}
+
+// True while a timed effect has steps left. Hardware and repeating effects run until stopped.
+bool ssd1306_effect_running(SSD1306_t * dev)
+{
+	return dev->_effect != NULL && dev->_effect->_running;
+}
+
+// Bus bytes sent for the current or last effect, control bytes included.
+int ssd1306_effect_bytes(SSD1306_t * dev)
+{
+	if (dev->_effect == NULL) return 0;
+	return dev->_effect->_bytes;
 }
 
 // Rotate character image
 // Only valid for 8 dots x 8 dots
+// The image is packed into a 64-bit word and transposed with three
+// masked swaps (2x2, 4x4 then 8x8 blocks) instead of bit by bit.
 void ssd1306_rotate_image(uint8_t *image, bool flip) {
-	uint8_t _image[8];
-	uint8_t _smask = 0x01;
+	// Unless flipped, the rows go in reversed, which mirrors the result
+	uint64_t x = 0;
 	for (int i=0;i<8;i++) {
-		uint8_t _dmask = 0x80;
-		_image[i] = 0;
-		for (int j=0;j<8;j++) {
-			uint8_t _wk = image[j] & _smask;
-			ESP_LOGD(__FUNCTION__, "image[%d]=0x%x _smask=0x%x _wk=0x%x", j, image[j], _smask, _wk);
-			if (_wk != 0) {
-				_image[i] = _image[i] + _dmask;
-			}
-			_dmask = _dmask >> 1;
-		}
-		_smask = _smask << 1;
+		x |= (uint64_t)image[i] << (8 * (flip ? i : 7 - i));
 	}
 
+	uint64_t t;
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
 	for (int i=0;i<8;i++) {
-		image[i] = _image[i];
-	}
-	if (flip) ssd1306_flip(image, 8);
-#if 0
-	for (int i=0;i<8;i++) {
-		ESP_LOGI(__FUNCTION__, "image[%d]=0x%x", i, image[i]);
+		image[i] = (uint8_t)(x >> (8 * i));
 	}
-#endif
 }
 
 void ssd1306_display_rotate_text(SSD1306_t * dev, int seg, const char * text, int text_len, bool invert) {
@@ -1,6 +1,10 @@
 #ifndef MAIN_SSD1306_H_
 #define MAIN_SSD1306_H_
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "driver/spi_master.h"
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0))
 #include "driver/i2c_master.h"
@@ -73,6 +77,24 @@ Usage:
 #define OLED_CMD_ACTIVE_SCROLL          0x2F
 #define OLED_CMD_VERTICAL               0xA3
 
+// Advance Graphic Command
+#define OLED_CMD_SET_FADE_BLINK         0x23    // follow with mode | interval
+#define OLED_FADE_BLINK_OFF             0x00
+#define OLED_FADE_OUT                   0x20
+#define OLED_BLINK                      0x30    // interval 0x0-0xF = 8-128 frames per step
+
+// Largest I2C write: data stream control byte plus a whole 128x64 frame
+#define I2C_BUF_SIZE (1 + 128 * 8)
+
+// Whole 128x64 frame in one SPI data transaction
+#define SPI_BUF_SIZE (128 * 8)
+
+// Bus bytes to open a page write window, besides the data. I2C: address byte,
+// three commands with a control byte each and the data stream control byte.
+// SPI: three commands, D/C selects command or data.
+#define I2C_WINDOW_COST (1 + 3 * 2 + 1)
+#define SPI_WINDOW_COST 3
+
 #define I2C_ADDRESS 0x3C
 #define SPI_ADDRESS 0xFF
 
@@ -98,7 +120,35 @@ typedef struct {
 	uint8_t _segs[128];
 } PAGE_t;
 
+// Text lines the console keeps for ssd1306_console_redraw()
+#define CONSOLE_BACKLOG 32
+
 typedef struct {
+	int _top; // RAM page at the top of the panel (display start line / 8)
+	int _head; // Backlog slot of the newest line
+	int _count; // Lines in the backlog
+	int _back; // Lines scrolled back by ssd1306_console_redraw()
+	char _text[CONSOLE_BACKLOG][16];
+	bool _invert[CONSOLE_BACKLOG];
+} CONSOLE_t;
+
+typedef enum {
+	EFFECT_FADE_IN = 1,     // Contrast ramp from 0 up to the level, display on
+	EFFECT_FADE_OUT = 2,    // Contrast ramp down to 0, then display off
+	EFFECT_BREATHE = 3,     // Contrast ramp down and back up, repeating
+	EFFECT_BLINK = 4,       // Display off and on, repeating
+	EFFECT_HW_FADE_OUT = 5, // Controller fades out by itself
+	EFFECT_HW_BLINK = 6,    // Controller blinks by itself
+	EFFECT_WIPE = 7         // Lit pixels shift out of every page (full frames)
+} ssd1306_effect_type_t;
+
+struct EFFECT_t;
+struct SSD1306_t;
+
+// Called from the flush task once an asynchronous flush is on the panel
+typedef void (*ssd1306_flush_cb_t)(struct SSD1306_t * dev, void * arg);
+
+typedef struct SSD1306_t {
 	int _address;
 	int _width;
 	int _height;
@@ -108,26 +158,88 @@ typedef struct {
 	int _scStart;
 	int _scEnd;
 	int _scDirection;
-	PAGE_t _page[8];
+	PAGE_t *_page; // _pages entries, see ssd1306_init_pages()
+	bool _own_page; // _page was allocated by ssd1306_init()
 	bool _flip;
+	bool _horizontal; // Controller left in horizontal addressing mode by a frame push
 	i2c_port_t _i2c_num;
 	spi_device_handle_t _spi_device_handle;
+	uint8_t *_spi_buf; // DMA-capable frame buffer, SPI_BUF_SIZE bytes
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0))
 	i2c_master_bus_handle_t _i2c_bus_handle;
 	i2c_master_dev_handle_t _i2c_dev_handle;
+	uint8_t *_i2c_buf; // Transfer buffer, I2C_BUF_SIZE bytes
 #endif
+	PAGE_t *_shadow; // Panel contents for ssd1306_show_buffer_diff(), NULL until its first call
+	PAGE_t *_flush_page; // Back buffer sent by the flush task
+	TaskHandle_t _flush_task;
+	EventGroupHandle_t _flush_event;
+	ssd1306_flush_cb_t _flush_cb;
+	void *_flush_arg;
+	bool _flush_failed; // The last asynchronous flush did not get to the panel
+	CONSOLE_t *_console; // Allocated by ssd1306_console_init()
+	struct EFFECT_t *_effect; // Allocated by ssd1306_effect_start()
 } SSD1306_t;
 
+// Panels one display manager can own
+#define MANAGER_MAX_PANELS 4
+
+typedef struct {
+	SSD1306_t *_dev;
+	PAGE_t _staged[8]; // Last frame committed by ssd1306_manager_commit()
+	uint8_t _dirty; // Bit per page not yet sent from _staged
+	int _cursor; // Next page to send
+	bool _alarm; // Flushed ahead of panels without an alarm
+	uint32_t _commits;
+	uint32_t _frames; // Commits completely on the panel
+	uint32_t _bytes;
+	uint32_t _errors; // Page writes that failed
+	int64_t _busy_us; // Time spent writing to this panel
+	int64_t _since_us; // Start of the stats interval
+} MANAGER_PANEL_t;
+
+typedef struct {
+	MANAGER_PANEL_t _panel[MANAGER_MAX_PANELS];
+	int _count;
+	int _next; // Round-robin position
+	SemaphoreHandle_t _lock; // Panel state
+	SemaphoreHandle_t _bus; // Held by the task while it writes a page
+	TaskHandle_t _task;
+} MANAGER_t;
+
+typedef struct {
+	float fps; // Frames completely on the panel per second
+	float bus_load; // Share of the interval spent writing to this panel, 0.0 to 1.0
+	uint32_t commits; // Commits that changed the buffer; commits - frames were coalesced
+	uint32_t frames;
+	uint32_t bytes;
+	uint32_t errors; // Page writes that failed and were queued again
+} ssd1306_manager_stats_t;
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-void ssd1306_init(SSD1306_t * dev, int width, int height);
+bool ssd1306_init(SSD1306_t * dev, int width, int height);
+void ssd1306_init_pages(SSD1306_t * dev, int width, int height, PAGE_t * page);
+void ssd1306_deinit(SSD1306_t * dev);
+void ssd1306_reset_state(SSD1306_t * dev);
 int ssd1306_get_width(SSD1306_t * dev);
 int ssd1306_get_height(SSD1306_t * dev);
 int ssd1306_get_pages(SSD1306_t * dev);
 void ssd1306_show_buffer(SSD1306_t * dev);
+int ssd1306_show_buffer_diff(SSD1306_t * dev);
+bool ssd1306_async_init(SSD1306_t * dev, ssd1306_flush_cb_t callback, void * arg);
+void ssd1306_async_deinit(SSD1306_t * dev);
+void ssd1306_show_buffer_async(SSD1306_t * dev);
+bool ssd1306_wait_flush(SSD1306_t * dev, TickType_t ticks_to_wait);
+bool ssd1306_manager_init(MANAGER_t * mgr);
+void ssd1306_manager_deinit(MANAGER_t * mgr);
+int ssd1306_manager_add(MANAGER_t * mgr, SSD1306_t * dev);
+void ssd1306_manager_commit(MANAGER_t * mgr, int index);
+void ssd1306_manager_alarm(MANAGER_t * mgr, int index, bool alarm);
+void ssd1306_manager_stats(MANAGER_t * mgr, int index, ssd1306_manager_stats_t * stats);
 void ssd1306_set_buffer(SSD1306_t * dev, const uint8_t * buffer);
 void ssd1306_get_buffer(SSD1306_t * dev, uint8_t * buffer);
 void ssd1306_set_page(SSD1306_t * dev, int page, const uint8_t * buffer);
@@ -136,7 +248,9 @@ void ssd1306_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * i
 void ssd1306_display_text(SSD1306_t * dev, int page, const char * text, int text_len, bool invert);
 void ssd1306_display_text_box1(SSD1306_t * dev, int page, int seg, const char * text, int box_width, int text_len, bool invert, int delay);
 void ssd1306_display_text_box2(SSD1306_t * dev, int page, int seg, const char * text, int box_width, int text_len, bool invert, int delay);
+void ssd1306_display_text_x2(SSD1306_t * dev, int page, const char * text, int text_len, bool invert);
 void ssd1306_display_text_x3(SSD1306_t * dev, int page, const char * text, int text_len, bool invert);
+void ssd1306_display_text_x4(SSD1306_t * dev, int page, const char * text, int text_len, bool invert);
 void ssd1306_clear_screen(SSD1306_t * dev, bool invert);
 void ssd1306_clear_line(SSD1306_t * dev, int page, bool invert);
 void ssd1306_contrast(SSD1306_t * dev, int contrast);
@@ -144,6 +258,10 @@ void ssd1306_software_scroll(SSD1306_t * dev, int start, int end);
 void ssd1306_scroll_text(SSD1306_t * dev, const char * text, int text_len, bool invert);
 void ssd1306_scroll_clear(SSD1306_t * dev);
 void ssd1306_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll);
+bool ssd1306_console_init(SSD1306_t * dev);
+void ssd1306_console_deinit(SSD1306_t * dev);
+void ssd1306_console_print(SSD1306_t * dev, const char * text, int text_len, bool invert);
+void ssd1306_console_redraw(SSD1306_t * dev, int back);
 void ssd1306_wrap_arround(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, int8_t delay);
 void _ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitmap, int width, int height, bool invert);
 void ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, const uint8_t * bitmap, int width, int height, bool invert);
@@ -157,6 +275,11 @@ void ssd1306_flip(uint8_t *buf, size_t blen);
 uint8_t ssd1306_copy_bit(uint8_t src, int srcBits, uint8_t dst, int dstBits);
 uint8_t ssd1306_rotate_byte(uint8_t ch1);
 void ssd1306_fadeout(SSD1306_t * dev);
+bool ssd1306_effect_start(SSD1306_t * dev, ssd1306_effect_type_t effect, int level, int duration_ms);
+void ssd1306_effect_stop(SSD1306_t * dev);
+void ssd1306_effect_deinit(SSD1306_t * dev);
+bool ssd1306_effect_running(SSD1306_t * dev);
+int ssd1306_effect_bytes(SSD1306_t * dev);
 void ssd1306_rotate_image(uint8_t *image, bool flip);
 void ssd1306_display_rotate_text(SSD1306_t * dev, int seg, const char * text, int text_len, bool invert);
 void ssd1306_dump(SSD1306_t dev);
@@ -165,7 +288,11 @@ void ssd1306_dump_page(SSD1306_t * dev, int page, int seg);
 void i2c_master_init(SSD1306_t * dev, int16_t sda, int16_t scl, int16_t reset);
 void i2c_device_add(SSD1306_t * dev, i2c_port_t i2c_num, int16_t reset, uint16_t i2c_address);
 void i2c_init(SSD1306_t * dev, int width, int height);
-void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
+int i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
+int i2c_display_frame(SSD1306_t * dev, const PAGE_t * pages);
+void i2c_console_page(SSD1306_t * dev, int ram_page, const uint8_t * images, int start_line);
+int i2c_write_commands(SSD1306_t * dev, const uint8_t * commands, int len);
+void i2c_deinit(SSD1306_t * dev);
 void i2c_contrast(SSD1306_t * dev, int contrast);
 void i2c_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll);
 
@@ -177,7 +304,10 @@ bool spi_master_write_commands(SSD1306_t * dev, const uint8_t * Commands, size_t
 bool spi_master_write_command(SSD1306_t * dev, uint8_t Command );
 bool spi_master_write_data(SSD1306_t * dev, const uint8_t* Data, size_t DataLength );
 void spi_init(SSD1306_t * dev, int width, int height);
-void spi_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
+int spi_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width);
+int spi_display_frame(SSD1306_t * dev, const PAGE_t * pages);
+void spi_console_page(SSD1306_t * dev, int ram_page, const uint8_t * images, int start_line);
+void spi_deinit(SSD1306_t * dev);
 void spi_contrast(SSD1306_t * dev, int contrast);
 void spi_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll);
 
@@ -0,0 +1,97 @@
+#ifndef MAIN_SSD1306_HPP_
+#define MAIN_SSD1306_HPP_
+
+#include <string.h>
+
+#include "ssd1306.h"
+
+// Compile-time sized wrapper over the C driver.
+// Ssd1306<128, 32> holds exactly 4 pages, the geometry is constexpr and
+// the page loops below are unrolled. The object converts to SSD1306_t *,
+// so the transport and ssd1306_* functions take it as is:
+//
+//	Ssd1306<128, 32> oled;
+//	i2c_master_init(oled, CONFIG_SDA_GPIO, CONFIG_SCL_GPIO, CONFIG_RESET_GPIO);
+//	oled.init();
+//	ssd1306_display_text(oled, 0, "Hello", 5, false);
+
+namespace ssd1306_detail {
+
+// Calls f(0) .. f(N - 1) with constant arguments
+template <int N>
+struct unroll {
+	template <typename F>
+	static inline void run(F & f) {
+		unroll<N - 1>::run(f);
+		f(N - 1);
+	}
+};
+
+template <>
+struct unroll<0> {
+	template <typename F>
+	static inline void run(F &) {}
+};
+
+} // namespace ssd1306_detail
+
+template <int W, int H>
+class Ssd1306 {
+public:
+	static_assert(W > 0 && W <= 128, "SSD1306 has 128 columns");
+	static_assert(H == 32 || H == 64, "the driver supports 32 and 64 line panels");
+
+	static constexpr int width = W;
+	static constexpr int height = H;
+	static constexpr int pages = H / 8;
+	static constexpr int buffer_size = W * pages;
+
+	Ssd1306() : _dev() {}
+	~Ssd1306() { ssd1306_deinit(&_dev); }
+	Ssd1306(const Ssd1306 &) = delete;
+	Ssd1306 & operator=(const Ssd1306 &) = delete;
+
+	// Call after the transport (i2c_master_init(), spi_master_init(), ...)
+	void init() { ssd1306_init_pages(&_dev, W, H, _page); }
+
+	SSD1306_t * dev() { return &_dev; }
+	operator SSD1306_t *() { return &_dev; }
+
+	uint8_t * segs(int page) { return _page[page]._segs; }
+
+	void clear(bool invert = false) {
+		const uint8_t fill = invert ? 0xFF : 0x00;
+		auto f = [&](int page) { memset(_page[page]._segs, fill, W); };
+		ssd1306_detail::unroll<pages>::run(f);
+	}
+
+	// buffer is buffer_size bytes, page after page
+	void set_buffer(const uint8_t * buffer) {
+		auto f = [&](int page) { memcpy(_page[page]._segs, &buffer[page * W], W); };
+		ssd1306_detail::unroll<pages>::run(f);
+	}
+
+	void get_buffer(uint8_t * buffer) {
+		auto f = [&](int page) { memcpy(&buffer[page * W], _page[page]._segs, W); };
+		ssd1306_detail::unroll<pages>::run(f);
+	}
+
+	// Set pixel to internal buffer. Not show it.
+	// Same result as _ssd1306_pixel(), which mirrors the whole byte when _flip is set.
+	void pixel(int xpos, int ypos, bool invert = false) {
+		if ((unsigned)xpos >= (unsigned)W || (unsigned)ypos >= (unsigned)H) return;
+		const uint8_t bit = 1 << (ypos & 7);
+		uint8_t & seg = _page[ypos >> 3]._segs[xpos];
+		const uint8_t value = invert ? (seg & ~bit) : (seg | bit);
+		seg = _dev._flip ? ssd1306_rotate_byte(value) : value;
+	}
+
+	void show() { ssd1306_show_buffer(&_dev); }
+	int show_diff() { return ssd1306_show_buffer_diff(&_dev); }
+
+private:
+	SSD1306_t _dev;
+	PAGE_t _page[pages];
+};
+
+#endif /* MAIN_SSD1306_HPP_ */
@@ -44,6 +44,7 @@ void i2c_master_init(SSD1306_t * dev, int16_t sda, int16_t scl, int16_t reset)
 		gpio_set_level(reset, 1);
 	}
 
+	ssd1306_reset_state(dev);
 	dev->_address = I2C_ADDRESS;
 	dev->_flip = false;
 	dev->_i2c_num = I2C_NUM;
@@ -75,6 +76,7 @@ void i2c_device_add(SSD1306_t * dev, i2c_port_t i2c_num, int16_t reset, uint16_t
 		gpio_set_level(reset, 1);
 	}
 
+	ssd1306_reset_state(dev);
 	dev->_address = i2c_address;
 	dev->_flip = false;
 	dev->_i2c_num = i2c_num;
@@ -85,6 +87,7 @@ void i2c_init(SSD1306_t * dev, int width, int height) {
 	dev->_height = height;
 	dev->_pages = 8;
 	if (dev->_height == 32) dev->_pages = 4;
+	dev->_horizontal = false;
 	
 	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
 
@@ -141,9 +144,11 @@ void i2c_init(SSD1306_t * dev, int width, int height) {
 }
 
 
-void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width) {
-	if (page >= dev->_pages) return;
-	if (seg >= dev->_width) return;
+// Returns the bytes sent, or 0 on error.
+int i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width) {
+	if (page >= dev->_pages) return 0;
+	if (seg >= dev->_width) return 0;
+	int sent = 1 + 3;
 
 	int _seg = seg + CONFIG_OFFSETX;
 	uint8_t columLow = _seg & 0x0F;
@@ -159,6 +164,12 @@ void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * image
 	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
 
 	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
+	if (dev->_horizontal) {
+		i2c_master_write_byte(cmd, OLED_CMD_SET_MEMORY_ADDR_MODE, true);	// 20
+		i2c_master_write_byte(cmd, OLED_CMD_SET_PAGE_ADDR_MODE, true);		// 02
+		dev->_horizontal = false;
+		sent = sent + 2;
+	}
 	// Set Lower Column Start Address for Page Addressing Mode
 	i2c_master_write_byte(cmd, (0x00 + columLow), true);
 	// Set Higher Column Start Address for Page Addressing Mode
@@ -170,6 +181,7 @@ void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * image
 	esp_err_t res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
 	if (res != ESP_OK) {
 		ESP_LOGE(TAG, "Image command failed. code: 0x%.2X", res);
+		sent = 0;
 	}
 	i2c_cmd_link_delete(cmd);
 
@@ -181,10 +193,140 @@ void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * image
 	i2c_master_stop(cmd);
 
 	res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
+	i2c_cmd_link_delete(cmd);
 	if (res != ESP_OK) {
 		ESP_LOGE(TAG, "Image command failed. code: 0x%.2X", res);
+		return 0;
+	}
+	return sent == 0 ? 0 : sent + 1 + width;
+}
+
+// Send all pages with horizontal addressing: one command stream and one data burst.
+// Returns the bytes sent, or 0 on error.
+int i2c_display_frame(SSD1306_t * dev, const PAGE_t * pages) {
+	int sent = 1 + 6;
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+	i2c_master_start(cmd);
+	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
+	if (!dev->_horizontal) {
+		i2c_master_write_byte(cmd, OLED_CMD_SET_MEMORY_ADDR_MODE, true);	// 20
+		i2c_master_write_byte(cmd, OLED_CMD_SET_HORI_ADDR_MODE, true);		// 00
+		sent = sent + 2;
+	}
+	i2c_master_write_byte(cmd, OLED_CMD_SET_COLUMN_RANGE, true);			// 21
+	i2c_master_write_byte(cmd, CONFIG_OFFSETX, true);
+	i2c_master_write_byte(cmd, CONFIG_OFFSETX + dev->_width - 1, true);
+	i2c_master_write_byte(cmd, OLED_CMD_SET_PAGE_RANGE, true);				// 22
+	i2c_master_write_byte(cmd, 0, true);
+	i2c_master_write_byte(cmd, dev->_pages - 1, true);
+	i2c_master_stop(cmd);
+
+	esp_err_t res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
+	i2c_cmd_link_delete(cmd);
+	if (res != ESP_OK) {
+		ESP_LOGE(TAG, "Frame command failed. code: 0x%.2X", res);
+		return 0;
+	}
+	dev->_horizontal = true;
+
+	cmd = i2c_cmd_link_create();
+	i2c_master_start(cmd);
+	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_DATA_STREAM, true);
+	for (int page=0; page<dev->_pages; page++) {
+		int _page = page;
+		if (dev->_flip) {
+			_page = (dev->_pages - page) - 1;
+		}
+		i2c_master_write(cmd, pages[_page]._segs, dev->_width, true);
+	}
+	i2c_master_stop(cmd);
+
+	res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
+	i2c_cmd_link_delete(cmd);
+	if (res != ESP_OK) {
+		ESP_LOGE(TAG, "Frame command failed. code: 0x%.2X", res);
+		return 0;
 	}
+	return sent + 1 + dev->_width * dev->_pages;
+}
+
+// Console scroll step: write a whole RAM page, with no flip mapping, then move the display start line.
+// The page goes first so it is written while it is still off screen (on 32-line panels).
+// A negative ram_page or start_line skips that part.
+void i2c_console_page(SSD1306_t * dev, int ram_page, const uint8_t * images, int start_line) {
+	i2c_cmd_handle_t cmd;
+	esp_err_t res;
+	if (ram_page >= 0) {
+		cmd = i2c_cmd_link_create();
+		i2c_master_start(cmd);
+		i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+		i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
+		if (dev->_horizontal) {
+			i2c_master_write_byte(cmd, OLED_CMD_SET_MEMORY_ADDR_MODE, true);	// 20
+			i2c_master_write_byte(cmd, OLED_CMD_SET_PAGE_ADDR_MODE, true);		// 02
+			dev->_horizontal = false;
+		}
+		i2c_master_write_byte(cmd, 0x00 + (CONFIG_OFFSETX & 0x0F), true);
+		i2c_master_write_byte(cmd, 0x10 + ((CONFIG_OFFSETX >> 4) & 0x0F), true);
+		i2c_master_write_byte(cmd, 0xB0 | ram_page, true);
+		i2c_master_stop(cmd);
+		res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
+		if (res != ESP_OK) {
+			ESP_LOGE(TAG, "Console command failed. code: 0x%.2X", res);
+		}
+		i2c_cmd_link_delete(cmd);
+
+		cmd = i2c_cmd_link_create();
+		i2c_master_start(cmd);
+		i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+		i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_DATA_STREAM, true);
+		i2c_master_write(cmd, images, dev->_width, true);
+		i2c_master_stop(cmd);
+		res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
+		if (res != ESP_OK) {
+			ESP_LOGE(TAG, "Console command failed. code: 0x%.2X", res);
+		}
+		i2c_cmd_link_delete(cmd);
+	}
+	if (start_line >= 0) {
+		cmd = i2c_cmd_link_create();
+		i2c_master_start(cmd);
+		i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+		i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
+		i2c_master_write_byte(cmd, OLED_CMD_SET_DISPLAY_START_LINE | (start_line & 0x3F), true);
+		i2c_master_stop(cmd);
+		res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
+		if (res != ESP_OK) {
+			ESP_LOGE(TAG, "Console command failed. code: 0x%.2X", res);
+		}
+		i2c_cmd_link_delete(cmd);
+	}
+}
+
+// Send up to 16 command bytes as one command stream.
+// Returns the bytes sent, control byte included, or 0 on error.
+int i2c_write_commands(SSD1306_t * dev, const uint8_t * commands, int len) {
+	if (len > 16) len = 16;
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+	i2c_master_start(cmd);
+	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
+	i2c_master_write(cmd, commands, len, true);
+	i2c_master_stop(cmd);
+
+	esp_err_t res = i2c_master_cmd_begin(dev->_i2c_num, cmd, I2C_TICKS_TO_WAIT);
 	i2c_cmd_link_delete(cmd);
+	if (res != ESP_OK) {
+		ESP_LOGE(TAG, "Command failed. code: 0x%.2X", res);
+		return 0;
+	}
+	return len + 1;
+}
+
+// The legacy driver builds each transfer in a command link and keeps no buffer.
+void i2c_deinit(SSD1306_t * dev) {
 }
 
 void i2c_contrast(SSD1306_t * dev, int contrast) {
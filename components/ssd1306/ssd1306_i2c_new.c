@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include <string.h>
 
 #include "freertos/FreeRTOS.h"
@@ -52,11 +53,16 @@ void i2c_master_init(SSD1306_t * dev, int16_t sda, int16_t scl, int16_t reset)
 		gpio_set_level(reset, 1);
 	}
 
+	ssd1306_reset_state(dev);
 	dev->_address = I2C_ADDRESS;
 	dev->_flip = false;
 	dev->_i2c_num = I2C_NUM;
 	dev->_i2c_bus_handle = i2c_bus_handle;
 	dev->_i2c_dev_handle = i2c_dev_handle;
+	dev->_i2c_buf = malloc(I2C_BUF_SIZE);
+	if (dev->_i2c_buf == NULL) {
+		ESP_LOGE(TAG, "malloc fail");
+	}
 }
 
 void i2c_device_add(SSD1306_t * dev, i2c_port_t i2c_num, int16_t reset, uint16_t i2c_address)
@@ -93,10 +99,15 @@ void i2c_device_add(SSD1306_t * dev, i2c_port_t i2c_num, int16_t reset, uint16_t
 		gpio_set_level(reset, 1);
 	}
 
+	ssd1306_reset_state(dev);
 	dev->_address = i2c_address;
 	dev->_flip = false;
 	dev->_i2c_num = i2c_num;
 	dev->_i2c_dev_handle = i2c_dev_handle;
+	dev->_i2c_buf = malloc(I2C_BUF_SIZE);
+	if (dev->_i2c_buf == NULL) {
+		ESP_LOGE(TAG, "malloc fail");
+	}
 }
 
 void i2c_init(SSD1306_t * dev, int width, int height) {
@@ -104,6 +115,7 @@ void i2c_init(SSD1306_t * dev, int width, int height) {
 	dev->_height = height;
 	dev->_pages = 8;
 	if (dev->_height == 32) dev->_pages = 4;
+	dev->_horizontal = false;
 	
 	uint8_t out_buf[27];
 	int out_index = 0;
@@ -156,9 +168,12 @@ void i2c_init(SSD1306_t * dev, int width, int height) {
 }
 
 
-void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width) {
-	if (page >= dev->_pages) return;
-	if (seg >= dev->_width) return;
+// Returns the bytes sent, or 0 on error.
+int i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width) {
+	if (dev->_i2c_buf == NULL) return 0;
+	if (page >= dev->_pages) return 0;
+	if (seg >= dev->_width) return 0;
+	if (width > 128) width = 128;
 
 	int _seg = seg + CONFIG_OFFSETX;
 	uint8_t columLow = _seg & 0x0F;
@@ -169,33 +184,146 @@ void i2c_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * image
 		_page = (dev->_pages - page) - 1;
 	}
 
-	uint8_t *out_buf;
-	out_buf = malloc(width < 4 ? 4 : width + 1);
-	if (out_buf == NULL) {
-		ESP_LOGE(TAG, "malloc fail");
-		return;
-	}
+	// Commands and data go out in one transaction: each command byte is
+	// preceded by a single-command control byte (Co=1), then the data stream.
+	uint8_t *out_buf = dev->_i2c_buf;
 	int out_index = 0;
-	out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_STREAM;
+	if (dev->_horizontal) {
+		out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+		out_buf[out_index++] = OLED_CMD_SET_MEMORY_ADDR_MODE;	// 20
+		out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+		out_buf[out_index++] = OLED_CMD_SET_PAGE_ADDR_MODE;		// 02
+		dev->_horizontal = false;
+	}
+	out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
 	// Set Lower Column Start Address for Page Addressing Mode
 	out_buf[out_index++] = (0x00 + columLow);
+	out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
 	// Set Higher Column Start Address for Page Addressing Mode
 	out_buf[out_index++] = (0x10 + columHigh);
+	out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
 	// Set Page Start Address for Page Addressing Mode
 	out_buf[out_index++] = 0xB0 | _page;
 
+	out_buf[out_index++] = OLED_CONTROL_BYTE_DATA_STREAM;
+	memcpy(&out_buf[out_index], images, width);
+	out_index = out_index + width;
+
 	esp_err_t res;
 	res = i2c_master_transmit(dev->_i2c_dev_handle, out_buf, out_index, I2C_TICKS_TO_WAIT);
-	if (res != ESP_OK)
+	if (res != ESP_OK) {
 		ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d (%s)", dev->_address, dev->_i2c_num, res, esp_err_to_name(res));
+		return 0;
+	}
+	return out_index;
+}
 
-	out_buf[0] = OLED_CONTROL_BYTE_DATA_STREAM;
-	memcpy(&out_buf[1], images, width);
+// Send all pages with horizontal addressing: one command stream and one data burst.
+// Returns the bytes sent, or 0 on error.
+int i2c_display_frame(SSD1306_t * dev, const PAGE_t * pages) {
+	if (dev->_i2c_buf == NULL) return 0;
+	uint8_t cmd_buf[10];
+	int cmd_index = 0;
+	cmd_buf[cmd_index++] = OLED_CONTROL_BYTE_CMD_STREAM;
+	if (!dev->_horizontal) {
+		cmd_buf[cmd_index++] = OLED_CMD_SET_MEMORY_ADDR_MODE;	// 20
+		cmd_buf[cmd_index++] = OLED_CMD_SET_HORI_ADDR_MODE;		// 00
+	}
+	cmd_buf[cmd_index++] = OLED_CMD_SET_COLUMN_RANGE;			// 21
+	cmd_buf[cmd_index++] = CONFIG_OFFSETX;
+	cmd_buf[cmd_index++] = CONFIG_OFFSETX + dev->_width - 1;
+	cmd_buf[cmd_index++] = OLED_CMD_SET_PAGE_RANGE;				// 22
+	cmd_buf[cmd_index++] = 0;
+	cmd_buf[cmd_index++] = dev->_pages - 1;
 
-	res = i2c_master_transmit(dev->_i2c_dev_handle, out_buf, width + 1, I2C_TICKS_TO_WAIT);
-	if (res != ESP_OK)
+	esp_err_t res;
+	res = i2c_master_transmit(dev->_i2c_dev_handle, cmd_buf, cmd_index, I2C_TICKS_TO_WAIT);
+	if (res != ESP_OK) {
 		ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d (%s)", dev->_address, dev->_i2c_num, res, esp_err_to_name(res));
-	free(out_buf);
+		return 0;
+	}
+	dev->_horizontal = true;
+
+	uint8_t *out_buf = dev->_i2c_buf;
+	int out_index = 0;
+	out_buf[out_index++] = OLED_CONTROL_BYTE_DATA_STREAM;
+	for (int page=0; page<dev->_pages; page++) {
+		int _page = page;
+		if (dev->_flip) {
+			_page = (dev->_pages - page) - 1;
+		}
+		memcpy(&out_buf[out_index], pages[_page]._segs, dev->_width);
+		out_index = out_index + dev->_width;
+	}
+
+	res = i2c_master_transmit(dev->_i2c_dev_handle, out_buf, out_index, I2C_TICKS_TO_WAIT);
+	if (res != ESP_OK) {
+		ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d (%s)", dev->_address, dev->_i2c_num, res, esp_err_to_name(res));
+		return 0;
+	}
+	return cmd_index + out_index;
+}
+
+// Console scroll step: write a whole RAM page, with no flip mapping, then move the display start line.
+// The page goes first so it is written while it is still off screen (on 32-line panels).
+// A negative ram_page or start_line skips that part.
+void i2c_console_page(SSD1306_t * dev, int ram_page, const uint8_t * images, int start_line) {
+	esp_err_t res;
+	uint8_t *out_buf = dev->_i2c_buf;
+	int out_index = 0;
+	if (ram_page >= 0 && out_buf != NULL) {
+		if (dev->_horizontal) {
+			out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+			out_buf[out_index++] = OLED_CMD_SET_MEMORY_ADDR_MODE;	// 20
+			out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+			out_buf[out_index++] = OLED_CMD_SET_PAGE_ADDR_MODE;		// 02
+			dev->_horizontal = false;
+		}
+		out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+		out_buf[out_index++] = 0x00 + (CONFIG_OFFSETX & 0x0F);
+		out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+		out_buf[out_index++] = 0x10 + ((CONFIG_OFFSETX >> 4) & 0x0F);
+		out_buf[out_index++] = OLED_CONTROL_BYTE_CMD_SINGLE;
+		out_buf[out_index++] = 0xB0 | ram_page;
+		out_buf[out_index++] = OLED_CONTROL_BYTE_DATA_STREAM;
+		memcpy(&out_buf[out_index], images, dev->_width);
+		out_index = out_index + dev->_width;
+
+		res = i2c_master_transmit(dev->_i2c_dev_handle, out_buf, out_index, I2C_TICKS_TO_WAIT);
+		if (res != ESP_OK)
+			ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d (%s)", dev->_address, dev->_i2c_num, res, esp_err_to_name(res));
+	}
+	if (start_line >= 0) {
+		uint8_t cmd_buf[2];
+		cmd_buf[0] = OLED_CONTROL_BYTE_CMD_STREAM;
+		cmd_buf[1] = OLED_CMD_SET_DISPLAY_START_LINE | (start_line & 0x3F);
+		res = i2c_master_transmit(dev->_i2c_dev_handle, cmd_buf, 2, I2C_TICKS_TO_WAIT);
+		if (res != ESP_OK)
+			ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d (%s)", dev->_address, dev->_i2c_num, res, esp_err_to_name(res));
+	}
+}
+
+// Send up to 16 command bytes as one command stream, from a local buffer so it can
+// run from another task (the effect timer) between the other writes.
+// Returns the bytes sent, control byte included, or 0 on error.
+int i2c_write_commands(SSD1306_t * dev, const uint8_t * commands, int len) {
+	uint8_t out_buf[17];
+	if (len > 16) len = 16;
+	out_buf[0] = OLED_CONTROL_BYTE_CMD_STREAM;
+	memcpy(&out_buf[1], commands, len);
+
+	esp_err_t res = i2c_master_transmit(dev->_i2c_dev_handle, out_buf, len + 1, I2C_TICKS_TO_WAIT);
+	if (res != ESP_OK) {
+		ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d (%s)", dev->_address, dev->_i2c_num, res, esp_err_to_name(res));
+		return 0;
+	}
+	return len + 1;
+}
+
+// Free the transfer buffer. Drawing sends nothing until the device is added again.
+void i2c_deinit(SSD1306_t * dev) {
+	free(dev->_i2c_buf);
+	dev->_i2c_buf = NULL;
 }
 
 void i2c_contrast(SSD1306_t * dev, int contrast) {
@@ -4,6 +4,7 @@
 #include "freertos/task.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 
 #include "ssd1306.h"
@@ -77,9 +78,14 @@ void spi_master_init(SSD1306_t * dev, int16_t mosi, int16_t sclk, int16_t cs, in
 	assert(ret==ESP_OK);
 
 	dev->_dc = dc;
+	ssd1306_reset_state(dev);
 	dev->_address = SPI_ADDRESS;
 	dev->_flip = false;
 	dev->_spi_device_handle = spi_device_handle;
+	dev->_spi_buf = heap_caps_malloc(SPI_BUF_SIZE, MALLOC_CAP_DMA);
+	if (dev->_spi_buf == NULL) {
+		ESP_LOGE(TAG, "heap_caps_malloc fail");
+	}
 }
 
 void spi_device_add(SSD1306_t * dev, int16_t cs, int16_t dc, int16_t reset)
@@ -133,24 +139,31 @@ void spi_device_add(SSD1306_t * dev, int16_t cs, int16_t dc, int16_t reset)
 	assert(ret==ESP_OK);
 
 	dev->_dc = dc;
+	ssd1306_reset_state(dev);
 	dev->_address = SPI_ADDRESS;
 	dev->_flip = false;
 	dev->_spi_device_handle = spi_device_handle;
+	dev->_spi_buf = heap_caps_malloc(SPI_BUF_SIZE, MALLOC_CAP_DMA);
+	if (dev->_spi_buf == NULL) {
+		ESP_LOGE(TAG, "heap_caps_malloc fail");
+	}
 }
 
 
 bool spi_master_write_byte(const spi_device_handle_t SPIHandle, const uint8_t* Data, size_t DataLength )
 {
 	spi_transaction_t SPITransaction;
+	esp_err_t ret = ESP_OK;
 
 	if ( DataLength > 0 ) {
 		memset( &SPITransaction, 0, sizeof( spi_transaction_t ) );
 		SPITransaction.length = DataLength * 8;
 		SPITransaction.tx_buffer = Data;
-		spi_device_transmit( SPIHandle, &SPITransaction );
+		ret = spi_device_transmit( SPIHandle, &SPITransaction );
+		if (ret != ESP_OK) ESP_LOGE(TAG, "spi_device_transmit=%d", ret);
 	}
 
-	return true;
+	return ret == ESP_OK;
 }
 
 bool spi_master_write_commands(SSD1306_t * dev, const uint8_t * Commands, size_t DataLength )
@@ -179,6 +192,7 @@ void spi_init(SSD1306_t * dev, int width, int height)
 	dev->_height = height;
 	dev->_pages = 8;
 	if (dev->_height == 32) dev->_pages = 4;
+	dev->_horizontal = false;
 
 	spi_master_write_command(dev, OLED_CMD_DISPLAY_OFF);			// AE
 	spi_master_write_command(dev, OLED_CMD_SET_MUX_RATIO);			// A8
@@ -219,10 +233,12 @@ void spi_init(SSD1306_t * dev, int width, int height)
 }
 
 
-void spi_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width)
+// Returns the bytes sent, or 0 on error.
+int spi_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * images, int width)
 {
-	if (page >= dev->_pages) return;
-	if (seg >= dev->_width) return;
+	if (page >= dev->_pages) return 0;
+	if (seg >= dev->_width) return 0;
+	int sent = 3 + width;
 
 	int _seg = seg + CONFIG_OFFSETX;
 	uint8_t columLow = _seg & 0x0F;
@@ -233,12 +249,88 @@ void spi_display_image(SSD1306_t * dev, int page, int seg, const uint8_t * image
 		_page = (dev->_pages - page) - 1;
 	}
 
+	if (dev->_horizontal) {
+		uint8_t mode[2] = { OLED_CMD_SET_MEMORY_ADDR_MODE, OLED_CMD_SET_PAGE_ADDR_MODE };
+		if (!spi_master_write_commands(dev, mode, 2)) return 0;
+		dev->_horizontal = false;
+		sent = sent + 2;
+	}
+
 	// Set Lower Column Start Address for Page Addressing Mode, Higher Column Start Address for Page Addressing Mode and Page Start Address for Page Addressing Mode
 	uint8_t commands[3] = { 0x00 + columLow, 0x10 + columHigh, 0xB0 | _page };
-	spi_master_write_commands(dev, commands, 3);
+	if (!spi_master_write_commands(dev, commands, 3)) return 0;
+
+	if (!spi_master_write_data(dev, images, width)) return 0;
+	return sent;
+}
+
+// Send all pages with horizontal addressing: one command transaction and one DMA data transaction.
+// Addressing mode is only switched when a page-mode write happened in between.
+// Returns the bytes sent, or 0 on error.
+int spi_display_frame(SSD1306_t * dev, const PAGE_t * pages)
+{
+	if (dev->_spi_buf == NULL) {
+		int sent = 0;
+		for (int page=0; page<dev->_pages; page++) {
+			int page_sent = spi_display_image(dev, page, 0, pages[page]._segs, dev->_width);
+			if (page_sent == 0) return 0;
+			sent = sent + page_sent;
+		}
+		return sent;
+	}
 
-	spi_master_write_data(dev, images, width);
+	uint8_t commands[8];
+	int index = 0;
+	if (!dev->_horizontal) {
+		commands[index++] = OLED_CMD_SET_MEMORY_ADDR_MODE;	// 20
+		commands[index++] = OLED_CMD_SET_HORI_ADDR_MODE;	// 00
+	}
+	commands[index++] = OLED_CMD_SET_COLUMN_RANGE;			// 21
+	commands[index++] = CONFIG_OFFSETX;
+	commands[index++] = CONFIG_OFFSETX + dev->_width - 1;
+	commands[index++] = OLED_CMD_SET_PAGE_RANGE;			// 22
+	commands[index++] = 0;
+	commands[index++] = dev->_pages - 1;
+	if (!spi_master_write_commands(dev, commands, index)) return 0;
+	dev->_horizontal = true;
+
+	int offset = 0;
+	for (int page=0; page<dev->_pages; page++) {
+		int _page = page;
+		if (dev->_flip) {
+			_page = (dev->_pages - page) - 1;
+		}
+		memcpy(&dev->_spi_buf[offset], pages[_page]._segs, dev->_width);
+		offset = offset + dev->_width;
+	}
+	if (!spi_master_write_data(dev, dev->_spi_buf, offset)) return 0;
+	return index + offset;
+}
+
+// Console scroll step: write a whole RAM page, with no flip mapping, then move the display start line.
+// The page goes first so it is written while it is still off screen (on 32-line panels).
+// A negative ram_page or start_line skips that part.
+void spi_console_page(SSD1306_t * dev, int ram_page, const uint8_t * images, int start_line)
+{
+	if (ram_page >= 0) {
+		if (dev->_horizontal) {
+			uint8_t mode[2] = { OLED_CMD_SET_MEMORY_ADDR_MODE, OLED_CMD_SET_PAGE_ADDR_MODE };
+			spi_master_write_commands(dev, mode, 2);
+			dev->_horizontal = false;
+		}
+		uint8_t commands[3] = { 0x00 + (CONFIG_OFFSETX & 0x0F), 0x10 + ((CONFIG_OFFSETX >> 4) & 0x0F), 0xB0 | ram_page };
+		spi_master_write_commands(dev, commands, 3);
+		spi_master_write_data(dev, images, dev->_width);
+	}
+	if (start_line >= 0) {
+		spi_master_write_command(dev, OLED_CMD_SET_DISPLAY_START_LINE | (start_line & 0x3F));
+	}
+}
 
+// Free the frame buffer. Frame pushes send nothing until the device is added again.
+void spi_deinit(SSD1306_t * dev) {
+	heap_caps_free(dev->_spi_buf);
+	dev->_spi_buf = NULL;
 }
 
 void spi_contrast(SSD1306_t * dev, int contrast) {
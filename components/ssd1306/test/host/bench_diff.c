@@ -0,0 +1,95 @@
+// Bytes on the wire for a text dashboard, updated once a second: a clock, two
+// sensor readings that change now and then and a progress bar, under static
+// labels. Full frames (ssd1306_show_buffer) against ssd1306_show_buffer_diff,
+// on I2C and SPI, as counted by the mock buses.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "font8x8_basic.h"
+#include "mock_idf.h"
+
+#define UPDATES 600
+
+// Draw text into the frame buffer only
+static void draw_text(SSD1306_t * dev, int page, int seg, const char * text)
+{
+	for (int i = 0; text[i] && seg + 8 <= dev->_width; i++, seg += 8) {
+		memcpy(&dev->_page[page]._segs[seg], font8x8_basic_tr[(uint8_t)text[i]], 8);
+	}
+}
+
+static void draw_update(SSD1306_t * dev, int t)
+{
+	char text[17];
+	draw_text(dev, 0, 0, "AIR MONITOR");
+	snprintf(text, sizeof(text), "%02d:%02d:%02d", 12 + t / 3600, (t / 60) % 60, t % 60);
+	draw_text(dev, 2, 32, text);
+	snprintf(text, sizeof(text), "T %2d.%dC", 21 + (t / 50) % 3, (t / 5) % 10);
+	draw_text(dev, 4, 0, text);
+	snprintf(text, sizeof(text), "PM %3dug", 12 + (t / 7) % 20);
+	draw_text(dev, 5, 0, text);
+	// One more column of the bar per update
+	memset(dev->_page[7]._segs, 0, 128);
+	memset(dev->_page[7]._segs, 0x3C, t % 128 + 1);
+}
+
+typedef struct {
+	int transactions;
+	int bytes;
+} wire_t;
+
+// Runs the workload and returns what went on the bus per update
+static wire_t run(SSD1306_t * dev, bool diff)
+{
+	mock_bus_t * bus = (dev->_address == SPI_ADDRESS) ? &mock_spi : &mock_i2c;
+	CHECK(ssd1306_init(dev, 128, 64));
+	draw_update(dev, 0);
+	ssd1306_show_buffer_diff(dev);
+	mock_bus_reset();
+	for (int t = 1; t <= UPDATES; t++) {
+		draw_update(dev, t);
+		if (diff) {
+			ssd1306_show_buffer_diff(dev);
+		} else {
+			ssd1306_show_buffer(dev);
+		}
+	}
+	CHECK(memcmp(dev->_shadow, dev->_page, sizeof(PAGE_t) * dev->_pages) == 0);
+	wire_t wire = { bus->transactions, bus->bytes };
+	ssd1306_deinit(dev);
+	return wire;
+}
+
+static void report(const char * name, wire_t full, wire_t diff, int per_transaction)
+{
+	double full_bytes = (double)(full.bytes + full.transactions * per_transaction) / UPDATES;
+	double diff_bytes = (double)(diff.bytes + diff.transactions * per_transaction) / UPDATES;
+	printf("  %s: full frame %.1f bytes in %.1f transactions, diff %.1f bytes in %.1f transactions (%.1fx less)\n",
+		name, full_bytes, (double)full.transactions / UPDATES,
+		diff_bytes, (double)diff.transactions / UPDATES, full_bytes / diff_bytes);
+	CHECK(diff_bytes * 4 < full_bytes);
+}
+
+int main(void)
+{
+	SSD1306_t dev = {0};
+
+	// I2C counts the address byte of every transaction too
+	i2c_master_init(&dev, 21, 22, -1);
+	wire_t full = run(&dev, false);
+	i2c_master_init(&dev, 21, 22, -1);
+	wire_t diff = run(&dev, true);
+	report("I2C", full, diff, 1);
+
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	full = run(&dev, false);
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	diff = run(&dev, true);
+	report("SPI", full, diff, 0);
+
+	if (mock_failures) return 1;
+	printf("bench_diff: ok\n");
+	return 0;
+}
@@ -0,0 +1,130 @@
+// Glyphs per second for scaled and rotated text. The output is first
+// checked against straightforward reference code: a bit-by-bit transpose
+// for ssd1306_rotate_image() and a pixel scaler for text_x2/x3/x4.
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "font8x8_basic.h"
+#include "mock_idf.h"
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Row i of the result holds bit i of every input byte, MSB from image[0]
+static void rotate_reference(uint8_t * image, bool flip)
+{
+	uint8_t out[8] = {0};
+	for (int i=0; i<8; i++) {
+		for (int j=0; j<8; j++) {
+			if (image[j] & (1 << i)) out[i] |= 0x80 >> j;
+		}
+		if (flip) out[i] = ssd1306_rotate_byte(out[i]);
+	}
+	memcpy(image, out, 8);
+}
+
+static void check_rotate(void)
+{
+	for (int i=0; i<256; i++) {
+		uint8_t want = 0;
+		for (int b=0; b<8; b++) {
+			if (i & (1 << b)) want |= 0x80 >> b;
+		}
+		CHECK_EQ(ssd1306_rotate_byte(i), want);
+	}
+
+	srand(7);
+	for (int i=0; i<20000; i++) {
+		uint8_t image[8], want[8];
+		for (int j=0; j<8; j++) {
+			image[j] = (i < 128) ? font8x8_basic_tr[i][j] : rand();
+		}
+		memcpy(want, image, 8);
+		rotate_reference(want, i & 1);
+		ssd1306_rotate_image(image, i & 1);
+		if (memcmp(image, want, 8)) {
+			fprintf(stderr, "rotate_image differs for image %d\n", i);
+			mock_failures++;
+			return;
+		}
+	}
+}
+
+static void check_scaled(SSD1306_t * dev)
+{
+	for (int scale=2; scale<=4; scale++) {
+		for (int c=32; c<127; c++) {
+			char text[8];
+			for (int k=0; k<8; k++) text[k] = 32 + (c + k * 11) % 95;
+			ssd1306_clear_screen(dev, false);
+			if (scale == 2) ssd1306_display_text_x2(dev, 1, text, 8, false);
+			if (scale == 3) ssd1306_display_text_x3(dev, 1, text, 8, false);
+			if (scale == 4) ssd1306_display_text_x4(dev, 1, text, 8, false);
+			int chars = 16 / scale;
+			for (int y=0; y<64; y++) {
+				for (int x=0; x<128; x++) {
+					int got = (dev->_page[y / 8]._segs[x] >> (y & 7)) & 1;
+					int want = 0, ly = y - 8;
+					if (ly >= 0 && ly < 8 * scale && x < chars * 8 * scale) {
+						uint8_t ch = text[x / (8 * scale)];
+						want = (font8x8_basic_tr[ch][(x % (8 * scale)) / scale] >> (ly / scale)) & 1;
+					}
+					if (got != want) {
+						fprintf(stderr, "x%d text differs at %d,%d\n", scale, x, y);
+						mock_failures++;
+						return;
+					}
+				}
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+
+	check_rotate();
+	check_scaled(&dev);
+
+	const int n = 200000;
+	mock_bus_reset();
+	double t0 = now();
+	for (int i=0; i<n; i++) ssd1306_display_text_x3(&dev, 0, "Hello", 5, i & 1);
+	double t1 = now();
+	printf("  x3 text: %.2f Mglyph/s, %.0f bus bytes per glyph\n",
+		5.0 * n / (t1 - t0) / 1e6, (double)mock_i2c.bytes / (5.0 * n));
+
+	mock_bus_reset();
+	t0 = now();
+	for (int i=0; i<n; i++) ssd1306_display_rotate_text(&dev, 40, "Hello", 5, i & 1);
+	t1 = now();
+	printf("  rotated text: %.2f Mglyph/s, %.0f bus bytes per glyph\n",
+		5.0 * n / (t1 - t0) / 1e6, (double)mock_i2c.bytes / (5.0 * n));
+
+	uint8_t image[8];
+	unsigned sum = 0;
+	memcpy(image, font8x8_basic_tr['A'], 8);
+	t0 = now();
+	for (int i=0; i<20 * n; i++) {
+		image[i & 7] ^= i;
+		ssd1306_rotate_image(image, i & 1);
+		sum += image[3];
+	}
+	t1 = now();
+	printf("  rotate_image: %.2f Mglyph/s (%u)\n", 20.0 * n / (t1 - t0) / 1e6, sum & 1);
+
+	ssd1306_deinit(&dev);
+	if (mock_failures) return 1;
+	printf("bench_text: ok\n");
+	return 0;
+}
@@ -0,0 +1,99 @@
+// RAM and frame time of the compile-time sized Ssd1306<128, 32> against the
+// C driver on a 128x32 panel. Both must draw the same frame, flipped or not.
+// ssd1306_init() allocates the same 4 pages the template holds, so against it
+// the template only saves the heap block; the saving against the 8 embedded
+// pages every SSD1306_t used to carry is reported separately.
+
+#include <string.h>
+#include <chrono>
+
+#include "ssd1306.hpp"
+#include "mock_idf.h"
+
+static volatile int sink;
+
+// ssd1306_clear_screen() also writes the panel, so clear only the pages
+static void clear_pages(SSD1306_t * dev)
+{
+	for (int page=0; page<dev->_pages; page++) memset(dev->_page[page]._segs, 0, dev->_width);
+}
+
+// Microseconds per call of frame(i)
+template <typename F>
+static double bench(F frame)
+{
+	const int n = 20000;
+	auto start = std::chrono::steady_clock::now();
+	for (int i=0; i<n; i++) frame(i);
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+}
+
+int main(void)
+{
+	Ssd1306<128, 32> oled;
+	i2c_master_init(oled, 21, 22, -1);
+	oled.init();
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 32));
+	CHECK_EQ(dev._pages, 4);
+
+	// Same pixels, same buffer, with and without _flip
+	for (int flip=0; flip<2; flip++) {
+		oled.dev()->_flip = flip;
+		dev._flip = flip;
+		oled.clear();
+		clear_pages(&dev);
+		for (int k=0; k<300; k++) {
+			oled.pixel((k * 7) & 127, (k * 5) & 31, k % 5 == 0);
+			_ssd1306_pixel(&dev, (k * 7) & 127, (k * 5) & 31, k % 5 == 0);
+		}
+		for (int page=0; page<4; page++) {
+			CHECK(memcmp(oled.segs(page), dev._page[page]._segs, 128) == 0);
+		}
+	}
+	oled.dev()->_flip = false;
+	dev._flip = false;
+
+	// A frame: clear, 300 pixels, send
+	mock_bus_reset();
+	double c_frame = bench([&](int f) {
+		clear_pages(&dev);
+		for (int k=0; k<300; k++) _ssd1306_pixel(&dev, (k * 7 + f) & 127, (k * 5) & 31, false);
+		ssd1306_show_buffer(&dev);
+	});
+	long c_bytes = mock_i2c.bytes;
+	mock_bus_reset();
+	double t_frame = bench([&](int f) {
+		oled.clear();
+		for (int k=0; k<300; k++) oled.pixel((k * 7 + f) & 127, (k * 5) & 31);
+		oled.show();
+	});
+	CHECK_EQ(mock_i2c.bytes, c_bytes);
+
+	// Drawing only
+	double c_draw = bench([&](int f) {
+		clear_pages(&dev);
+		for (int k=0; k<300; k++) _ssd1306_pixel(&dev, (k * 7 + f) & 127, (k * 5) & 31, false);
+		sink = dev._page[0]._segs[0];
+	});
+	double t_draw = bench([&](int f) {
+		oled.clear();
+		for (int k=0; k<300; k++) oled.pixel((k * 7 + f) & 127, (k * 5) & 31);
+		sink = oled.segs(0)[0];
+	});
+
+	// The pages live in the object, with nothing else added
+	CHECK_EQ(sizeof(oled), sizeof(SSD1306_t) + sizeof(PAGE_t) * 4);
+	printf("  RAM: Ssd1306<128, 32> %zu bytes; C driver %zu + %zu bytes in a heap block;"
+		" 8 embedded pages took %zu, %zu more than the template\n",
+		sizeof(oled), sizeof(dev), sizeof(PAGE_t) * dev._pages,
+		sizeof(PAGE_t) * 8, sizeof(PAGE_t) * (8 - 4));
+	printf("  frame (CPU only): C %.2f us, template %.2f us; draw only: C %.2f us, template %.2f us\n",
+		c_frame, t_frame, c_draw, t_draw);
+
+	ssd1306_deinit(&dev);
+	if (mock_failures) return 1;
+	printf("bench_wrapper: ok\n");
+	return 0;
+}
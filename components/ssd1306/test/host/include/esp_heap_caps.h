@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_DMA (1 << 3)
+void * heap_caps_malloc(size_t size, uint32_t caps);
+void heap_caps_free(void * ptr);
+
+#ifdef __cplusplus
+}
+#endif
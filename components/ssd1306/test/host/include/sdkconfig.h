@@ -0,0 +1,5 @@
+#pragma once
+// Host test configuration: I2C on port 0, SPI on SPI2, no column offset
+#define CONFIG_OFFSETX 0
+#define CONFIG_I2C_PORT_0 1
+#define CONFIG_SPI2_HOST 1
@@ -0,0 +1,302 @@
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "driver/i2c_master.h"
+#include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+#include "mock_idf.h"
+
+mock_bus_t mock_i2c;
+mock_bus_t mock_spi;
+int mock_failures;
+void (*mock_i2c_observer)(const uint8_t * data, int len);
+
+static esp_err_t mock_record(mock_bus_t * bus, const uint8_t * data, size_t len)
+{
+	if (bus->fail > 0) {
+		bus->fail--;
+		return ESP_FAIL;
+	}
+	bus->transactions++;
+	bus->bytes += len;
+	bus->last_len = len;
+	memcpy(bus->last, data, len < MOCK_LAST_MAX ? len : MOCK_LAST_MAX);
+	return ESP_OK;
+}
+
+void mock_bus_reset(void)
+{
+	memset(&mock_i2c, 0, sizeof(mock_i2c));
+	memset(&mock_spi, 0, sizeof(mock_spi));
+}
+
+const char * esp_err_to_name(esp_err_t code) { return code == ESP_OK ? "ESP_OK" : "ESP_FAIL"; }
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) { return ESP_OK; }
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode) { return ESP_OK; }
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) { return ESP_OK; }
+
+void * heap_caps_malloc(size_t size, uint32_t caps) { return malloc(size); }
+void heap_caps_free(void * ptr) { free(ptr); }
+
+// I2C
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t * bus_config, i2c_master_bus_handle_t * ret_bus_handle)
+{
+	*ret_bus_handle = (i2c_master_bus_handle_t)&mock_i2c;
+	return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t * dev_config, i2c_master_dev_handle_t * ret_handle)
+{
+	*ret_handle = (i2c_master_dev_handle_t)&mock_i2c;
+	return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t * write_buffer, size_t write_size, int xfer_timeout_ms)
+{
+	esp_err_t res = mock_record(&mock_i2c, write_buffer, write_size);
+	if (res == ESP_OK && mock_i2c_observer) mock_i2c_observer(write_buffer, write_size);
+	return res;
+}
+
+// SPI
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t * bus_config, int dma_chan) { return ESP_OK; }
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t * dev_config, spi_device_handle_t * handle)
+{
+	*handle = (spi_device_handle_t)&mock_spi;
+	return ESP_OK;
+}
+
+esp_err_t spi_device_transmit(spi_device_handle_t handle, spi_transaction_t * trans_desc)
+{
+	return mock_record(&mock_spi, trans_desc->tx_buffer, trans_desc->length / 8);
+}
+
+// FreeRTOS: single threaded. Tasks run from mock_task_run(), until they
+// wait for a notification that is not there and jump back out. The driver's
+// task loops keep nothing on the stack across that wait.
+
+#define MOCK_TASKS 4
+
+struct tskTaskControlBlock {
+	TaskFunction_t function;
+	void * arg;
+	bool used;
+	uint32_t notified;
+};
+
+static struct tskTaskControlBlock mock_tasks[MOCK_TASKS];
+static struct tskTaskControlBlock * mock_current;
+static jmp_buf mock_blocked;
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char * name, uint32_t stack_depth, void * arg, UBaseType_t priority, TaskHandle_t * created_task)
+{
+	for (int i = 0; i < MOCK_TASKS; i++) {
+		if (mock_tasks[i].used) continue;
+		mock_tasks[i] = (struct tskTaskControlBlock){ .function = task, .arg = arg, .used = true };
+		if (created_task) *created_task = &mock_tasks[i];
+		return pdPASS;
+	}
+	return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t task) { task->used = false; }
+void vTaskDelay(TickType_t ticks) {}
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) { return 1; }
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+	if (mock_current == NULL) return 1;
+	uint32_t notified = mock_current->notified;
+	if (notified == 0) longjmp(mock_blocked, 1);
+	mock_current->notified = clear_on_exit ? 0 : notified - 1;
+	return notified;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+	task->notified++;
+	return pdPASS;
+}
+
+int mock_task_run(void)
+{
+	int run = 0;
+	for (int i = 0; i < MOCK_TASKS; i++) {
+		struct tskTaskControlBlock * task = &mock_tasks[i];
+		if (!task->used || task->notified == 0) continue;
+		mock_current = task;
+		if (setjmp(mock_blocked) == 0) task->function(task->arg);
+		mock_current = NULL;
+		run++;
+		// A task may have notified one before it
+		i = -1;
+	}
+	return run;
+}
+
+int mock_task_count(void)
+{
+	int count = 0;
+	for (int i = 0; i < MOCK_TASKS; i++) count += mock_tasks[i].used;
+	return count;
+}
+
+// Event groups keep their bits. A wait that would block runs the tasks first.
+
+struct EventGroupDef_t {
+	EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void) { return calloc(1, sizeof(struct EventGroupDef_t)); }
+void vEventGroupDelete(EventGroupHandle_t event_group) { free(event_group); }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t event_group, EventBits_t bits)
+{
+	event_group->bits |= bits;
+	return event_group->bits;
+}
+
+static bool mock_bits_set(EventBits_t have, EventBits_t bits, BaseType_t wait_for_all)
+{
+	return wait_for_all ? (have & bits) == bits : (have & bits) != 0;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t event_group, EventBits_t bits, BaseType_t clear_on_exit, BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+	if (!mock_bits_set(event_group->bits, bits, wait_for_all) && ticks_to_wait != 0) mock_task_run();
+	EventBits_t have = event_group->bits;
+	if (!mock_bits_set(have, bits, wait_for_all)) {
+		if (ticks_to_wait == portMAX_DELAY) {
+			fprintf(stderr, "xEventGroupWaitBits: blocks forever\n");
+			mock_failures++;
+		}
+		return have;
+	}
+	if (clear_on_exit) event_group->bits &= ~bits;
+	return have;
+}
+
+// Semaphores count for real. A take that would block runs the started
+// timers first, standing in for the task that would give it meanwhile.
+
+struct QueueDefinition {
+	int count;
+};
+
+static SemaphoreHandle_t mock_semaphore(int count)
+{
+	SemaphoreHandle_t semaphore = malloc(sizeof(struct QueueDefinition));
+	if (semaphore) semaphore->count = count;
+	return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return mock_semaphore(1); }
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return mock_semaphore(0); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+	if (semaphore->count == 0 && ticks_to_wait != 0) mock_timer_fire();
+	if (semaphore->count == 0) {
+		if (ticks_to_wait == portMAX_DELAY) {
+			fprintf(stderr, "xSemaphoreTake: blocks forever\n");
+			mock_failures++;
+		}
+		return pdFALSE;
+	}
+	semaphore->count--;
+	return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+	if (semaphore->count) return pdFALSE;
+	semaphore->count = 1;
+	return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { free(semaphore); }
+
+// esp_timer: run by hand
+
+#define MOCK_TIMERS 4
+
+struct esp_timer {
+	esp_timer_create_args_t args;
+	bool used;
+	bool started;
+	bool once;
+};
+
+static struct esp_timer mock_timers[MOCK_TIMERS];
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t * create_args, esp_timer_handle_t * out_handle)
+{
+	for (int i = 0; i < MOCK_TIMERS; i++) {
+		if (mock_timers[i].used) continue;
+		mock_timers[i] = (struct esp_timer){ .args = *create_args, .used = true };
+		*out_handle = &mock_timers[i];
+		return ESP_OK;
+	}
+	return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+	timer->started = true;
+	timer->once = true;
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+	timer->started = true;
+	timer->once = false;
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+	timer->started = false;
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+	timer->used = false;
+	timer->started = false;
+	return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void) { return 0; }
+
+int mock_timer_fire(void)
+{
+	int run = 0;
+	for (int i = 0; i < MOCK_TIMERS; i++) {
+		struct esp_timer * timer = &mock_timers[i];
+		if (!timer->used || !timer->started) continue;
+		if (timer->once) timer->started = false;
+		timer->args.callback(timer->args.arg);
+		run++;
+	}
+	return run;
+}
+
+int mock_timer_count(void)
+{
+	int count = 0;
+	for (int i = 0; i < MOCK_TIMERS; i++) count += mock_timers[i].used;
+	return count;
+}
@@ -0,0 +1,63 @@
+#ifndef MOCK_IDF_H_
+#define MOCK_IDF_H_
+
+// Recording stand-ins for the ESP-IDF calls the driver makes. Each bus
+// counts transactions and bytes and keeps a copy of the last transaction.
+// Setting fail makes that many transactions return ESP_FAIL, unrecorded.
+// Tasks run when mock_task_run() is called, and an event group wait that
+// would block runs them instead. esp_timers are run by calling
+// mock_timer_fire(), and a semaphore take that would block runs them instead.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCK_LAST_MAX 2048
+
+typedef struct {
+	int fail; // Transactions still to fail, set by the test
+	int transactions;
+	int bytes;
+	int last_len;
+	uint8_t last[MOCK_LAST_MAX];
+} mock_bus_t;
+
+extern mock_bus_t mock_i2c;
+extern mock_bus_t mock_spi;
+extern int mock_failures;
+// Called with every transaction the I2C bus accepts, when set by a test
+extern void (*mock_i2c_observer)(const uint8_t * data, int len);
+
+void mock_bus_reset(void);
+// Run the callback of every started timer once. Returns the number run.
+int mock_timer_fire(void);
+// Timers created and not yet deleted
+int mock_timer_count(void);
+// Run every notified task until it waits again. Returns the number of runs.
+int mock_task_run(void);
+// Tasks created and not yet deleted
+int mock_task_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+		mock_failures++; \
+	} \
+} while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+	long a_ = (long)(actual), e_ = (long)(expected); \
+	if (a_ != e_) { \
+		fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__, #actual, a_, e_); \
+		mock_failures++; \
+	} \
+} while (0)
+
+#endif /* MOCK_IDF_H_ */
@@ -0,0 +1,81 @@
+// Asynchronous flush: one task per device, the callback, and the diff shadow.
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock_idf.h"
+
+static int flushed;
+
+static void on_flush(struct SSD1306_t * dev, void * arg)
+{
+	flushed += *(int *)arg;
+}
+
+static void test_init_twice(void)
+{
+	SSD1306_t dev = {0};
+	int one = 1, ten = 10;
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	CHECK(ssd1306_async_init(&dev, on_flush, &one));
+	TaskHandle_t task = dev._flush_task;
+	EventGroupHandle_t event = dev._flush_event;
+
+	// A second call keeps the task and only swaps the callback
+	CHECK(ssd1306_async_init(&dev, on_flush, &ten));
+	CHECK(dev._flush_task == task);
+	CHECK(dev._flush_event == event);
+	CHECK_EQ(mock_task_count(), 1);
+
+	flushed = 0;
+	mock_bus_reset();
+	ssd1306_show_buffer_async(&dev);
+	CHECK(ssd1306_wait_flush(&dev, portMAX_DELAY));
+	CHECK_EQ(flushed, 10);
+	CHECK_EQ(mock_i2c.transactions, 2);
+	CHECK_EQ(mock_i2c.last_len, 1 + 1024);
+
+	ssd1306_deinit(&dev);
+	CHECK_EQ(mock_task_count(), 0);
+}
+
+static void test_shadow(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 32));
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 4);
+	CHECK(ssd1306_async_init(&dev, NULL, NULL));
+
+	// What the flush sent is not sent again
+	memset(dev._page[1]._segs, 0x55, 128);
+	ssd1306_show_buffer_async(&dev);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 0);
+
+	// and what it replaced goes out again when drawn back
+	memset(dev._page[1]._segs, 0x00, 128);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128);
+
+	// A flush that failed leaves the panel unknown: the next diff sends everything
+	memset(dev._page[2]._segs, 0xAA, 128);
+	ssd1306_show_buffer_async(&dev);
+	mock_i2c.fail = 1;
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 4);
+	CHECK(memcmp(dev._shadow, dev._page, sizeof(PAGE_t) * 4) == 0);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 0);
+
+	ssd1306_deinit(&dev);
+}
+
+int main(void)
+{
+	test_init_twice();
+	test_shadow();
+	if (mock_failures) {
+		fprintf(stderr, "test_async: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_async: ok\n");
+	return 0;
+}
@@ -0,0 +1,241 @@
+// Console scrolling (ssd1306_console_*): what the panel shows, modelled from the
+// I2C bytes, and the bus cost of a new line, a redraw and the return to a normal layout.
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "font8x8_basic.h"
+#include "mock_idf.h"
+
+// Controller RAM and the addressing state the console relies on
+static struct {
+	uint8_t ram[8][128];
+	int start_line;
+	int mode; // 0 horizontal, 2 page
+	int col, page;
+	int col_start, col_end, page_start, page_end;
+	uint8_t cmd[8];
+	int cmd_len, cmd_args;
+} panel;
+
+static void panel_reset(void)
+{
+	memset(&panel, 0, sizeof(panel));
+	panel.mode = 2;
+	panel.col_end = 127;
+	panel.page_end = 7;
+}
+
+static int command_args(uint8_t command)
+{
+	switch (command) {
+	case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+	case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+		return 1;
+	case 0x21: case 0x22: case 0xA3:
+		return 2;
+	case 0x29: case 0x2A:
+		return 5;
+	case 0x26: case 0x27:
+		return 6;
+	}
+	return 0;
+}
+
+static void panel_command(uint8_t b)
+{
+	if (panel.cmd_len == 0) panel.cmd_args = command_args(b);
+	panel.cmd[panel.cmd_len++] = b;
+	if (panel.cmd_len <= panel.cmd_args) return;
+	panel.cmd_len = 0;
+
+	uint8_t c = panel.cmd[0];
+	if (c <= 0x0F) {
+		panel.col = (panel.col & 0xF0) | c;
+	} else if (c <= 0x1F) {
+		panel.col = (panel.col & 0x0F) | ((c & 0x0F) << 4);
+	} else if (c == 0x20) {
+		panel.mode = panel.cmd[1] & 3;
+	} else if (c == 0x21) {
+		panel.col = panel.col_start = panel.cmd[1] & 0x7F;
+		panel.col_end = panel.cmd[2] & 0x7F;
+	} else if (c == 0x22) {
+		panel.page = panel.page_start = panel.cmd[1] & 7;
+		panel.page_end = panel.cmd[2] & 7;
+	} else if (c >= 0x40 && c <= 0x7F) {
+		panel.start_line = c & 0x3F;
+	} else if (c >= 0xB0 && c <= 0xB7) {
+		panel.page = c & 7;
+	}
+}
+
+static void panel_data(uint8_t b)
+{
+	panel.ram[panel.page][panel.col] = b;
+	if (panel.mode == 2) {
+		panel.col = (panel.col + 1) & 0x7F;
+	} else if (++panel.col > panel.col_end) {
+		panel.col = panel.col_start;
+		if (++panel.page > panel.page_end) panel.page = panel.page_start;
+	}
+}
+
+// Control bytes: 0x80 one command, 0xC0 one data byte, 0x00 command stream, 0x40 data stream
+static void panel_receive(const uint8_t * data, int len)
+{
+	int i = 0;
+	while (i < len) {
+		uint8_t control = data[i++];
+		if (control & 0x80) {
+			if (i == len) break;
+			if (control & 0x40) panel_data(data[i++]);
+			else panel_command(data[i++]);
+			continue;
+		}
+		while (i < len) {
+			if (control & 0x40) panel_data(data[i++]);
+			else panel_command(data[i++]);
+		}
+	}
+	// A command never straddles two transactions
+	CHECK_EQ(panel.cmd_len, 0);
+	panel.cmd_len = 0;
+}
+
+// Text line 'page' as the panel shows it: row r is RAM row (start line + r) % 64
+static void panel_visible(int page, uint8_t * segs)
+{
+	for (int x = 0; x < 128; x++) {
+		segs[x] = 0;
+		for (int bit = 0; bit < 8; bit++) {
+			int row = (panel.start_line + page * 8 + bit) % 64;
+			if (panel.ram[row / 8][x] & (1 << (row % 8))) segs[x] |= 1 << bit;
+		}
+	}
+}
+
+// Lines printed so far, as the test expects them
+static char lines[64][17];
+static bool inverts[64];
+static int line_count;
+
+static void expect_line(const char * text, bool invert)
+{
+	strcpy(lines[line_count], text);
+	inverts[line_count] = invert;
+	line_count++;
+}
+
+static void render(int line, uint8_t * segs)
+{
+	memset(segs, 0, 128);
+	if (line < 0) return;
+	for (int i = 0; lines[line][i]; i++) {
+		memcpy(&segs[i * 8], font8x8_basic_tr[(uint8_t)lines[line][i]], 8);
+		if (inverts[line]) ssd1306_invert(&segs[i * 8], 8);
+	}
+}
+
+// The panel and _page[] show the newest lines, 'back' lines up
+static bool shows(SSD1306_t * dev, int back, const char * what)
+{
+	uint8_t expect[128], seen[128];
+	for (int page = 0; page < dev->_pages; page++) {
+		render(line_count - dev->_pages + page - back, expect);
+		panel_visible(page, seen);
+		if (memcmp(seen, expect, 128) != 0 || memcmp(dev->_page[page]._segs, expect, 128) != 0) {
+			fprintf(stderr, "%s, %d lines, back %d: text line %d differs\n", what, line_count, back, page);
+			mock_failures++;
+			return false;
+		}
+	}
+	return true;
+}
+
+static void test_scroll(int height)
+{
+	SSD1306_t dev = {0};
+	panel_reset();
+	line_count = 0;
+	mock_i2c_observer = panel_receive;
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, height));
+	memset(panel.ram, 0x5A, sizeof(panel.ram));
+	CHECK(ssd1306_console_init(&dev));
+	shows(&dev, 0, "init");
+
+	// One page write and one start line command per line, however long the backlog
+	char text[17];
+	for (int i = 0; i < 40; i++) {
+		snprintf(text, sizeof(text), "line %d", i);
+		mock_bus_reset();
+		ssd1306_console_print(&dev, text, strlen(text), i % 3 == 0);
+		expect_line(text, i % 3 == 0);
+		CHECK_EQ(mock_i2c.transactions, 2);
+		CHECK_EQ(mock_i2c.bytes, (7 + 128) + 2);
+		if (!shows(&dev, 0, "print")) break;
+	}
+
+	// Newlines split, long lines wrap at 16 columns
+	ssd1306_console_print(&dev, "a\n\nb", 4, false);
+	expect_line("a", false);
+	expect_line("", false);
+	expect_line("b", false);
+	shows(&dev, 0, "newlines");
+	ssd1306_console_print(&dev, "0123456789abcdefXYZ", 19, true);
+	expect_line("0123456789abcdef", true);
+	expect_line("XYZ", true);
+	shows(&dev, 0, "wrap");
+
+	// Scrolling back rewrites every line from the backlog, clamped to what it holds
+	mock_bus_reset();
+	ssd1306_console_redraw(&dev, 5);
+	CHECK_EQ(mock_i2c.transactions, dev._pages + 1);
+	CHECK_EQ(mock_i2c.bytes, dev._pages * (7 + 128) + 2);
+	shows(&dev, 5, "redraw 5");
+	ssd1306_console_redraw(&dev, 1000);
+	shows(&dev, CONSOLE_BACKLOG - dev._pages, "redraw 1000");
+
+	// The next line goes back to the live view
+	ssd1306_console_print(&dev, "live", 4, false);
+	expect_line("live", false);
+	shows(&dev, 0, "live");
+
+	// Stopping puts the start line back and leaves the same text on the panel
+	ssd1306_console_deinit(&dev);
+	CHECK_EQ(panel.start_line, 0);
+	shows(&dev, 0, "deinit");
+
+	mock_i2c_observer = NULL;
+	ssd1306_deinit(&dev);
+}
+
+// SPI: page addressing and window, the page, then the start line
+static void test_spi(void)
+{
+	SSD1306_t dev = {0};
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	CHECK(ssd1306_console_init(&dev));
+	for (int i = 0; i < 20; i++) {
+		mock_bus_reset();
+		ssd1306_console_print(&dev, "spi", 3, false);
+		CHECK_EQ(mock_spi.transactions, 3);
+		CHECK_EQ(mock_spi.bytes, 3 + 128 + 1);
+	}
+	ssd1306_console_deinit(&dev);
+	ssd1306_deinit(&dev);
+}
+
+int main(void)
+{
+	test_scroll(64);
+	test_scroll(32);
+	test_spi();
+	if (mock_failures) {
+		fprintf(stderr, "test_console: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_console: ok\n");
+	return 0;
+}
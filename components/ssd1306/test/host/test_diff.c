@@ -0,0 +1,187 @@
+// ssd1306_show_buffer_diff(): only changed columns go out, and the shadow follows
+// every other way the panel is written.
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock_idf.h"
+
+static void test_runs(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+
+	// The first call sends the whole frame
+	mock_bus_reset();
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 8);
+	CHECK_EQ(mock_i2c.transactions, 2);
+
+	// Nothing changed
+	mock_bus_reset();
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 0);
+	CHECK_EQ(mock_i2c.transactions, 0);
+
+	// Two runs closer than the merge gap go out as one window
+	dev._page[3]._segs[10] = 0xFF;
+	dev._page[3]._segs[14] = 0xFF;
+	// and a run far from them as another
+	dev._page[3]._segs[100] = 0x81;
+	mock_bus_reset();
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 5 + 1);
+	CHECK_EQ(mock_i2c.transactions, 2);
+	CHECK_EQ(mock_i2c.bytes, (4 + 6 + 1 + 5) + (6 + 1 + 1));
+	CHECK_EQ(mock_i2c.last[6 + 1], 0x81);
+	CHECK(memcmp(dev._shadow, dev._page, sizeof(PAGE_t) * 8) == 0);
+
+	// The frame buffer is unchanged by the send
+	CHECK_EQ(dev._page[3]._segs[10], 0xFF);
+	CHECK_EQ(dev._page[3]._segs[11], 0x00);
+
+	mock_bus_reset();
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 0);
+
+	ssd1306_deinit(&dev);
+}
+
+// Two changed bytes 'gap' apart: returns the data bytes sent
+static int diff_gap(SSD1306_t * dev, int gap)
+{
+	dev->_page[1]._segs[20] ^= 0xFF;
+	dev->_page[1]._segs[20 + gap + 1] ^= 0xFF;
+	return ssd1306_show_buffer_diff(dev);
+}
+
+// A gap is sent when it costs no more than opening a second window
+static void test_merge_gap(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	ssd1306_show_buffer_diff(&dev);
+	CHECK_EQ(diff_gap(&dev, I2C_WINDOW_COST), I2C_WINDOW_COST + 2);
+	mock_bus_reset();
+	CHECK_EQ(diff_gap(&dev, I2C_WINDOW_COST + 1), 2);
+	CHECK_EQ(mock_i2c.transactions, 2);
+	ssd1306_deinit(&dev);
+
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	ssd1306_show_buffer_diff(&dev);
+	CHECK_EQ(diff_gap(&dev, SPI_WINDOW_COST), SPI_WINDOW_COST + 2);
+	// Page addressing back, then per window: commands and data
+	mock_bus_reset();
+	CHECK_EQ(diff_gap(&dev, SPI_WINDOW_COST + 1), 2);
+	CHECK_EQ(mock_spi.transactions, 2 * 2);
+	CHECK_EQ(mock_spi.bytes, 2 * (SPI_WINDOW_COST + 1));
+	ssd1306_deinit(&dev);
+}
+
+// A width that is not a multiple of 4 never compares or sends past the last column
+static void test_tail(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 126, 32));
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 126 * 4);
+
+	dev._page[2]._segs[126] = 0xFF;
+	dev._page[2]._segs[127] = 0xFF;
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 0);
+
+	dev._page[2]._segs[125] = 0x18;
+	mock_bus_reset();
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 1);
+	// Page addressing back, the window and the one byte
+	CHECK_EQ(mock_i2c.last_len, 4 + 6 + 1 + 1);
+	CHECK_EQ(mock_i2c.last[11], 0x18);
+	ssd1306_deinit(&dev);
+}
+
+static bool shadow_matches(SSD1306_t * dev)
+{
+	return dev->_shadow != NULL && memcmp(dev->_shadow, dev->_page, sizeof(PAGE_t) * dev->_pages) == 0;
+}
+
+// Functions that write the panel directly keep the shadow, or drop it so the next diff sends everything
+static void test_other_writes(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	ssd1306_show_buffer_diff(&dev);
+
+	ssd1306_display_text(&dev, 0, "Hello", 5, false);
+	CHECK(shadow_matches(&dev));
+
+	ssd1306_software_scroll(&dev, 1, 6);
+	ssd1306_scroll_text(&dev, "line", 4, false);
+	CHECK(shadow_matches(&dev));
+
+	ssd1306_wrap_arround(&dev, SCROLL_RIGHT, 0, 7, 0);
+	CHECK(shadow_matches(&dev));
+
+	// Drawing the old contents back must reach the panel again
+	uint8_t before[128];
+	memcpy(before, dev._page[0]._segs, 128);
+	ssd1306_fadeout(&dev);
+	CHECK(shadow_matches(&dev));
+	memcpy(dev._page[0]._segs, before, 128);
+	CHECK(ssd1306_show_buffer_diff(&dev) > 0);
+	CHECK(shadow_matches(&dev));
+
+	ssd1306_hardware_scroll(&dev, SCROLL_RIGHT);
+	ssd1306_hardware_scroll(&dev, SCROLL_STOP);
+	CHECK(dev._shadow == NULL);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 8);
+
+	CHECK(ssd1306_console_init(&dev));
+	ssd1306_console_print(&dev, "boot\nok", 7, false);
+	ssd1306_console_deinit(&dev);
+	CHECK(dev._shadow == NULL);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 8);
+
+	// A failed write leaves the panel unknown
+	mock_i2c.fail = 1;
+	ssd1306_display_text(&dev, 2, "lost", 4, false);
+	CHECK(dev._shadow == NULL);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 8);
+
+	ssd1306_deinit(&dev);
+}
+
+// Pages the display manager sends are recorded too
+static void test_manager(void)
+{
+	SSD1306_t dev = {0};
+	MANAGER_t mgr;
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 32));
+	ssd1306_show_buffer_diff(&dev);
+	CHECK(ssd1306_manager_init(&mgr));
+	CHECK_EQ(ssd1306_manager_add(&mgr, &dev), 0);
+
+	memset(dev._page[2]._segs, 0x3C, 40);
+	ssd1306_manager_commit(&mgr, 0);
+	mock_task_run();
+	CHECK(shadow_matches(&dev));
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 0);
+
+	ssd1306_manager_deinit(&mgr);
+	ssd1306_deinit(&dev);
+}
+
+int main(void)
+{
+	test_runs();
+	test_merge_gap();
+	test_tail();
+	test_other_writes();
+	test_manager();
+	if (mock_failures) {
+		fprintf(stderr, "test_diff: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_diff: ok\n");
+	return 0;
+}
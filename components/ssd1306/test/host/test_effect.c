@@ -0,0 +1,85 @@
+// Effect engine: bus traffic per step, and stop/deinit against the timer task.
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock_idf.h"
+
+static void test_fade(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+
+	// Contrast 0 and display on, then one contrast command per step
+	mock_bus_reset();
+	CHECK(ssd1306_effect_start(&dev, EFFECT_FADE_IN, 200, 100));
+	CHECK_EQ(mock_i2c.transactions, 1);
+	CHECK_EQ(mock_i2c.bytes, 1 + 3);
+	for (int step = 0; step < 5; step++) CHECK_EQ(mock_timer_fire(), 1);
+	CHECK_EQ(mock_i2c.transactions, 1 + 5);
+	CHECK_EQ(mock_i2c.last[1], OLED_CMD_SET_CONTRAST);
+	CHECK_EQ(mock_i2c.last[2], 200);
+	CHECK(!ssd1306_effect_running(&dev));
+	CHECK_EQ(ssd1306_effect_bytes(&dev), 4 + 5 * 3);
+	CHECK_EQ(mock_timer_fire(), 0);
+
+	// Stop puts the panel back on at the level and the timer stays stopped
+	CHECK(ssd1306_effect_start(&dev, EFFECT_BREATHE, 100, 100));
+	CHECK_EQ(mock_timer_fire(), 1);
+	CHECK(ssd1306_effect_running(&dev));
+	mock_bus_reset();
+	ssd1306_effect_stop(&dev);
+	CHECK_EQ(mock_i2c.transactions, 1);
+	CHECK_EQ(mock_i2c.last[mock_i2c.last_len - 1], OLED_CMD_DISPLAY_ON);
+	CHECK(!ssd1306_effect_running(&dev));
+	CHECK_EQ(mock_timer_fire(), 0);
+
+	// Deinit waits for the timer task, then frees both timers
+	CHECK(ssd1306_effect_start(&dev, EFFECT_BLINK, 100, 100));
+	ssd1306_effect_deinit(&dev);
+	CHECK(dev._effect == NULL);
+	CHECK_EQ(mock_timer_count(), 0);
+
+	ssd1306_deinit(&dev);
+}
+
+static void test_wipe(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 32));
+	memset(dev._page[1]._segs, 0x81, 128);
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 4);
+
+	// Eight full frames, shifted from a copy: the frame buffer is left alone
+	mock_bus_reset();
+	CHECK(ssd1306_effect_start(&dev, EFFECT_WIPE, 0xFF, 80));
+	CHECK(dev._shadow == NULL);
+	CHECK_EQ(mock_timer_fire(), 1);
+	CHECK_EQ(mock_i2c.last_len, 1 + 512);
+	CHECK_EQ(mock_i2c.last[1 + 128], 0x02);
+	for (int step = 1; step < 8; step++) CHECK_EQ(mock_timer_fire(), 1);
+	CHECK(!ssd1306_effect_running(&dev));
+	CHECK_EQ(mock_i2c.transactions, 8 * 2);
+	CHECK_EQ(mock_i2c.last[1 + 128], 0x00);
+	CHECK_EQ(dev._page[1]._segs[0], 0x81);
+
+	// The panel is blank now, so the next diff sends everything again
+	CHECK_EQ(ssd1306_show_buffer_diff(&dev), 128 * 4);
+
+	ssd1306_deinit(&dev);
+	CHECK_EQ(mock_timer_count(), 0);
+}
+
+int main(void)
+{
+	test_fade();
+	test_wipe();
+	if (mock_failures) {
+		fprintf(stderr, "test_effect: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_effect: ok\n");
+	return 0;
+}
@@ -0,0 +1,151 @@
+// Transactions and bytes sent by the i2c_master backend (ssd1306_i2c_new.c).
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock_idf.h"
+
+static void test_display_image(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+
+	// Three addressing commands, each with its control byte, then the data stream
+	uint8_t image[128];
+	memset(image, 0xA5, sizeof(image));
+	mock_bus_reset();
+	ssd1306_display_image(&dev, 2, 0, image, 128);
+	CHECK_EQ(mock_i2c.transactions, 1);
+	CHECK_EQ(mock_i2c.bytes, 6 + 1 + 128);
+	CHECK_EQ(mock_i2c.last[5], 0xB2);
+	CHECK_EQ(mock_i2c.last[6], OLED_CONTROL_BYTE_DATA_STREAM);
+	CHECK(memcmp(&mock_i2c.last[7], image, 128) == 0);
+
+	// The backend reports what went on the bus, for the display manager
+	mock_bus_reset();
+	int sent = i2c_display_image(&dev, 1, 0, image, 128);
+	CHECK_EQ(sent, mock_i2c.bytes);
+
+	// One write per text character
+	mock_bus_reset();
+	ssd1306_display_text(&dev, 0, "Hi", 2, false);
+	CHECK_EQ(mock_i2c.transactions, 2);
+	CHECK_EQ(mock_i2c.bytes, 2 * (6 + 1 + 8));
+
+	// One write per page and line, where it used to be one per segment
+	mock_bus_reset();
+	ssd1306_fadeout(&dev);
+	CHECK_EQ(mock_i2c.transactions, 8 * 8);
+	CHECK_EQ(mock_i2c.bytes, 8 * 8 * (6 + 1 + 128));
+
+	ssd1306_deinit(&dev);
+}
+
+static void test_display_frame(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	for (int page = 0; page < 8; page++) memset(dev._page[page]._segs, page, 128);
+
+	// Switch to horizontal addressing, set the window, then the whole frame in one burst
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_i2c.transactions, 2);
+	CHECK_EQ(mock_i2c.bytes, (1 + 2 + 3 + 3) + (1 + 1024));
+	CHECK_EQ(mock_i2c.last_len, 1025);
+	CHECK_EQ(mock_i2c.last[0], OLED_CONTROL_BYTE_DATA_STREAM);
+	CHECK_EQ(mock_i2c.last[1 + 128 * 7], 7);
+
+	// Already horizontal: only the window
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_i2c.bytes, (1 + 3 + 3) + (1 + 1024));
+
+	// The next page write puts page addressing back, in the same transaction
+	uint8_t image[8] = {0};
+	mock_bus_reset();
+	ssd1306_display_image(&dev, 0, 0, image, 8);
+	CHECK_EQ(mock_i2c.transactions, 1);
+	CHECK_EQ(mock_i2c.bytes, 4 + 6 + 1 + 8);
+
+	ssd1306_deinit(&dev);
+
+	// 32-line panels send half the data
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 32));
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_i2c.transactions, 2);
+	CHECK_EQ(mock_i2c.last_len, 1 + 512);
+	ssd1306_deinit(&dev);
+}
+
+static void test_no_buffer(void)
+{
+	SSD1306_t dev = {0};
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+
+	// Without a transfer buffer, page and frame writes send nothing
+	i2c_deinit(&dev);
+	CHECK(dev._i2c_buf == NULL);
+	uint8_t image[128] = {0};
+	mock_bus_reset();
+	ssd1306_display_image(&dev, 0, 0, image, 128);
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(i2c_display_frame(&dev, dev._page), 0);
+	i2c_console_page(&dev, 0, image, -1);
+	CHECK_EQ(mock_i2c.transactions, 0);
+
+	// Commands use their own buffer
+	i2c_contrast(&dev, 0x80);
+	CHECK_EQ(mock_i2c.transactions, 1);
+
+	ssd1306_deinit(&dev);
+}
+
+// ssd1306_init() again, after a panel reset: nothing leaks and the page buffer is kept
+static void test_init_again(void)
+{
+	SSD1306_t dev;
+	// The transport starts the device from whatever the struct holds
+	memset(&dev, 0xA5, sizeof(dev));
+	i2c_master_init(&dev, 21, 22, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	PAGE_t * page = dev._page;
+	ssd1306_show_buffer_diff(&dev);
+	CHECK(ssd1306_console_init(&dev));
+	CHECK(ssd1306_async_init(&dev, NULL, NULL));
+
+	CHECK(ssd1306_init(&dev, 128, 64));
+	CHECK(dev._page == page);
+	CHECK(dev._shadow == NULL);
+	CHECK(dev._console == NULL);
+	CHECK(dev._flush_task == NULL);
+	CHECK_EQ(mock_task_count(), 0);
+
+	// A new page count gets a new buffer, a caller-owned one replaces it
+	CHECK(ssd1306_init(&dev, 128, 32));
+	CHECK_EQ(dev._pages, 4);
+	PAGE_t pages[4];
+	ssd1306_init_pages(&dev, 128, 32, pages);
+	CHECK(dev._page == pages);
+	CHECK(!dev._own_page);
+	ssd1306_deinit(&dev);
+}
+
+int main(void)
+{
+	test_display_image();
+	test_display_frame();
+	test_no_buffer();
+	test_init_again();
+	if (mock_failures) {
+		fprintf(stderr, "test_i2c: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_i2c: ok\n");
+	return 0;
+}
@@ -0,0 +1,102 @@
+// Display manager: bytes and failed writes in the per-panel stats.
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock_idf.h"
+
+static void test_spi_status(void)
+{
+	SSD1306_t dev = {0};
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	uint8_t image[128] = {0};
+
+	// Commands, then data: either failing fails the page
+	mock_bus_reset();
+	CHECK_EQ(spi_display_image(&dev, 0, 0, image, 128), 3 + 128);
+	mock_spi.fail = 1;
+	CHECK_EQ(spi_display_image(&dev, 0, 0, image, 128), 0);
+	mock_spi.transactions = 0;
+	mock_spi.bytes = 0;
+	CHECK_EQ(spi_display_image(&dev, 0, 0, image, 128), 3 + 128);
+	CHECK_EQ(mock_spi.transactions, 2);
+	CHECK_EQ(spi_display_frame(&dev, dev._page), 8 + 1024);
+	mock_spi.fail = 2;
+	CHECK_EQ(spi_display_frame(&dev, dev._page), 0);
+	ssd1306_deinit(&dev);
+}
+
+static void test_stats(void)
+{
+	SSD1306_t spi = {0}, i2c = {0};
+	MANAGER_t mgr;
+	ssd1306_manager_stats_t stats;
+	spi_master_init(&spi, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&spi, 128, 32));
+	i2c_master_init(&i2c, 21, 22, -1);
+	CHECK(ssd1306_init(&i2c, 128, 32));
+	CHECK(ssd1306_manager_init(&mgr));
+	CHECK_EQ(ssd1306_manager_add(&mgr, &spi), 0);
+	CHECK_EQ(ssd1306_manager_add(&mgr, &i2c), 1);
+
+	// First frames: every page of both panels, as counted on the buses
+	mock_bus_reset();
+	mock_task_run();
+	ssd1306_manager_stats(&mgr, 0, &stats);
+	CHECK_EQ(stats.frames, 1);
+	CHECK_EQ(stats.errors, 0);
+	CHECK_EQ(stats.bytes, mock_spi.bytes);
+	CHECK_EQ(stats.bytes, 4 * (3 + 128));
+	ssd1306_manager_stats(&mgr, 1, &stats);
+	CHECK_EQ(stats.bytes, mock_i2c.bytes);
+	CHECK_EQ(stats.bytes, 4 * (7 + 128));
+
+	// A failed page write is counted, sent again and only then completes the frame
+	memset(spi._page[1]._segs, 0xF0, 128);
+	ssd1306_manager_commit(&mgr, 0);
+	mock_bus_reset();
+	mock_spi.fail = 1;
+	mock_task_run();
+	ssd1306_manager_stats(&mgr, 0, &stats);
+	CHECK_EQ(stats.commits, 1);
+	CHECK_EQ(stats.errors, 1);
+	CHECK_EQ(stats.frames, 1);
+	CHECK_EQ(stats.bytes, 3 + 128);
+	CHECK_EQ(mock_spi.last_len, 128);
+	CHECK_EQ(mock_spi.last[0], 0xF0);
+
+	// Same on I2C, where page writes are one transaction
+	memset(i2c._page[3]._segs, 0x0F, 128);
+	ssd1306_manager_commit(&mgr, 1);
+	mock_bus_reset();
+	mock_i2c.fail = 2;
+	mock_task_run();
+	ssd1306_manager_stats(&mgr, 1, &stats);
+	CHECK_EQ(stats.errors, 2);
+	CHECK_EQ(stats.frames, 1);
+	CHECK_EQ(stats.bytes, 7 + 128);
+	CHECK_EQ(mock_i2c.transactions, 1);
+
+	// The counters start again
+	ssd1306_manager_stats(&mgr, 1, &stats);
+	CHECK_EQ(stats.errors, 0);
+	CHECK_EQ(stats.bytes, 0);
+
+	ssd1306_manager_deinit(&mgr);
+	CHECK_EQ(mock_task_count(), 0);
+	ssd1306_deinit(&spi);
+	ssd1306_deinit(&i2c);
+}
+
+int main(void)
+{
+	test_spi_status();
+	test_stats();
+	if (mock_failures) {
+		fprintf(stderr, "test_manager: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_manager: ok\n");
+	return 0;
+}
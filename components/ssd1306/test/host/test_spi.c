@@ -0,0 +1,96 @@
+// Transactions and bytes sent by the SPI backend for whole frames (ssd1306_spi.c).
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock_idf.h"
+
+static void test_display_frame(void)
+{
+	SSD1306_t dev = {0};
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+	CHECK(dev._spi_buf != NULL);
+	for (int page = 0; page < 8; page++) memset(dev._page[page]._segs, page, 128);
+
+	// Horizontal addressing and the window in one command transaction, then the frame
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_spi.transactions, 2);
+	CHECK_EQ(mock_spi.bytes, (2 + 3 + 3) + 1024);
+	CHECK_EQ(mock_spi.last_len, 1024);
+	for (int page = 0; page < 8; page++) CHECK_EQ(mock_spi.last[128 * page], page);
+
+	// At the default 1 MHz clock a frame fits in 10 ms of bus time: over 100 fps
+	CHECK(mock_spi.bytes * 8 < 1000000 / 100);
+
+	// Already horizontal: only the window
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_spi.transactions, 2);
+	CHECK_EQ(mock_spi.bytes, (3 + 3) + 1024);
+
+	// A page write puts page addressing back, and the next frame switches again
+	uint8_t image[8] = {0};
+	mock_bus_reset();
+	ssd1306_display_image(&dev, 0, 0, image, 8);
+	CHECK_EQ(mock_spi.bytes, 2 + 3 + 8);
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_spi.bytes, (2 + 3 + 3) + 1024);
+
+	// Flipped panels send the pages in reverse
+	dev._flip = true;
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_spi.last[0], 7);
+	CHECK_EQ(mock_spi.last[128 * 7], 0);
+	dev._flip = false;
+
+	// Without the DMA buffer the frame goes page by page: back to page
+	// addressing, then commands and data for each page
+	spi_deinit(&dev);
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_spi.transactions, 1 + 8 * 2);
+	CHECK_EQ(mock_spi.bytes, 2 + 8 * (3 + 128));
+	ssd1306_deinit(&dev);
+
+	// 32-line panels send half the data
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&dev, 128, 32));
+	mock_bus_reset();
+	ssd1306_show_buffer(&dev);
+	CHECK_EQ(mock_spi.transactions, 2);
+	CHECK_EQ(mock_spi.last_len, 512);
+	ssd1306_deinit(&dev);
+}
+
+// A failed transaction sends nothing more and fails the frame
+static void test_failure(void)
+{
+	SSD1306_t dev = {0};
+	spi_master_init(&dev, 23, 18, 5, 4, -1);
+	CHECK(ssd1306_init(&dev, 128, 64));
+
+	mock_bus_reset();
+	mock_spi.fail = 1;
+	CHECK_EQ(spi_display_frame(&dev, dev._page), 0);
+	CHECK_EQ(mock_spi.transactions, 0);
+	CHECK(!dev._horizontal);
+	mock_spi.fail = 0;
+	CHECK_EQ(spi_display_frame(&dev, dev._page), (2 + 3 + 3) + 1024);
+	ssd1306_deinit(&dev);
+}
+
+int main(void)
+{
+	test_display_frame();
+	test_failure();
+	if (mock_failures) {
+		fprintf(stderr, "test_spi: %d failed\n", mock_failures);
+		return 1;
+	}
+	printf("test_spi: ok\n");
+	return 0;
+}